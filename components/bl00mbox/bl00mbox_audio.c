@@ -1,5 +1,26 @@
 //SPDX-License-Identifier: CC0-1.0
 #include "bl00mbox_audio.h"
+#include "bl00mbox.h"
+
+#ifdef BL00MBOX_PROFILING_ENABLE
+#ifdef BL00MBOX_HOST
+#include <time.h>
+#else
+#include "esp_cpu.h"
+#include "esp_rom_sys.h"
+#endif
+#endif
+
+#if defined(BL00MBOX_MULTICORE_ENABLE) || defined(BL00MBOX_BOUNCE_ENABLE)
+#ifdef BL00MBOX_HOST
+#include <pthread.h>
+#include <semaphore.h>
+#else
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#endif
+#endif
 
 static bool is_initialized = false;
 static bool bl00mbox_audio_run = true;
@@ -19,11 +40,29 @@ static int8_t last_chan_event = 0;
 static uint8_t bl00mbox_channel_foreground = 0;
 // channels may request being active while not being in foreground
 static bool bl00mbox_channel_background_mute_override[BL00MBOX_CHANNELS] = {false,};
+// bitmap of channels that have background mute override set and are enabled, so that the audio
+// task only needs to look at channels that are actually going to produce sound
+#define BL00MBOX_CHANNEL_SET_WORDS ((BL00MBOX_CHANNELS + 31) / 32)
+static uint32_t bl00mbox_channel_background_set[BL00MBOX_CHANNEL_SET_WORDS] = {0,};
+
+static void bl00mbox_channel_background_set_update(uint8_t channel_index){
+    bool active = bl00mbox_channel_background_mute_override[channel_index] && channels[channel_index].is_active;
+    // channel 0 is always rendered anyways
+    if(!channel_index) active = false;
+    uint32_t * word = &(bl00mbox_channel_background_set[channel_index / 32]);
+    uint32_t mask = 1UL << (channel_index % 32);
+    if(active){
+        __atomic_fetch_or(word, mask, __ATOMIC_RELAXED);
+    } else {
+        __atomic_fetch_and(word, ~mask, __ATOMIC_RELAXED);
+    }
+}
 
 bool bl00mbox_channel_set_background_mute_override(uint8_t channel_index, bool enable){
 #ifdef BL00MBOX_BACKGROUND_MUTE_OVERRIDE_ENABLE
     if(channel_index >= BL00MBOX_CHANNELS) return false;
     bl00mbox_channel_background_mute_override[channel_index] = enable;
+    bl00mbox_channel_background_set_update(channel_index);
     return true;
 #else
     return false;
@@ -35,39 +74,262 @@ bool bl00mbox_channel_get_background_mute_override(uint8_t channel_index){
     return bl00mbox_channel_background_mute_override[channel_index];
 }
 
-static void ** ptr_to_be_set_by_audio_task = NULL;
-static void * ptr_to_be_set_by_audio_task_target = NULL;
-// TODO: multicore thread safety on this boi
-static volatile bool ptr_set_request_pending = false;
+// graph edits are handed over to the audio task through a single producer/single consumer
+// ring: the user side (micropython) pushes commands, the audio task applies all pending pointer
+// changes in one go at the start of each block. memory that the audio task might still be
+// looking at is pushed as a free command and reclaimed by the user side once the audio task has
+// moved past it, so nothing is ever freed while a block that could reference it is in flight.
+#define BL00MBOX_AUDIO_QUEUE_LEN 256 // must be power of 2
+
+typedef enum {
+    BL00MBOX_AUDIO_CMD_POINTER_CHANGE,
+    BL00MBOX_AUDIO_CMD_FREE,
+    BL00MBOX_AUDIO_CMD_PLUGIN_DESTROY,
+    BL00MBOX_AUDIO_CMD_EVENT,
+} bl00mbox_audio_cmd_type_t;
+
+typedef struct {
+    bl00mbox_audio_cmd_type_t type;
+    union {
+        struct {
+            void ** ptr;
+            void * val;
+        };
+        bl00mbox_audio_event_t event;
+    };
+} bl00mbox_audio_cmd_t;
+
+static bl00mbox_audio_cmd_t queue[BL00MBOX_AUDIO_QUEUE_LEN];
+static uint32_t queue_write = 0; // written by user side only
+static uint32_t queue_read = 0; // written by audio task only
+static uint32_t queue_reclaim = 0; // user side only, everything before this is done with
 static uint64_t bl00mbox_audio_waitfor_timeout = 0ULL;
 
-bool bl00mbox_audio_waitfor_pointer_change(void ** ptr, void * new_val){
-    /// takes pointer to pointer that is to be set null
-    if(!is_initialized) return false;
-    ptr_to_be_set_by_audio_task = ptr;
-    ptr_to_be_set_by_audio_task_target = new_val;
-    ptr_set_request_pending = true;
+// timestamped signal changes. they travel through the command queue so that they can't overtake
+// the destruction of their plugin, the audio task then keeps them sorted by time until they're
+// due. a change that falls inside a block on an unconnected input goes to an event buffer that
+// holds the old value up to the event and the new one after it. the input points to that buffer
+// while the block is rendered so that the plugin sees the change at the exact sample.
+#define BL00MBOX_AUDIO_EVENTS_MAX 256
+#define BL00MBOX_AUDIO_EVENT_BUFFERS 16
 
+static bl00mbox_audio_event_t events[BL00MBOX_AUDIO_EVENTS_MAX]; // audio task only, sorted by time
+static uint16_t events_num = 0;
+static uint32_t events_queued = 0; // user side only
+static uint32_t events_done = 0; // written by audio task only, applied or dropped
+static int16_t event_buffers[BL00MBOX_AUDIO_EVENT_BUFFERS][BL00MBOX_MAX_BUFFER_LEN];
+static radspa_signal_t * event_buffer_sigs[BL00MBOX_AUDIO_EVENT_BUFFERS];
+static uint8_t event_buffers_num = 0; // in use during the current block
+static uint32_t audio_clock = 0; // written by audio task only
+static uint32_t events_missed = 0; // written by audio task only, see bl00mbox_audio_get_events_missed
+// channel that is being bounced, set through the queue. the bounce task renders it without any
+// synchronization, so its events wait until it is handed back. audio task only.
+static bl00mbox_channel_t * events_hold_chan = NULL;
+
+static void bl00mbox_audio_event_insert(bl00mbox_audio_event_t * event){
+    /// events with the same time stay in the order they were queued in. the user side makes
+    /// sure that there's room.
+    uint16_t i = events_num;
+    while(i && ((int32_t) (events[i-1].time - event->time) > 0)){
+        events[i] = events[i-1];
+        i--;
+    }
+    events[i] = (* event);
+    events_num++;
+}
+
+static void bl00mbox_audio_events_drop(radspa_t * plugin){
+    /// the plugin is about to be destroyed, forget about its pending events
+    uint16_t num = 0;
+    for(uint16_t i = 0; i < events_num; i++){
+        if(events[i].plugin != plugin) events[num++] = events[i];
+    }
+    __atomic_store_n(&events_done, events_done + events_num - num, __ATOMIC_RELEASE);
+    events_num = num;
+}
+
+static void bl00mbox_audio_queue_process(){
+    /// audio task side: applies all pointer changes that were pushed so far
+    uint32_t write = __atomic_load_n(&queue_write, __ATOMIC_ACQUIRE);
+    uint32_t read = queue_read;
+    while(read != write){
+        bl00mbox_audio_cmd_t * cmd = &(queue[read & (BL00MBOX_AUDIO_QUEUE_LEN - 1)]);
+        switch(cmd->type){
+            case BL00MBOX_AUDIO_CMD_POINTER_CHANGE:
+                (* cmd->ptr) = cmd->val;
+                break;
+            case BL00MBOX_AUDIO_CMD_PLUGIN_DESTROY:
+                bl00mbox_audio_events_drop(cmd->val);
+                break;
+            case BL00MBOX_AUDIO_CMD_EVENT:
+                bl00mbox_audio_event_insert(&(cmd->event));
+                break;
+            default:
+                break;
+        }
+        read++;
+    }
+    __atomic_store_n(&queue_read, read, __ATOMIC_RELEASE);
+}
+
+static void bl00mbox_audio_queue_reclaim(){
+    /// user side: frees everything the audio task has moved past
+    uint32_t read = __atomic_load_n(&queue_read, __ATOMIC_ACQUIRE);
+    while(queue_reclaim != read){
+        bl00mbox_audio_cmd_t * cmd = &(queue[queue_reclaim & (BL00MBOX_AUDIO_QUEUE_LEN - 1)]);
+        if(cmd->type == BL00MBOX_AUDIO_CMD_FREE){
+            free(cmd->val);
+        } else if(cmd->type == BL00MBOX_AUDIO_CMD_PLUGIN_DESTROY){
+            radspa_t * plugin = cmd->val;
+            plugin->descriptor->destroy_plugin_instance(plugin);
+        }
+        queue_reclaim++;
+    }
+}
+
+bool bl00mbox_audio_queue_flush(){
+    /// waits until the audio task has applied all pending commands and reclaims their memory.
+    /// normally not needed, pushing commands never waits unless the queue is full.
+    if(!is_initialized) return false;
+#ifdef BL00MBOX_HOST
+    // host builds render from the same thread that edits the graph,
+    // there is no audio task to wait for
+    bl00mbox_audio_queue_process();
+#endif
     volatile uint64_t timeout = 0; // cute
-    while(ptr_set_request_pending){
+    while(__atomic_load_n(&queue_read, __ATOMIC_ACQUIRE) != queue_write){
         timeout++;
         // TODO: nop
-        if(bl00mbox_audio_waitfor_timeout && (timeout = bl00mbox_audio_waitfor_timeout)){
+        if(bl00mbox_audio_waitfor_timeout && (timeout >= bl00mbox_audio_waitfor_timeout)){
             return false;
         }
     }
+    bl00mbox_audio_queue_reclaim();
     return true;
 }
 
-bool bl00mbox_audio_do_pointer_change(){
-    if(ptr_set_request_pending){
-        (* ptr_to_be_set_by_audio_task) = ptr_to_be_set_by_audio_task_target;
-        ptr_to_be_set_by_audio_task_target = NULL;
-        ptr_to_be_set_by_audio_task = NULL;
-        ptr_set_request_pending = false;
-        return true;
+static bool bl00mbox_audio_queue_push(bl00mbox_audio_cmd_t * new_cmd){
+    if(!is_initialized) return false;
+    bl00mbox_audio_queue_reclaim();
+    if((queue_write - queue_reclaim) >= BL00MBOX_AUDIO_QUEUE_LEN){
+        if(!bl00mbox_audio_queue_flush()) return false;
     }
-    return false;
+    queue[queue_write & (BL00MBOX_AUDIO_QUEUE_LEN - 1)] = (* new_cmd);
+    __atomic_store_n(&queue_write, queue_write + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+bool bl00mbox_audio_queue_pointer_change(void ** ptr, void * new_val){
+    /// (* ptr) is set to new_val by the audio task before it renders the next block. meant for
+    /// pointers the audio task walks, the user side must not rely on reading back new_val.
+    bl00mbox_audio_cmd_t cmd = { .type = BL00MBOX_AUDIO_CMD_POINTER_CHANGE, .ptr = ptr, .val = new_val };
+    return bl00mbox_audio_queue_push(&cmd);
+}
+
+bool bl00mbox_audio_queue_free(void * ptr){
+    /// frees ptr once the audio task is done with all blocks that might have seen it
+    if(ptr == NULL) return true;
+    bl00mbox_audio_cmd_t cmd = { .type = BL00MBOX_AUDIO_CMD_FREE, .val = ptr };
+    return bl00mbox_audio_queue_push(&cmd);
+}
+
+bool bl00mbox_audio_queue_plugin_destroy(radspa_t * plugin){
+    /// as above, but calls the destructor of the plugin. pending events for it are dropped.
+    if(plugin == NULL) return true;
+    bl00mbox_audio_cmd_t cmd = { .type = BL00MBOX_AUDIO_CMD_PLUGIN_DESTROY, .val = plugin };
+    return bl00mbox_audio_queue_push(&cmd);
+}
+
+bool bl00mbox_audio_queue_event(bl00mbox_audio_event_t * event){
+    /// the audio task applies the event at event->time of the audio clock, or at the start of
+    /// the next block if that time has passed already. returns false if there are too many
+    /// pending events, they only make room once they're due.
+    uint32_t done = __atomic_load_n(&events_done, __ATOMIC_ACQUIRE);
+    if((events_queued - done) >= BL00MBOX_AUDIO_EVENTS_MAX) return false;
+    bl00mbox_audio_cmd_t cmd = { .type = BL00MBOX_AUDIO_CMD_EVENT, .event = (* event) };
+    if(!bl00mbox_audio_queue_push(&cmd)) return false;
+    events_queued++;
+    return true;
+}
+
+uint32_t bl00mbox_audio_get_clock(){
+    return __atomic_load_n(&audio_clock, __ATOMIC_RELAXED);
+}
+
+uint32_t bl00mbox_audio_get_events_missed(){
+    return __atomic_load_n(&events_missed, __ATOMIC_RELAXED);
+}
+
+static int16_t * bl00mbox_audio_event_buffer_get(radspa_signal_t * sig){
+    /// event buffer that sig reads from in the current block, filled with its present value
+    /// when it is new. NULL if sig is connected or we're out of buffers.
+    for(uint8_t k = 0; k < event_buffers_num; k++){
+        if(event_buffer_sigs[k] == sig) return event_buffers[k];
+    }
+    if(event_buffers_num >= BL00MBOX_AUDIO_EVENT_BUFFERS) return NULL;
+    if(sig->buffer != NULL) return NULL;
+    int16_t * buffer = event_buffers[event_buffers_num];
+    for(uint16_t i = 0; i < full_buffer_len; i++){
+        buffer[i] = sig->value;
+    }
+    // the user side only changes signal buffers through the queue, i.e. between blocks
+    sig->buffer = buffer;
+    event_buffer_sigs[event_buffers_num++] = sig;
+    return buffer;
+}
+
+static void bl00mbox_audio_events_apply(uint32_t block_start){
+    /// applies all events that are due in the block starting at block_start. events of a
+    /// channel that is being bounced are kept at the front, they are late once they're applied.
+    uint16_t due = 0;
+    uint16_t held = 0;
+    while(due < events_num){
+        bl00mbox_audio_event_t * event = &(events[due]);
+        int32_t offset = event->time - block_start;
+        if(offset >= full_buffer_len) break;
+        if((events_hold_chan != NULL) && (&(channels[event->channel]) == events_hold_chan)){
+            events[held++] = (* event);
+            due++;
+            continue;
+        }
+        radspa_signal_t * sig = &(event->plugin->signals[event->signal_index]);
+        bool missed = offset < 0;
+        if(missed) offset = 0;
+        int16_t value = event->value;
+        if(event->trigger){
+            int16_t hist = sig->value;
+            value = radspa_trigger_start(value, &hist);
+        } else if(value == -32768){
+            value = -32767; // marks constant buffers
+        }
+        if(offset){
+            int16_t * buffer = bl00mbox_audio_event_buffer_get(sig);
+            if(buffer != NULL){
+                for(uint16_t i = offset; i < full_buffer_len; i++){
+                    buffer[i] = value;
+                }
+            } else if(sig->buffer == NULL){
+                missed = true; // out of event buffers, takes effect at block start
+            }
+        }
+        if(missed) __atomic_store_n(&events_missed, events_missed + 1, __ATOMIC_RELAXED);
+        sig->value = value;
+        due++;
+    }
+    uint16_t applied = due - held;
+    if(!applied) return;
+    memmove(&(events[held]), &(events[due]), (events_num - due) * sizeof(bl00mbox_audio_event_t));
+    events_num -= applied;
+    __atomic_store_n(&events_done, events_done + applied, __ATOMIC_RELEASE);
+}
+
+static void bl00mbox_audio_events_release(){
+    /// detaches all event buffers after the block has been rendered. plugins can't be destroyed
+    /// before the next block so all signals are still around.
+    for(uint8_t k = 0; k < event_buffers_num; k++){
+        event_buffer_sigs[k]->buffer = NULL;
+    }
+    event_buffers_num = 0;
 }
 
 void bl00mbox_channel_event(uint8_t chan){
@@ -132,10 +394,15 @@ void bl00mbox_channels_init(){
         chan->root_list = NULL;
         chan->buds = NULL;
         chan->connections = NULL;
+        chan->render_list = NULL;
+        chan->render_list_latest = NULL;
+        chan->render_list_hold = false;
         chan->is_active = true;
         chan->is_free = true;
         chan->name = NULL;
-        chan->dc = 0;
+        chan->dc[0] = 0;
+        chan->dc[1] = 0;
+        memset(&(chan->cycles), 0, sizeof(bl00mbox_cycles_t));
     }
     is_initialized = true;
 }
@@ -144,12 +411,14 @@ void bl00mbox_channel_enable(uint8_t chan){
     if(chan >= (BL00MBOX_CHANNELS)) return;
     bl00mbox_channel_t * ch = bl00mbox_get_channel(chan);
     ch->is_active = true;
+    bl00mbox_channel_background_set_update(chan);
 }
 
 void bl00mbox_channel_disable(uint8_t chan){
     if(chan >= (BL00MBOX_CHANNELS)) return;
     bl00mbox_channel_t * ch = bl00mbox_get_channel(chan);
     ch->is_active = false;
+    bl00mbox_channel_background_set_update(chan);
 }
 
 void bl00mbox_channel_set_volume(uint8_t chan, uint16_t volume){
@@ -164,120 +433,635 @@ int16_t bl00mbox_channel_get_volume(uint8_t chan){
     return ch->volume;
 }
 
-void bl00mbox_audio_bud_render(bl00mbox_bud_t * bud){
-    if(bud->render_pass_id == render_pass_id) return;
-#ifdef BL00MBOX_LOOPS_ENABLE
-    if(bud->is_being_rendered) return;
+#ifdef BL00MBOX_PROFILING_ENABLE
+static uint32_t profiling_window = 1;
+static uint32_t profiling_samples = 0;
+
+static inline uint32_t bl00mbox_audio_cycles(){
+#ifdef BL00MBOX_HOST
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000UL + ts.tv_nsec;
+#else
+    return esp_cpu_get_cycle_count();
+#endif
+}
+
+static void bl00mbox_audio_cycles_add(bl00mbox_cycles_t * cycles, uint32_t val){
+    uint32_t window = profiling_window;
+    if(cycles->window != window){
+        if(cycles->count){
+            cycles->last_min = cycles->min;
+            cycles->last_avg = cycles->sum / cycles->count;
+            cycles->last_max = cycles->max;
+            cycles->last_window = cycles->window;
+        }
+        cycles->window = window;
+        cycles->count = 0;
+        cycles->sum = 0;
+        cycles->min = UINT32_MAX;
+        cycles->max = 0;
+    }
+    cycles->count++;
+    cycles->sum += val;
+    if(val < cycles->min) cycles->min = val;
+    if(val > cycles->max) cycles->max = val;
+}
 #endif
+
+bool bl00mbox_audio_cycles_get(bl00mbox_cycles_t * cycles, uint32_t * min, uint32_t * avg, uint32_t * max){
+    /// user side. the audio task may update the stats while we're reading them, good enough
+    /// for profiling.
+    (* min) = 0;
+    (* avg) = 0;
+    (* max) = 0;
+#ifdef BL00MBOX_PROFILING_ENABLE
+    if(cycles == NULL) return false;
+    uint32_t last = profiling_window - 1;
+    if(cycles->last_window == last){
+        (* min) = cycles->last_min;
+        (* avg) = cycles->last_avg;
+        (* max) = cycles->last_max;
+        return true;
+    }
+    // no render since the window ended, running stats haven't been handed over yet
+    uint32_t count = cycles->count;
+    if(cycles->window == last && count){
+        (* min) = cycles->min;
+        (* avg) = cycles->sum / count;
+        (* max) = cycles->max;
+        return true;
+    }
+#endif
+    return false;
+}
+
+bool bl00mbox_channel_get_cycles(uint8_t channel, uint32_t * min, uint32_t * avg, uint32_t * max){
+    bl00mbox_channel_t * chan = bl00mbox_get_channel(channel);
+    return bl00mbox_audio_cycles_get(chan == NULL ? NULL : &(chan->cycles), min, avg, max);
+}
+
+uint32_t bl00mbox_audio_get_cycles_per_block(){
+#ifdef BL00MBOX_HOST
+    uint64_t cycles_per_second = 1000000000ULL;
+#else
+    uint64_t cycles_per_second = esp_rom_get_cpu_ticks_per_us() * 1000000ULL;
+#endif
+    return cycles_per_second * full_buffer_len / SAMPLE_RATE;
+}
+
+void bl00mbox_audio_bud_render(bl00mbox_bud_t * bud, uint16_t num_samples){
     bud->is_being_rendered = true;
-    bud->plugin->render(bud->plugin, full_buffer_len, render_pass_id);
-    bud->render_pass_id = render_pass_id;
+#ifdef BL00MBOX_PROFILING_ENABLE
+    uint32_t start = bl00mbox_audio_cycles();
+    bud->plugin->render(bud->plugin, num_samples, render_pass_id);
+    bl00mbox_audio_cycles_add(&(bud->cycles), bl00mbox_audio_cycles() - start);
+#else
+    bud->plugin->render(bud->plugin, num_samples, render_pass_id);
+#endif
     bud->is_being_rendered = false;
 }
 
-static bool bl00mbox_audio_channel_render(bl00mbox_channel_t * chan, int16_t * out, bool adding){
-    if(render_pass_id == chan->render_pass_id) return false;
-    chan->render_pass_id = render_pass_id;
+#ifdef BL00MBOX_IDLE_SKIP_ENABLE
+static bool bl00mbox_audio_bud_is_idle(bl00mbox_render_list_t * list, uint16_t pos){
+    /// true if the plugin was idle after its last render and none of the inputs it
+    /// watches have changed since, see radspa.h
+    if(!(list->state[pos] & BL00MBOX_RENDER_IDLE)) return false;
+    radspa_t * plugin = list->buds[pos]->plugin;
+    for(uint16_t k = list->inputs_start[pos]; k < list->inputs_start[pos + 1]; k++){
+        radspa_signal_t * sig = &(plugin->signals[list->inputs[k].signal]);
+        if(sig->hints & RADSPA_SIGNAL_HINT_IDLE_IGNORE) continue;
+        if(radspa_signal_get_const_value(sig, render_pass_id) != list->idle_values[k]) return false;
+    }
+    return true;
+}
 
-    bl00mbox_channel_root_t * root = chan->root_list;
+static void bl00mbox_audio_bud_render_watch(bl00mbox_render_list_t * list, uint16_t pos, uint16_t num_samples){
+    /// renders a bud. if it reports being idle afterwards its inputs are remembered so
+    /// that we can tell when it needs to wake up.
+    radspa_t * plugin = list->buds[pos]->plugin;
+    bl00mbox_audio_bud_render(list->buds[pos], num_samples);
+    list->state[pos] &= ~BL00MBOX_RENDER_IDLE;
+    if(!plugin->idle) return;
+    for(uint16_t k = list->inputs_start[pos]; k < list->inputs_start[pos + 1]; k++){
+        radspa_signal_t * sig = &(plugin->signals[list->inputs[k].signal]);
+        if(sig->hints & RADSPA_SIGNAL_HINT_IDLE_IGNORE) continue;
+        int16_t value = radspa_signal_get_const_value(sig, render_pass_id);
+        if(value == RADSPA_SIGNAL_NONCONST) return;
+        list->idle_values[k] = value;
+    }
+    list->state[pos] |= BL00MBOX_RENDER_IDLE;
+}
 
-    // early exit when no sources:
-    if((root == NULL) || (!chan->is_active)){
-        return false;
+static void bl00mbox_audio_bud_pull(bl00mbox_render_list_t * list, uint16_t pos, uint16_t num_samples){
+    /// renders all deferred buds that the bud at pos reads from as well as everything
+    /// they read from in turn. sources come before their readers, so one sweep down
+    /// collects them and one sweep up renders them in order.
+    bool found = false;
+    for(uint16_t k = list->inputs_start[pos]; k < list->inputs_start[pos + 1]; k++){
+        uint16_t source = list->inputs[k].source;
+        if(source == BL00MBOX_RENDER_NO_SOURCE) continue;
+        if(!(list->state[source] & BL00MBOX_RENDER_DEFERRED)) continue;
+        list->state[source] |= BL00MBOX_RENDER_PULL;
+        found = true;
+    }
+    if(!found) return;
+    for(uint16_t i = pos; i-- > 0;){
+        if(!(list->state[i] & BL00MBOX_RENDER_PULL)) continue;
+        for(uint16_t k = list->inputs_start[i]; k < list->inputs_start[i + 1]; k++){
+            uint16_t source = list->inputs[k].source;
+            if(source == BL00MBOX_RENDER_NO_SOURCE) continue;
+            if(list->state[source] & BL00MBOX_RENDER_DEFERRED) list->state[source] |= BL00MBOX_RENDER_PULL;
+        }
     }
+    for(uint16_t i = 0; i < pos; i++){
+        if(!(list->state[i] & BL00MBOX_RENDER_PULL)) continue;
+        list->state[i] &= ~(BL00MBOX_RENDER_PULL | BL00MBOX_RENDER_DEFERRED);
+        if(!bl00mbox_audio_bud_is_idle(list, i)) bl00mbox_audio_bud_render_watch(list, i, num_samples);
+    }
+}
 
-    int32_t acc[full_buffer_len];
-    bool acc_init = false;
+static void bl00mbox_audio_render_list_render(bl00mbox_render_list_t * list, uint16_t num_samples){
+    /// going backwards, every bud learns whether anybody listens to it before we get to it:
+    /// pinned buds are always needed, and so is everything a needed bud reads from unless
+    /// the bud is idle and ignores that input. buds nobody listens to are deferred, if
+    /// a reader wakes up further down the line they're rendered on the spot.
+    for(uint16_t i = list->len; i-- > 0;){
+        uint8_t state = list->state[i];
+        if(!(state & (BL00MBOX_RENDER_PINNED | BL00MBOX_RENDER_NEEDED))) continue;
+        radspa_t * plugin = list->buds[i]->plugin;
+        bool idle = state & BL00MBOX_RENDER_IDLE;
+        for(uint16_t k = list->inputs_start[i]; k < list->inputs_start[i + 1]; k++){
+            uint16_t source = list->inputs[k].source;
+            if(source == BL00MBOX_RENDER_NO_SOURCE) continue;
+            if(idle && (plugin->signals[list->inputs[k].signal].hints & RADSPA_SIGNAL_HINT_IDLE_IGNORE)) continue;
+            list->state[source] |= BL00MBOX_RENDER_NEEDED;
+        }
+    }
 
-    while(root != NULL){
-        bl00mbox_audio_bud_render(root->con->source_bud);
-        if(root->con->buffer[1] == -32768){
-            if(!acc_init){
-                for(uint16_t i = 0; i < full_buffer_len; i++){
-                    acc[i] = root->con->buffer[0];
-                }
-                acc_init = true;
-            } else if(root->con->buffer[0]){
-                for(uint16_t i = 0; i < full_buffer_len; i++){
-                    acc[i] += root->con->buffer[0];
-                }
+    for(uint16_t i = 0; i < list->len; i++){
+        uint8_t state = list->state[i];
+        if(!(state & (BL00MBOX_RENDER_PINNED | BL00MBOX_RENDER_NEEDED))){
+            list->state[i] = state | BL00MBOX_RENDER_DEFERRED;
+            continue;
+        }
+        list->state[i] = state & ~(BL00MBOX_RENDER_NEEDED | BL00MBOX_RENDER_DEFERRED);
+        if(bl00mbox_audio_bud_is_idle(list, i)) continue;
+        bl00mbox_audio_bud_pull(list, i, num_samples);
+        bl00mbox_audio_bud_render_watch(list, i, num_samples);
+    }
+}
+#endif
+
+static void bl00mbox_audio_root_add(int32_t * acc, int16_t * buffer, uint16_t num_samples, bool acc_init){
+    /// adds a root to acc, or copies it there if acc hasn't been written to yet
+    if(buffer[1] == -32768){
+        if(!acc_init){
+            for(uint16_t i = 0; i < num_samples; i++){
+                acc[i] = buffer[0];
+            }
+        } else if(buffer[0]){
+            for(uint16_t i = 0; i < num_samples; i++){
+                acc[i] += buffer[0];
+            }
+        }
+    } else {
+        if(!acc_init){
+            for(uint16_t i = 0; i < num_samples; i++){
+                acc[i] = buffer[i];
             }
         } else {
-            if(!acc_init){
-                for(uint16_t i = 0; i < full_buffer_len; i++){
-                    acc[i] = root->con->buffer[i];
-                }
-                acc_init = true;
-            } else {
-                for(uint16_t i = 0; i < full_buffer_len; i++){
-                    acc[i] += root->con->buffer[i];
-                }
+            for(uint16_t i = 0; i < num_samples; i++){
+                acc[i] += buffer[i];
             }
         }
-        root = root->next;
     }
+}
+
+static void bl00mbox_audio_mix_side(int32_t * acc, bool acc_init, int16_t * last, uint16_t num_samples,
+                int32_t volume, int32_t * dc_state, int16_t * out, bool both, bool adding){
+    /// dc blocking and volume for one side of the output mixer. acc holds the sum of the roots
+    /// if acc_init is set, last is added on top unless it is NULL. out is interleaved stereo and
+    /// starts at the side that is written to, both writes the same data to the other side too.
+    // constant buffers only have valid data at [0]
+    uint16_t index_mask = 0;
+    int16_t zero = 0;
+    if(last == NULL){
+        last = &zero;
+    } else if(last[1] != -32768){
+        index_mask = 0xFFFF;
+    }
+    int32_t dc = (* dc_state);
+    for(uint16_t i = 0; i < num_samples; i++){
+        int32_t in = last[i & index_mask];
+        if(acc_init) in += acc[i];
 
-    for(uint16_t i = 0; i < full_buffer_len; i++){
         // flip around for rounding towards zero/mulsh boost
-        bool invert = chan->dc < 0;
-        if(invert) chan->dc = -chan->dc;
-        chan->dc = ((uint64_t) chan->dc * (((1<<12) - 1)<<20)) >> 32;
-        if(invert) chan->dc = -chan->dc;
+        bool invert = dc < 0;
+        if(invert) dc = -dc;
+        dc = ((uint64_t) dc * (((1<<12) - 1)<<20)) >> 32;
+        if(invert) dc = -dc;
+        dc += in;
+        in -= (dc >> 12);
 
-        chan->dc += acc[i];
+        int16_t ret = radspa_mult_shift(in, volume);
+        int16_t * o = &(out[2*i]);
+        if(adding){
+            o[0] = radspa_add_sat(ret, o[0]);
+            if(both) o[1] = radspa_add_sat(ret, o[1]);
+        } else {
+            o[0] = ret;
+            if(both) o[1] = ret;
+        }
+    }
+    (* dc_state) = dc;
+}
 
-        acc[i] -= (chan->dc >> 12);
+static void bl00mbox_audio_render_list_mix(bl00mbox_render_list_t * render_list, uint16_t num_samples,
+                int32_t volume, int32_t * dc_state, int16_t * out, bool adding){
+    /// renders all buds in the list and mixes the roots into the interleaved stereo buffer out
+    /// like the output mixer of a channel does. dc_state holds the left and right dc blocker.
+#ifdef BL00MBOX_IDLE_SKIP_ENABLE
+    bl00mbox_audio_render_list_render(render_list, num_samples);
+#else
+    // sources always come before their sinks so every input buffer is
+    // up to date by the time a bud reads from it.
+    for(uint16_t i = 0; i < render_list->len; i++){
+        bl00mbox_audio_bud_render(render_list->buds[i], num_samples);
     }
+#endif
+
+    int32_t acc[BL00MBOX_MAX_BUFFER_LEN];
+    bool acc_init = false;
 
-    if(adding){
-        for(uint16_t i = 0; i < full_buffer_len; i++){
-            out[i] = radspa_add_sat(radspa_mult_shift(acc[i], chan->volume), out[i]);
+    if(!render_list->stereo){
+        // all roots but the last one are summed up in acc, the last one is added in the same pass
+        // that does dc blocking and volume. both sides are the same, so is their dc blocker.
+        uint16_t last = render_list->num_roots - 1;
+        for(uint16_t r = 0; r < last; r++){
+            bl00mbox_audio_root_add(acc, render_list->roots[r], num_samples, acc_init);
+            acc_init = true;
         }
-    } else {
-        for(uint16_t i = 0; i < full_buffer_len; i++){
-            out[i] = radspa_mult_shift(acc[i], chan->volume);
+        bl00mbox_audio_mix_side(acc, acc_init, render_list->roots[last], num_samples,
+                    volume, &(dc_state[0]), out, true, adding);
+        dc_state[1] = dc_state[0];
+        return;
+    }
+
+    // one side after the other, roots that feed both are added to each
+    for(uint8_t side = 0; side < 2; side++){
+        acc_init = false;
+        for(uint16_t r = 0; r < render_list->num_roots; r++){
+            if(!(render_list->root_sides[r] & (1<<side))) continue;
+            bl00mbox_audio_root_add(acc, render_list->roots[r], num_samples, acc_init);
+            acc_init = true;
         }
+        bl00mbox_audio_mix_side(acc, acc_init, NULL, num_samples,
+                    volume, &(dc_state[side]), &(out[side]), false, adding);
+    }
+}
+
+static bool bl00mbox_audio_channel_render(bl00mbox_channel_t * chan, int16_t * out, bool adding){
+    bl00mbox_render_list_t * render_list = chan->render_list;
+
+    // early exit when no sources:
+    if((render_list == NULL) || (!chan->is_active)){
+        return false;
     }
+
+#ifdef BL00MBOX_PROFILING_ENABLE
+    uint32_t start = bl00mbox_audio_cycles();
+#endif
+    bl00mbox_audio_render_list_mix(render_list, full_buffer_len, chan->volume, chan->dc, out, adding);
+#ifdef BL00MBOX_PROFILING_ENABLE
+    bl00mbox_audio_cycles_add(&(chan->cycles), bl00mbox_audio_cycles() - start);
+#endif
     return true;
 }
 
+// channels that are rendered in the current block, in mixing order
+static bl00mbox_channel_t * render_jobs[BL00MBOX_CHANNELS];
+static uint8_t render_jobs_num;
+
+static void bl00mbox_audio_add_render_job(bl00mbox_channel_t * chan){
+    // a channel may be requested more than once, e.g. channel 0 in foreground
+    if(render_pass_id == chan->render_pass_id) return;
+    chan->render_pass_id = render_pass_id;
+    if((chan->render_list == NULL) || (!chan->is_active)) return;
+    render_jobs[render_jobs_num++] = chan;
+}
+
+#ifdef BL00MBOX_MULTICORE_ENABLE
+// optional: independent channels are split between the audio task and a worker task on the
+// other core. both grab channels from render_jobs until there are none left, each channel
+// renders into its own buffer and the audio task mixes them in order once the worker is done.
+// if only one channel is to be rendered the worker is left alone.
+static volatile bool bl00mbox_audio_multicore = false;
+static bool multicore_initialized = false;
+static int16_t (* render_jobs_out)[2 * BL00MBOX_MAX_BUFFER_LEN] = NULL;
+#ifndef BL00MBOX_HOST
+static int8_t audio_core = -1; // written by audio task only, -1 until the first block
+#endif
+static bool render_jobs_ret[BL00MBOX_CHANNELS];
+static uint32_t render_jobs_next;
+
+#ifdef BL00MBOX_HOST
+static sem_t worker_start;
+static sem_t worker_done;
+static void worker_give(sem_t * sem){ sem_post(sem); }
+static void worker_take(sem_t * sem){ while(sem_wait(sem)); }
+#else
+static SemaphoreHandle_t worker_start;
+static SemaphoreHandle_t worker_done;
+static void worker_give(SemaphoreHandle_t * sem){ xSemaphoreGive(* sem); }
+static void worker_take(SemaphoreHandle_t * sem){ xSemaphoreTake(* sem, portMAX_DELAY); }
+#endif
+
+static void bl00mbox_audio_render_jobs(){
+    while(true){
+        uint32_t job = __atomic_fetch_add(&render_jobs_next, 1, __ATOMIC_RELAXED);
+        if(job >= render_jobs_num) break;
+        render_jobs_ret[job] = bl00mbox_audio_channel_render(render_jobs[job], render_jobs_out[job], false);
+    }
+}
+
+static void bl00mbox_audio_worker_task(void * arg){
+    while(true){
+        worker_take(&worker_start);
+        bl00mbox_audio_render_jobs();
+        worker_give(&worker_done);
+    }
+}
+
+#ifdef BL00MBOX_HOST
+static void * bl00mbox_audio_worker_thread(void * arg){
+    bl00mbox_audio_worker_task(arg);
+    return NULL;
+}
+#endif
+
+static bool bl00mbox_audio_multicore_init(){
+    /// called from the user side, the worker and its buffers stick around once created
+    if(multicore_initialized) return true;
+    render_jobs_out = malloc(sizeof(int16_t) * 2 * BL00MBOX_MAX_BUFFER_LEN * BL00MBOX_CHANNELS);
+    if(render_jobs_out == NULL) return false;
+#ifdef BL00MBOX_HOST
+    pthread_t worker;
+    sem_init(&worker_start, 0, 0);
+    sem_init(&worker_done, 0, 0);
+    if(pthread_create(&worker, NULL, bl00mbox_audio_worker_thread, NULL)){
+        free(render_jobs_out);
+        return false;
+    }
+#else
+    worker_start = xSemaphoreCreateBinary();
+    worker_done = xSemaphoreCreateBinary();
+    if(worker_start == NULL || worker_done == NULL){
+        free(render_jobs_out);
+        return false;
+    }
+    // pin to the core that isn't running the audio task, else the audio task would wait for a
+    // worker that can only run once it is done. st3m pins the audio task to core 1, so the
+    // worker shares core 0 with micropython and holds it up only while it renders its share.
+    int8_t core = __atomic_load_n(&audio_core, __ATOMIC_RELAXED);
+    if(core < 0) core = 1; // no block rendered yet, go by st3m
+    core = core ? 0 : 1;
+    if(xTaskCreatePinnedToCore(bl00mbox_audio_worker_task, "bl00mbox", 8192, NULL,
+                configMAX_PRIORITIES - 1, NULL, core) != pdPASS){
+        free(render_jobs_out);
+        return false;
+    }
+#endif
+    multicore_initialized = true;
+    return true;
+}
+#endif
+
+#ifdef BL00MBOX_BOUNCE_ENABLE
+// offline rendering: while a channel is bounced its render list belongs to the bounce task, the
+// audio task sees NULL in its place. the bounce task renders at its own pace in blocks of
+// BL00MBOX_MAX_BUFFER_LEN, mixes them like the output mixer at full volume and writes the mono
+// mixdown to dest. the user side hands the render list back to the audio task once it sees the
+// bounce finished. line in is silent in the bounce task, pending events of the channel are held
+// back by the audio task until then.
+static struct {
+    bl00mbox_channel_t * chan; // NULL if no bounce is running, user side only
+    bl00mbox_render_list_t * list;
+    int16_t * dest;
+    uint32_t num_samples;
+    uint32_t progress; // written by bounce task only
+    bool initialized;
+#ifdef BL00MBOX_HOST
+    sem_t start;
+    pthread_t task;
+#else
+    SemaphoreHandle_t start;
+    TaskHandle_t task;
+#endif
+} bounce;
+
+static void bl00mbox_audio_bounce_task(void * arg){
+    while(true){
+#ifdef BL00MBOX_HOST
+        while(sem_wait(&bounce.start));
+#else
+        xSemaphoreTake(bounce.start, portMAX_DELAY);
+#endif
+        int32_t dc[2] = {0, 0};
+        int16_t block[2 * BL00MBOX_MAX_BUFFER_LEN];
+        uint32_t pos = 0;
+        while(pos < bounce.num_samples){
+            uint32_t len = bounce.num_samples - pos;
+            if(len > BL00MBOX_MAX_BUFFER_LEN) len = BL00MBOX_MAX_BUFFER_LEN;
+            bl00mbox_audio_render_list_mix(bounce.list, len, 32767, dc, block, false);
+            // mono mixdown, exact for channels that feed both sides the same
+            for(uint32_t i = 0; i < len; i++){
+                bounce.dest[pos + i] = (block[2*i] + block[2*i+1]) >> 1;
+            }
+            pos += len;
+            __atomic_store_n(&bounce.progress, pos, __ATOMIC_RELEASE);
+        }
+    }
+}
+
+#ifdef BL00MBOX_HOST
+static void * bl00mbox_audio_bounce_thread(void * arg){
+    bl00mbox_audio_bounce_task(arg);
+    return NULL;
+}
+#endif
+
+static bool bl00mbox_audio_bounce_init(){
+    /// called from the user side, the task sticks around once created
+    if(bounce.initialized) return true;
+#ifdef BL00MBOX_HOST
+    sem_init(&bounce.start, 0, 0);
+    if(pthread_create(&bounce.task, NULL, bl00mbox_audio_bounce_thread, NULL)) return false;
+#else
+    bounce.start = xSemaphoreCreateBinary();
+    if(bounce.start == NULL) return false;
+    // lowest priority above idle, this is strictly background work
+    if(xTaskCreate(bl00mbox_audio_bounce_task, "bl00mbox_bounce", 8192, NULL,
+                tskIDLE_PRIORITY + 1, &bounce.task) != pdPASS){
+        return false;
+    }
+#endif
+    bounce.initialized = true;
+    return true;
+}
+#endif
+
+bool bl00mbox_audio_bounce_start(bl00mbox_channel_t * chan, int16_t * dest, uint32_t num_samples){
+#ifdef BL00MBOX_BOUNCE_ENABLE
+    if(bounce.chan != NULL) return false;
+    if(chan->render_list_latest == NULL) return false;
+    if(!bl00mbox_audio_bounce_init()) return false;
+    // once the queue is flushed the audio task has moved on to a block without this channel
+    if(!bl00mbox_audio_queue_pointer_change((void **) &events_hold_chan, chan)) return false;
+    if(!bl00mbox_audio_queue_pointer_change((void **) &(chan->render_list), NULL)
+            || !bl00mbox_audio_queue_flush()){
+        bl00mbox_audio_queue_pointer_change((void **) &events_hold_chan, NULL);
+        bl00mbox_audio_queue_pointer_change((void **) &(chan->render_list), chan->render_list_latest);
+        return false;
+    }
+    bounce.chan = chan;
+    bounce.list = chan->render_list_latest;
+    bounce.dest = dest;
+    bounce.num_samples = num_samples;
+    bounce.progress = 0;
+#ifdef BL00MBOX_HOST
+    sem_post(&bounce.start);
+#else
+    xSemaphoreGive(bounce.start);
+#endif
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool bl00mbox_audio_bounce_poll(uint32_t * progress){
+#ifdef BL00MBOX_BOUNCE_ENABLE
+    if(bounce.chan == NULL){
+        (* progress) = 0;
+        return true;
+    }
+    (* progress) = __atomic_load_n(&bounce.progress, __ATOMIC_ACQUIRE);
+    if((* progress) < bounce.num_samples) return false;
+    bl00mbox_channel_t * chan = bounce.chan;
+    if(!bl00mbox_audio_queue_pointer_change((void **) &(chan->render_list), chan->render_list_latest)) return false;
+    bl00mbox_audio_queue_pointer_change((void **) &events_hold_chan, NULL);
+    bounce.chan = NULL;
+    return true;
+#else
+    (* progress) = 0;
+    return true;
+#endif
+}
+
+int16_t * bl00mbox_audio_get_line_in(){
+#ifdef BL00MBOX_BOUNCE_ENABLE
+    // the bounce task isn't synced to the audio task, rx may be gone or shorter than its block
+    if(bounce.initialized){
+#ifdef BL00MBOX_HOST
+        if(pthread_equal(pthread_self(), bounce.task)) return NULL;
+#else
+        if(xTaskGetCurrentTaskHandle() == bounce.task) return NULL;
+#endif
+    }
+#endif
+    return bl00mbox_line_in_interlaced;
+}
+
+bool bl00mbox_audio_set_multicore(bool enable){
+#ifdef BL00MBOX_MULTICORE_ENABLE
+    if(enable && !bl00mbox_audio_multicore_init()) return false;
+    bl00mbox_audio_multicore = enable;
+    return true;
+#else
+    return !enable;
+#endif
+}
+
+bool bl00mbox_audio_get_multicore(){
+#ifdef BL00MBOX_MULTICORE_ENABLE
+    return bl00mbox_audio_multicore;
+#else
+    return false;
+#endif
+}
+
 bool _bl00mbox_audio_render(int16_t * rx, int16_t * tx, uint16_t len){
     if(!is_initialized) return false;
 
-    bl00mbox_audio_do_pointer_change();
+    bl00mbox_audio_queue_process();
     bl00mbox_channel_foreground = last_chan_event;
 
     if(!bl00mbox_audio_run) return false;
 
     render_pass_id++; // fresh pass, all relevant sources must be recomputed
     full_buffer_len = len/2;
+    if(full_buffer_len > BL00MBOX_MAX_BUFFER_LEN) return false;
+    uint32_t block_start = audio_clock;
+    __atomic_store_n(&audio_clock, block_start + full_buffer_len, __ATOMIC_RELAXED);
+    bl00mbox_audio_events_apply(block_start);
+#ifdef BL00MBOX_PROFILING_ENABLE
+    profiling_samples += full_buffer_len;
+    if(profiling_samples >= SAMPLE_RATE){
+        profiling_samples -= SAMPLE_RATE;
+        profiling_window++;
+    }
+#endif
     bl00mbox_line_in_interlaced = rx;
-    int16_t acc[full_buffer_len];
+    // channels are mixed right into tx, it must not share memory with rx
     bool acc_init = false;
-    // system channel always runs non-adding
-    acc_init = bl00mbox_audio_channel_render(&(channels[0]), acc, acc_init) || acc_init;
 
-    // re-rendering channels is ok, if render_pass_id didn't change it will just exit
-    acc_init = bl00mbox_audio_channel_render(&(channels[bl00mbox_channel_foreground]), acc, acc_init) || acc_init;
-
-    // TODO: scales poorly if there's many channels
+    render_jobs_num = 0;
+    // system channel always comes first
+    bl00mbox_audio_add_render_job(&(channels[0]));
+    bl00mbox_audio_add_render_job(&(channels[bl00mbox_channel_foreground]));
 #ifdef BL00MBOX_BACKGROUND_MUTE_OVERRIDE_ENABLE
-    for(uint8_t i = 1; i < (BL00MBOX_CHANNELS); i++){
-        if(bl00mbox_channel_background_mute_override[i]){
-            acc_init = bl00mbox_audio_channel_render(&(channels[i]), acc, acc_init) || acc_init;
+    for(uint8_t w = 0; w < BL00MBOX_CHANNEL_SET_WORDS; w++){
+        uint32_t set = __atomic_load_n(&(bl00mbox_channel_background_set[w]), __ATOMIC_RELAXED);
+        while(set){
+            uint8_t i = w * 32 + __builtin_ctz(set);
+            set &= set - 1;
+            bl00mbox_audio_add_render_job(&(channels[i]));
         }
     }
 #endif
 
-    if(!acc_init) return false;
-
-    for(uint16_t i = 0; i < full_buffer_len; i++){
-        tx[2*i] = acc[i];
-        tx[2*i+1] = acc[i];
+#ifdef BL00MBOX_MULTICORE_ENABLE
+#ifndef BL00MBOX_HOST
+    __atomic_store_n(&audio_core, (int8_t) xPortGetCoreID(), __ATOMIC_RELAXED);
+#endif
+    if(bl00mbox_audio_multicore && (render_jobs_num > 1)){
+        render_jobs_next = 0;
+        worker_give(&worker_start);
+        bl00mbox_audio_render_jobs();
+        worker_take(&worker_done);
+        // mix in the same order as below so that the result doesn't depend on the mode
+        for(uint8_t j = 0; j < render_jobs_num; j++){
+            if(!render_jobs_ret[j]) continue;
+            if(!acc_init){
+                memcpy(tx, render_jobs_out[j], len * sizeof(int16_t));
+                acc_init = true;
+            } else {
+                for(uint16_t i = 0; i < len; i++){
+                    tx[i] = radspa_add_sat(render_jobs_out[j][i], tx[i]);
+                }
+            }
+        }
+        render_jobs_num = 0;
     }
-    return true;
+#endif
+    for(uint8_t j = 0; j < render_jobs_num; j++){
+        acc_init = bl00mbox_audio_channel_render(render_jobs[j], tx, acc_init) || acc_init;
+    }
+    return acc_init;
 }
 
 void bl00mbox_audio_render(int16_t * rx, int16_t * tx, uint16_t len){
     if(!_bl00mbox_audio_render(rx, tx, len)) memset(tx, 0, len*sizeof(int16_t));
+    bl00mbox_audio_events_release();
 }
@@ -89,9 +89,12 @@ radspa_descriptor_t * bl00mbox_plugin_registry_get_id_from_index(uint32_t index)
 
 #include "osc_fm.h"
 #include "osc.h"
+#include "osc_bank.h"
 #include "env_adsr.h"
 #include "ampliverter.h"
 #include "delay.h"
+#include "reverb.h"
+#include "convolution.h"
 #include "lowpass.h"
 #include "filter.h"
 #include "sequencer.h"
@@ -101,27 +104,34 @@ radspa_descriptor_t * bl00mbox_plugin_registry_get_id_from_index(uint32_t index)
 #include "noise_burst.h"
 #include "distortion.h"
 #include "mixer.h"
+#include "pan.h"
 #include "multipitch.h"
 #include "slew_rate_limiter.h"
 #include "range_shifter.h"
 #include "poly_squeeze.h"
 #include "bl00mbox_line_in.h"
+#include "bl00mbox_stream_sampler.h"
 
 void bl00mbox_plugin_registry_init(void){
     if(bl00mbox_plugin_registry_is_initialized) return;
     plugin_add(&osc_desc);
+    plugin_add(&osc_bank_desc);
     plugin_add(&filter_desc);
     plugin_add(&sequencer_desc);
     plugin_add(&sampler_desc);
     plugin_add(&multipitch_desc);
     plugin_add(&bl00mbox_line_in_desc);
+    plugin_add(&bl00mbox_stream_sampler_desc);
     plugin_add(&distortion_desc);
     plugin_add(&mixer_desc);
+    plugin_add(&pan_desc);
     plugin_add(&flanger_desc);
     plugin_add(&noise_desc);
     plugin_add(&noise_burst_desc);
     plugin_add(&env_adsr_desc);   
     plugin_add(&delay_desc);   
+    plugin_add(&reverb_desc);
+    plugin_add(&convolution_desc);
 
     plugin_add(&range_shifter_desc);
     plugin_add(&poly_squeeze_desc);
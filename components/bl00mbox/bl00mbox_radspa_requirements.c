@@ -2,9 +2,9 @@
 #include "bl00mbox_radspa_requirements.h"
 
 bool radspa_host_request_buffer_render(int16_t * buf){
-    bl00mbox_bud_t * bud = ((bl00mbox_connection_t *) buf)->source_bud;
-    bl00mbox_audio_bud_render(bud);
-    return 1;
+    // buds are rendered in order of the channel render list, sources first.
+    // by the time anyone can ask the buffer is always up to date.
+    return 0;
 }
 
 // py: bigtable = [int(22/200*(2**(14-5+8+x*4096/2400/64))) for x in range(64)]
@@ -33,20 +33,19 @@ static const uint16_t smoltable[64] = {
         48843, 48857, 48871, 48885, 48899, 48913, 48928, 48942,
 };
 
-uint32_t radspa_sct_to_rel_freq(int16_t sct, int16_t undersample_pow){
+static inline uint32_t sct_to_rel_freq(int16_t sct, int16_t undersample_pow){
     /// returns approx. proportional to 2**((sct/2400) + undersample_pow) so that
     /// a uint32_t accumulator overflows at 440Hz with sct = INT16_MAX - 6*2400
     /// when sampled at (48>>undersample_pow)kHz
 
-    // compiler explorer says this is 33 instructions with O2. might be alright?
-    uint32_t a = sct;
-    a = sct + 28*2400 - 32767 - 330;
-    // at O2 u get free division for each modulo. still slow, 10 instructions or so.
-    int16_t octa = a / 2400;
-    a = a % 2400;
-    uint8_t bigindex = a / 64;
-    uint8_t smolindex = a % 64;
-    
+    // always positive, range [1335..66870]
+    uint32_t a = sct + 28*2400 - 32767 - 330;
+    // a / 2400 == (a / 32) / 75 without a division, exact over the whole range
+    int16_t octa = ((a >> 5) * 874) >> 16;
+    a -= octa * 2400;
+    uint8_t bigindex = a >> 6;
+    uint8_t smolindex = a & 63;
+
     uint32_t ret = 2; //weird but trust us
     ret *= bigtable[bigindex];
     ret *= smoltable[smolindex];
@@ -58,4 +57,23 @@ uint32_t radspa_sct_to_rel_freq(int16_t sct, int16_t undersample_pow){
     return ret;
 }
 
+uint32_t radspa_sct_to_rel_freq(int16_t sct, int16_t undersample_pow){
+    return sct_to_rel_freq(sct, undersample_pow);
+}
+
+void radspa_sct_to_rel_freq_buffer(const int16_t * sct, uint32_t * rel_freq, uint16_t num_samples, int16_t undersample_pow){
+    /// audio rate pitch signals tend to hold still or move slowly, so runs of the same value are
+    /// only converted once
+    if(!num_samples) return;
+    int16_t prev = sct[0];
+    uint32_t ret = sct_to_rel_freq(prev, undersample_pow);
+    for(uint16_t i = 0; i < num_samples; i++){
+        if(sct[i] != prev){
+            prev = sct[i];
+            ret = sct_to_rel_freq(prev, undersample_pow);
+        }
+        rel_freq[i] = ret;
+    }
+}
+
 int16_t radspa_random(){ return xoroshiro64star()>>16; }
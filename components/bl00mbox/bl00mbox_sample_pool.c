@@ -0,0 +1,107 @@
+//SPDX-License-Identifier: CC0-1.0
+#include "bl00mbox_sample_pool.h"
+#include "bl00mbox_audio.h"
+#include "bl00mbox_wav.h"
+#include <stdlib.h>
+#include <string.h>
+
+static bl00mbox_sample_t * pool = NULL;
+
+static uint32_t sample_pool_hash(const char * path){
+    // fnv-1a
+    uint32_t hash = 2166136261UL;
+    while(* path){
+        hash ^= (uint8_t) (* path++);
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+static uint32_t sample_pool_words(uint32_t num_frames, bool adpcm){
+    return adpcm ? SAMPLER_ADPCM_WORDS(num_frames) : num_frames;
+}
+
+static size_t sample_pool_size(bl00mbox_sample_t * sample){
+    uint32_t words = sample_pool_words(sample->shared.len, sample->shared.adpcm);
+    return sizeof(bl00mbox_sample_t) + strlen(sample->path) + 1 + sizeof(int16_t) * words;
+}
+
+static bl00mbox_sample_t * sample_pool_load(const char * path, uint32_t hash, bool adpcm){
+    bl00mbox_wav_t wav;
+    FILE * file = bl00mbox_wav_open(path, &wav);
+    if(file == NULL) return NULL;
+    if(wav.num_frames == 0){
+        fclose(file);
+        return NULL;
+    }
+    size_t path_len = strlen(path) + 1;
+    uint32_t words = sample_pool_words(wav.num_frames, adpcm);
+    // pcm goes first so that it stays aligned
+    bl00mbox_sample_t * sample = malloc(sizeof(bl00mbox_sample_t) + sizeof(int16_t) * words + path_len);
+    if(sample == NULL){
+        fclose(file);
+        return NULL;
+    }
+    int16_t * pcm = (int16_t *) &(sample[1]);
+    uint32_t len;
+    if(adpcm){
+        len = bl00mbox_wav_read_adpcm(file, &wav, pcm, wav.num_frames);
+    } else {
+        len = bl00mbox_wav_read_mono(file, &wav, pcm, wav.num_frames);
+    }
+    fclose(file);
+    if(len != wav.num_frames){
+        free(sample);
+        return NULL;
+    }
+    sample->shared.pcm = pcm;
+    sample->shared.len = len;
+    sample->shared.adpcm = adpcm;
+    sample->sample_rate = wav.sample_rate;
+    sample->num_channels = wav.num_channels;
+    sample->hash = hash;
+    sample->refcount = 0;
+    sample->path = (char *) &(pcm[words]);
+    memcpy(sample->path, path, path_len);
+    return sample;
+}
+
+bl00mbox_sample_t * bl00mbox_sample_pool_get(const char * path, bool adpcm){
+    uint32_t hash = sample_pool_hash(path);
+    bl00mbox_sample_t * sample = pool;
+    while(sample != NULL){
+        if((sample->hash == hash) && (sample->shared.adpcm == adpcm) && (!strcmp(sample->path, path))) break;
+        sample = sample->next;
+    }
+    if(sample == NULL){
+        sample = sample_pool_load(path, hash, adpcm);
+        if(sample == NULL) return NULL;
+        sample->next = pool;
+        pool = sample;
+    }
+    sample->refcount++;
+    return sample;
+}
+
+void bl00mbox_sample_pool_put(bl00mbox_sample_t * sample){
+    if(sample == NULL) return;
+    if(--(sample->refcount)) return;
+    bl00mbox_sample_t ** seek = &pool;
+    while((* seek) != NULL){
+        if((* seek) == sample){
+            (* seek) = sample->next;
+            break;
+        }
+        seek = &((* seek)->next);
+    }
+    bl00mbox_audio_queue_free(sample);
+}
+
+void bl00mbox_sample_pool_get_usage(uint32_t * num_samples, uint32_t * num_bytes){
+    (* num_samples) = 0;
+    (* num_bytes) = 0;
+    for(bl00mbox_sample_t * sample = pool; sample != NULL; sample = sample->next){
+        (* num_samples)++;
+        (* num_bytes) += sample_pool_size(sample);
+    }
+}
@@ -0,0 +1,207 @@
+//SPDX-License-Identifier: CC0-1.0
+#include "bl00mbox_snapshot.h"
+#include "bl00mbox_user.h"
+
+static const uint8_t snapshot_magic[4] = {'b', 'l', '0', 's'};
+
+typedef struct {
+    uint8_t * buf; // may be NULL, then we only count
+    size_t len;
+    size_t pos;
+} snapshot_writer_t;
+
+typedef struct {
+    const uint8_t * buf;
+    size_t len;
+    size_t pos;
+    bool fail; // ran past the end
+} snapshot_reader_t;
+
+static void snapshot_put(snapshot_writer_t * w, uint32_t val, uint8_t bytes){
+    if((w->buf != NULL) && (w->pos + bytes <= w->len)){
+        for(uint8_t i = 0; i < bytes; i++){
+            w->buf[w->pos + i] = (val >> (8*i)) & 0xFF;
+        }
+    }
+    w->pos += bytes;
+}
+
+static uint32_t snapshot_get(snapshot_reader_t * r, uint8_t bytes){
+    if(r->fail || (r->pos + bytes > r->len)){
+        r->fail = true;
+        return 0;
+    }
+    uint32_t ret = 0;
+    for(uint8_t i = 0; i < bytes; i++){
+        ret |= ((uint32_t) r->buf[r->pos + i]) << (8*i);
+    }
+    r->pos += bytes;
+    return ret;
+}
+
+static uint16_t snapshot_bud_pos(bl00mbox_channel_t * chan, bl00mbox_bud_t * bud){
+    uint16_t pos = 0;
+    for(bl00mbox_bud_t * seek = chan->buds; seek != NULL; seek = seek->chan_next){
+        if(seek == bud) break;
+        pos++;
+    }
+    return pos;
+}
+
+size_t bl00mbox_channel_snapshot_save(uint8_t channel, uint8_t * buf, size_t len, bool tables){
+    bl00mbox_channel_t * chan = bl00mbox_get_channel(channel);
+    if(chan == NULL) return 0;
+    snapshot_writer_t w = { .buf = buf, .len = len, .pos = 0 };
+
+    for(uint8_t i = 0; i < 4; i++) snapshot_put(&w, snapshot_magic[i], 1);
+    snapshot_put(&w, BL00MBOX_SNAPSHOT_VERSION, 1);
+    snapshot_put(&w, tables ? BL00MBOX_SNAPSHOT_TABLES : 0, 1);
+    snapshot_put(&w, bl00mbox_channel_buds_num(channel), 2);
+
+    uint16_t num_conns = 0;
+    for(bl00mbox_bud_t * bud = chan->buds; bud != NULL; bud = bud->chan_next){
+        radspa_t * plugin = bud->plugin;
+        snapshot_put(&w, plugin->descriptor->id, 4);
+        snapshot_put(&w, bud->init_var, 4);
+        snapshot_put(&w, plugin->len_signals, 2);
+        for(uint16_t j = 0; j < plugin->len_signals; j++){
+            radspa_signal_t * sig = &(plugin->signals[j]);
+            bool keep = (sig->hints & RADSPA_SIGNAL_HINT_INPUT) && !(sig->hints & RADSPA_SIGNAL_HINT_TRIGGER);
+            snapshot_put(&w, keep ? (uint16_t) sig->value : 0, 2);
+            if((sig->hints & RADSPA_SIGNAL_HINT_INPUT) && (bl00mbox_bud_get_connection(bud, j) != NULL)) num_conns++;
+        }
+        if(tables){
+            uint32_t table_len = plugin->plugin_table == NULL ? 0 : plugin->plugin_table_len;
+            snapshot_put(&w, table_len, 4);
+            for(uint32_t j = 0; j < table_len; j++){
+                snapshot_put(&w, (uint16_t) plugin->plugin_table[j], 2);
+            }
+        }
+    }
+
+    snapshot_put(&w, num_conns, 2);
+    uint16_t rx_pos = 0;
+    for(bl00mbox_bud_t * bud = chan->buds; bud != NULL; bud = bud->chan_next){
+        radspa_t * plugin = bud->plugin;
+        for(uint16_t j = 0; j < plugin->len_signals; j++){
+            radspa_signal_t * sig = &(plugin->signals[j]);
+            if(!(sig->hints & RADSPA_SIGNAL_HINT_INPUT)) continue;
+            bl00mbox_connection_t * conn = bl00mbox_bud_get_connection(bud, j);
+            if(conn == NULL) continue;
+            snapshot_put(&w, rx_pos, 2);
+            snapshot_put(&w, j, 2);
+            snapshot_put(&w, snapshot_bud_pos(chan, conn->source_bud), 2);
+            snapshot_put(&w, conn->signal_index, 2);
+        }
+        rx_pos++;
+    }
+
+    snapshot_put(&w, bl00mbox_channel_mixer_num(channel), 2);
+    for(bl00mbox_channel_root_t * root = chan->root_list; root != NULL; root = root->next){
+        snapshot_put(&w, snapshot_bud_pos(chan, root->con->source_bud), 2);
+        snapshot_put(&w, root->con->signal_index, 2);
+        snapshot_put(&w, root->sides, 1);
+    }
+    return w.pos;
+}
+
+int32_t bl00mbox_snapshot_get_num_buds(const uint8_t * buf, size_t len){
+    snapshot_reader_t r = { .buf = buf, .len = len, .pos = 0, .fail = false };
+    for(uint8_t i = 0; i < 4; i++){
+        if(snapshot_get(&r, 1) != snapshot_magic[i]) return -1;
+    }
+    uint8_t version = snapshot_get(&r, 1);
+    if(version < 1 || version > BL00MBOX_SNAPSHOT_VERSION) return -1;
+    snapshot_get(&r, 1);
+    uint16_t num_buds = snapshot_get(&r, 2);
+    if(r.fail) return -1;
+    return num_buds;
+}
+
+static bool snapshot_walk(uint8_t channel, snapshot_reader_t * r, uint32_t * bud_indices, bool apply){
+    /// goes through the whole snapshot. without apply it only checks that it is complete and
+    /// that everything it refers to exists, with apply it builds the graph in the channel.
+    int32_t num_buds = bl00mbox_snapshot_get_num_buds(r->buf, r->len);
+    if(num_buds < 0) return false;
+    r->pos = 8;
+    uint8_t version = r->buf[4];
+    uint8_t flags = r->buf[5];
+
+    for(uint16_t b = 0; b < num_buds; b++){
+        uint32_t id = snapshot_get(r, 4);
+        uint32_t init_var = snapshot_get(r, 4);
+        uint16_t num_signals = snapshot_get(r, 2);
+        if(r->fail) return false;
+        radspa_t * plugin = NULL;
+        if(!apply){
+            if(bl00mbox_plugin_registry_get_descriptor_from_id(id) == NULL) return false;
+        } else {
+            bl00mbox_bud_t * bud = bl00mbox_channel_new_bud(channel, id, init_var);
+            if(bud == NULL) return false;
+            bud_indices[b] = bud->index;
+            plugin = bud->plugin;
+            // plugin has changed since the snapshot was taken
+            if(plugin->len_signals != num_signals) return false;
+        }
+        for(uint16_t j = 0; j < num_signals; j++){
+            int16_t value = snapshot_get(r, 2);
+            if(plugin == NULL) continue;
+            radspa_signal_t * sig = &(plugin->signals[j]);
+            if(!(sig->hints & RADSPA_SIGNAL_HINT_INPUT)) continue;
+            if(sig->hints & RADSPA_SIGNAL_HINT_TRIGGER) continue;
+            bl00mbox_channel_bud_set_signal_value(channel, bud_indices[b], j, value);
+        }
+        if(!(flags & BL00MBOX_SNAPSHOT_TABLES)) continue;
+        uint32_t table_len = snapshot_get(r, 4);
+        for(uint32_t j = 0; j < table_len; j++){
+            int16_t value = snapshot_get(r, 2);
+            if(r->fail) return false;
+            if(plugin == NULL || plugin->plugin_table == NULL) continue;
+            if(j < plugin->plugin_table_len) plugin->plugin_table[j] = value;
+        }
+    }
+
+    uint16_t num_conns = snapshot_get(r, 2);
+    for(uint16_t c = 0; c < num_conns; c++){
+        uint16_t rx = snapshot_get(r, 2);
+        uint16_t rx_sig = snapshot_get(r, 2);
+        uint16_t tx = snapshot_get(r, 2);
+        uint16_t tx_sig = snapshot_get(r, 2);
+        if(r->fail || (rx >= num_buds) || (tx >= num_buds)) return false;
+        if(!apply) continue;
+        if(!bl00mbox_channel_connect_signal(channel, bud_indices[rx], rx_sig, bud_indices[tx], tx_sig)) return false;
+    }
+
+    uint16_t num_mixer = snapshot_get(r, 2);
+    for(uint16_t m = 0; m < num_mixer; m++){
+        uint16_t tx = snapshot_get(r, 2);
+        uint16_t tx_sig = snapshot_get(r, 2);
+        uint8_t sides = version < 2 ? BL00MBOX_MIXER_STEREO : snapshot_get(r, 1);
+        if(r->fail || (tx >= num_buds)) return false;
+        if(!apply) continue;
+        if(!bl00mbox_channel_connect_signal_to_output_mixer_sides(channel, bud_indices[tx], tx_sig, sides)) return false;
+    }
+    return (!r->fail) && (r->pos == r->len);
+}
+
+bool bl00mbox_channel_snapshot_restore(uint8_t channel, const uint8_t * buf, size_t len, uint32_t * bud_indices){
+    if(bl00mbox_get_channel(channel) == NULL) return false;
+    int32_t num_buds = bl00mbox_snapshot_get_num_buds(buf, len);
+    if(num_buds < 0) return false;
+    snapshot_reader_t r = { .buf = buf, .len = len, .pos = 0, .fail = false };
+    if(!snapshot_walk(channel, &r, bud_indices, false)) return false;
+
+    for(uint16_t b = 0; b < num_buds; b++) bud_indices[b] = 0;
+    r.pos = 0;
+    // the render list only needs to be built once for the whole graph
+    bl00mbox_channel_hold_render_list(channel, true);
+    bool ret = snapshot_walk(channel, &r, bud_indices, true);
+    bl00mbox_channel_hold_render_list(channel, false);
+    if(ret) return true;
+
+    // plugins may have changed since the snapshot was taken, get rid of what we have so far
+    for(uint16_t b = 0; b < num_buds; b++){
+        if(bud_indices[b]) bl00mbox_channel_delete_bud(channel, bud_indices[b]);
+    }
+    return false;
+}
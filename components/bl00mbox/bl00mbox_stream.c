@@ -0,0 +1,169 @@
+//SPDX-License-Identifier: CC0-1.0
+#include "bl00mbox_stream.h"
+#include "bl00mbox.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef BL00MBOX_HOST
+#include <pthread.h>
+static pthread_mutex_t streams_lock = PTHREAD_MUTEX_INITIALIZER;
+static void streams_take(){ pthread_mutex_lock(&streams_lock); }
+static void streams_give(){ pthread_mutex_unlock(&streams_lock); }
+#else
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "esp_task.h"
+static SemaphoreHandle_t streams_lock = NULL;
+static SemaphoreHandle_t prefetch_kick = NULL;
+static void streams_take(){ xSemaphoreTake(streams_lock, portMAX_DELAY); }
+static void streams_give(){ xSemaphoreGive(streams_lock); }
+#endif
+
+// largest single read, keeps the list lock from being held for too long
+#define BL00MBOX_STREAM_READ_MAX 2048
+
+static bl00mbox_stream_t * streams = NULL;
+
+static void bl00mbox_stream_fill(bl00mbox_stream_t * stream){
+    uint32_t req = __atomic_load_n(&stream->restart_req, __ATOMIC_ACQUIRE);
+    if(req != stream->restart_ack){
+        stream->file_pos = stream->attack_len;
+        stream->seek = true;
+        __atomic_store_n(&stream->ring_write, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&stream->restart_ack, req, __ATOMIC_RELEASE);
+    }
+    uint32_t write = stream->ring_write;
+    uint32_t num_frames = stream->wav.num_frames;
+    while(true){
+        // if the audio task has restarted in the meantime the read counter may be all over
+        // the place, leave it to the next call
+        if(__atomic_load_n(&stream->restart_req, __ATOMIC_ACQUIRE) != req) break;
+        uint32_t used = write - __atomic_load_n(&stream->ring_read, __ATOMIC_ACQUIRE);
+        if(used >= stream->ring_len) break;
+        if(stream->file_pos >= num_frames){
+            if(!__atomic_load_n(&stream->loop, __ATOMIC_RELAXED)) break;
+            stream->file_pos = 0;
+            stream->seek = true;
+        }
+        if(stream->seek){
+            if(!bl00mbox_wav_seek(stream->file, &stream->wav, stream->file_pos)) break;
+            stream->seek = false;
+        }
+        uint32_t pos = write & (stream->ring_len - 1);
+        uint32_t len = stream->ring_len - used;
+        if(len > stream->ring_len - pos) len = stream->ring_len - pos;
+        if(len > num_frames - stream->file_pos) len = num_frames - stream->file_pos;
+        if(len > BL00MBOX_STREAM_READ_MAX) len = BL00MBOX_STREAM_READ_MAX;
+        uint32_t read = bl00mbox_wav_read_mono(stream->file, &stream->wav, &(stream->ring[pos]), len);
+        write += read;
+        stream->file_pos += read;
+        __atomic_store_n(&stream->ring_write, write, __ATOMIC_RELEASE);
+        if(read < len){
+            // try again next time
+            stream->seek = true;
+            break;
+        }
+    }
+}
+
+void bl00mbox_stream_prefetch(){
+    streams_take();
+    for(bl00mbox_stream_t * stream = streams; stream != NULL; stream = stream->next){
+        bl00mbox_stream_fill(stream);
+    }
+    streams_give();
+}
+
+void bl00mbox_stream_restart(bl00mbox_stream_t * stream){
+    __atomic_store_n(&stream->ring_read, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&stream->restart_req, stream->restart_req + 1, __ATOMIC_RELEASE);
+#ifndef BL00MBOX_HOST
+    xSemaphoreGive(prefetch_kick);
+#endif
+}
+
+#ifndef BL00MBOX_HOST
+static void bl00mbox_stream_task(void * arg){
+    while(true){
+        xSemaphoreTake(prefetch_kick, pdMS_TO_TICKS(BL00MBOX_STREAM_PREFETCH_INTERVAL_MS));
+        bl00mbox_stream_prefetch();
+    }
+}
+#endif
+
+static bool bl00mbox_stream_init(){
+    /// called from the user side, the prefetch task sticks around once created
+#ifndef BL00MBOX_HOST
+    if(streams_lock != NULL) return true;
+    if(prefetch_kick == NULL) prefetch_kick = xSemaphoreCreateBinary();
+    if(prefetch_kick == NULL) return false;
+    SemaphoreHandle_t lock = xSemaphoreCreateMutex();
+    if(lock == NULL) return false;
+    // same priority as st3m_media: above micropython, well below the audio task
+    if(xTaskCreate(bl00mbox_stream_task, "bl00mbox_stream", 4096, NULL,
+                ESP_TASK_PRIO_MIN + 3, NULL) != pdPASS){
+        vSemaphoreDelete(lock);
+        return false;
+    }
+    streams_lock = lock;
+#endif
+    return true;
+}
+
+bl00mbox_stream_t * bl00mbox_stream_open(const char * path, uint32_t read_ahead, uint32_t attack_len){
+    if(!bl00mbox_stream_init()) return NULL;
+    bl00mbox_wav_t wav;
+    FILE * file = bl00mbox_wav_open(path, &wav);
+    if(file == NULL) return NULL;
+    if(wav.num_frames == 0){
+        fclose(file);
+        return NULL;
+    }
+    if(attack_len > wav.num_frames) attack_len = wav.num_frames;
+    uint32_t ring_len = BL00MBOX_STREAM_RING_MIN;
+    while((ring_len < read_ahead) && (ring_len < BL00MBOX_STREAM_RING_MAX)) ring_len <<= 1;
+
+    bl00mbox_stream_t * stream = malloc(sizeof(bl00mbox_stream_t) + sizeof(int16_t) * (ring_len + attack_len));
+    if(stream == NULL){
+        fclose(file);
+        return NULL;
+    }
+    memset(stream, 0, sizeof(bl00mbox_stream_t));
+    stream->file = file;
+    stream->wav = wav;
+    stream->ring = (int16_t *) &(stream[1]);
+    stream->ring_len = ring_len;
+    stream->attack = &(stream->ring[ring_len]);
+    stream->attack_len = attack_len;
+    stream->step = (((uint64_t) wav.sample_rate) << 16) / SAMPLE_RATE;
+    if(bl00mbox_wav_read_mono(file, &wav, stream->attack, attack_len) != attack_len){
+        fclose(file);
+        free(stream);
+        return NULL;
+    }
+    stream->file_pos = attack_len;
+
+    // nobody else knows about the stream yet, fill it up so that the first trigger can't run dry
+    bl00mbox_stream_fill(stream);
+    streams_take();
+    stream->next = streams;
+    streams = stream;
+    streams_give();
+    return stream;
+}
+
+void bl00mbox_stream_release(bl00mbox_stream_t * stream){
+    streams_take();
+    bl00mbox_stream_t ** seek = &streams;
+    while((* seek) != NULL){
+        if((* seek) == stream){
+            (* seek) = stream->next;
+            break;
+        }
+        seek = &((* seek)->next);
+    }
+    streams_give();
+    fclose(stream->file);
+    stream->file = NULL;
+}
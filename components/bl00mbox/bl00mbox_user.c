@@ -1,13 +1,84 @@
 //SPDX-License-Identifier: CC0-1.0
 #include "bl00mbox_user.h"
+#include "bl00mbox_stream_sampler.h"
+#include "bl00mbox_wav.h"
+#include "bl00mbox_sample_pool.h"
 
 // get signal struct from a signal index
-radspa_signal_t * bl00mbox_signal_get_by_index(radspa_t * plugin, uint16_t signal_index){
+radspa_signal_t * bl00mbox_signal_get_by_index(radspa_t * plugin, uint32_t signal_index){
+    if(signal_index >= plugin->len_signals) return NULL;
     return &(plugin->signals[signal_index]);
 }
 
-static uint64_t bl00mbox_bud_index = 1;
-bl00mbox_bud_t * bl00mbox_channel_get_bud_by_index(uint8_t channel, uint32_t index);
+// bud handles as seen by python: the low BL00MBOX_BUD_SLOT_BITS pick a slot in bud_slots, the bits
+// above hold the generation of that slot. a slot gets a new generation each time it is reused so
+// that a handle to a deleted bud doesn't silently refer to whichever bud took its place. handles
+// stay below 1<<30 so that they fit into a micropython small int.
+#define BL00MBOX_BUD_SLOT_BITS 16
+#define BL00MBOX_BUD_SLOT_MASK ((1UL<<BL00MBOX_BUD_SLOT_BITS)-1)
+#define BL00MBOX_BUD_GENERATION_MASK ((1UL<<(30-BL00MBOX_BUD_SLOT_BITS))-1)
+#define BL00MBOX_BUD_SLOTS_INIT 32
+#define BL00MBOX_BUD_SLOT_NONE UINT32_MAX
+
+typedef struct {
+    bl00mbox_bud_t * bud; // NULL if free
+    uint32_t next_free; // next slot in free list if free
+    uint16_t generation; // never 0 so that no valid handle is 0
+} bl00mbox_bud_slot_t;
+
+static bl00mbox_bud_slot_t * bud_slots = NULL;
+static uint32_t bud_slots_len = 0;
+static uint32_t bud_slots_free = BL00MBOX_BUD_SLOT_NONE;
+
+static uint32_t bud_slot_acquire(bl00mbox_bud_t * bud){
+    /// takes a slot for bud and returns its handle, 0 if out of slots or memory
+    if(bud_slots_free == BL00MBOX_BUD_SLOT_NONE){
+        uint32_t len = bud_slots_len ? 2 * bud_slots_len : BL00MBOX_BUD_SLOTS_INIT;
+        if(len > BL00MBOX_BUD_SLOT_MASK + 1) len = BL00MBOX_BUD_SLOT_MASK + 1;
+        if(len == bud_slots_len) return 0;
+        bl00mbox_bud_slot_t * slots = realloc(bud_slots, len * sizeof(bl00mbox_bud_slot_t));
+        if(slots == NULL) return 0;
+        for(uint32_t i = bud_slots_len; i < len; i++){
+            slots[i].bud = NULL;
+            slots[i].next_free = (i + 1 < len) ? i + 1 : BL00MBOX_BUD_SLOT_NONE;
+            slots[i].generation = 1;
+        }
+        bud_slots_free = bud_slots_len;
+        bud_slots = slots;
+        bud_slots_len = len;
+    }
+    uint32_t slot = bud_slots_free;
+    bud_slots_free = bud_slots[slot].next_free;
+    bud_slots[slot].bud = bud;
+    return (((uint32_t) bud_slots[slot].generation) << BL00MBOX_BUD_SLOT_BITS) | slot;
+}
+
+static void bud_slot_release(uint32_t index){
+    uint32_t slot = index & BL00MBOX_BUD_SLOT_MASK;
+    bl00mbox_bud_slot_t * s = &(bud_slots[slot]);
+    s->bud = NULL;
+    s->generation = (s->generation & BL00MBOX_BUD_GENERATION_MASK) + 1;
+    if(s->generation > BL00MBOX_BUD_GENERATION_MASK) s->generation = 1;
+    s->next_free = bud_slots_free;
+    bud_slots_free = slot;
+}
+
+// channel that is being bounced and the bud it is bounced into. the bounce task renders them
+// without any further synchronization, so they're off limits until the bounce is done.
+static int16_t bounce_channel = -1;
+static bl00mbox_bud_t * bounce_target = NULL;
+
+bl00mbox_bud_t * bl00mbox_channel_get_bud_by_index(uint8_t channel, uint32_t index){
+    uint32_t slot = index & BL00MBOX_BUD_SLOT_MASK;
+    if(slot >= bud_slots_len) return NULL;
+    bl00mbox_bud_t * bud = bud_slots[slot].bud;
+    if(bud == NULL) return NULL;
+    // stale handle from an earlier generation of the slot
+    if(bud->index != index) return NULL;
+    if(bud->channel != channel) return NULL;
+    if((bud->channel == bounce_channel) || (bud == bounce_target)) return NULL;
+    return bud;
+}
 
 uint16_t bl00mbox_channel_buds_num(uint8_t channel){
     bl00mbox_channel_t * chan = bl00mbox_get_channel(channel);
@@ -99,14 +170,23 @@ uint32_t bl00mbox_channel_get_signal_by_mixer_list_pos(uint8_t channel, uint32_t
     return 0;
 }
 
+uint8_t bl00mbox_channel_get_sides_by_mixer_list_pos(uint8_t channel, uint32_t pos){
+    bl00mbox_channel_t * chan = bl00mbox_get_channel(channel);
+    if(chan == NULL) return 0;
+    uint32_t ret = 0;
+    for(bl00mbox_channel_root_t * root = chan->root_list; root != NULL; root = root->next){
+        if(pos == ret) return root->sides;
+        ret++;
+    }
+    return 0;
+}
+
 uint16_t bl00mbox_channel_subscriber_num(uint8_t channel, uint64_t bud_index, uint16_t signal_index){
     bl00mbox_channel_t * chan = bl00mbox_get_channel(channel);
     if(chan == NULL) return 0;
     bl00mbox_bud_t * bud = bl00mbox_channel_get_bud_by_index(channel, bud_index);
     if(bud == NULL) return 0;
-    radspa_signal_t * sig = bl00mbox_signal_get_by_index(bud->plugin, signal_index);
-    if(sig == NULL) return 0;
-    bl00mbox_connection_t * conn = (bl00mbox_connection_t *) sig->buffer; // buffer sits on top of struct
+    bl00mbox_connection_t * conn = bl00mbox_bud_get_connection(bud, signal_index);
     if(conn == NULL) return 0;
 
     uint16_t ret = 0;
@@ -127,9 +207,7 @@ uint64_t bl00mbox_channel_get_bud_by_subscriber_list_pos(uint8_t channel, uint64
     if(chan == NULL) return 0;
     bl00mbox_bud_t * bud = bl00mbox_channel_get_bud_by_index(channel, bud_index);
     if(bud == NULL) return 0;
-    radspa_signal_t * sig = bl00mbox_signal_get_by_index(bud->plugin, signal_index);
-    if(sig == NULL) return 0;
-    bl00mbox_connection_t * conn = (bl00mbox_connection_t *) sig->buffer; // buffer sits on top of struct
+    bl00mbox_connection_t * conn = bl00mbox_bud_get_connection(bud, signal_index);
     if(conn == NULL) return 0;
 
     uint16_t ret = 0;
@@ -152,9 +230,7 @@ int32_t bl00mbox_channel_get_signal_by_subscriber_list_pos(uint8_t channel, uint
     if(chan == NULL) return 0;
     bl00mbox_bud_t * bud = bl00mbox_channel_get_bud_by_index(channel, bud_index);
     if(bud == NULL) return 0;
-    radspa_signal_t * sig = bl00mbox_signal_get_by_index(bud->plugin, signal_index);
-    if(sig == NULL) return 0;
-    bl00mbox_connection_t * conn = (bl00mbox_connection_t *) sig->buffer; // buffer sits on top of struct
+    bl00mbox_connection_t * conn = bl00mbox_bud_get_connection(bud, signal_index);
     if(conn == NULL) return 0;
 
     uint16_t ret = 0;
@@ -176,9 +252,7 @@ uint64_t bl00mbox_channel_get_source_bud(uint8_t channel, uint64_t bud_index, ui
     if(chan == NULL) return 0;
     bl00mbox_bud_t * bud = bl00mbox_channel_get_bud_by_index(channel, bud_index);
     if(bud == NULL) return 0;
-    radspa_signal_t * sig = bl00mbox_signal_get_by_index(bud->plugin, signal_index);
-    if(sig == NULL) return 0;
-    bl00mbox_connection_t * conn = (bl00mbox_connection_t *) sig->buffer; // buffer sits on top of struct
+    bl00mbox_connection_t * conn = bl00mbox_bud_get_connection(bud, signal_index);
     if(conn == NULL) return 0;
     return conn->source_bud->index;
 }
@@ -188,9 +262,7 @@ uint16_t bl00mbox_channel_get_source_signal(uint8_t channel, uint64_t bud_index,
     if(chan == NULL) return 0;
     bl00mbox_bud_t * bud = bl00mbox_channel_get_bud_by_index(channel, bud_index);
     if(bud == NULL) return 0;
-    radspa_signal_t * sig = bl00mbox_signal_get_by_index(bud->plugin, signal_index);
-    if(sig == NULL) return 0;
-    bl00mbox_connection_t * conn = (bl00mbox_connection_t *) sig->buffer; // buffer sits on top of struct
+    bl00mbox_connection_t * conn = bl00mbox_bud_get_connection(bud, signal_index);
     if(conn == NULL) return 0;
     return conn->signal_index;
 }
@@ -202,6 +274,9 @@ static bl00mbox_connection_t * create_connection(uint8_t channel){
     ret->chan_next = NULL;
     ret->subs = NULL;
     ret->channel = channel;
+    // subscribers may read the buffer before the source is first rendered
+    ret->buffer[0] = 0;
+    ret->buffer[1] = -32768;
 
     if(chan->connections != NULL){
         bl00mbox_connection_t * last = chan->connections;
@@ -215,17 +290,32 @@ static bl00mbox_connection_t * create_connection(uint8_t channel){
     return ret;
 }
 
-static bool weak_delete_connection(bl00mbox_connection_t * conn){
-    if(conn->subs != NULL) return false;
+bl00mbox_connection_t * bl00mbox_bud_get_connection(bl00mbox_bud_t * bud, uint16_t signal_index){
+    if(signal_index >= bud->plugin->len_signals) return NULL;
+    return bud->conns[signal_index];
+}
+
+static void bud_set_connection(bl00mbox_bud_t * bud, uint16_t signal_index, bl00mbox_connection_t * conn){
+    /// plugins may check an input once per block and then read its buffer sample by sample,
+    /// so the buffer must not change while a block is rendered. the audio task swaps it at the
+    /// next block boundary in order with the render list, the user side goes by conns.
+    bud->conns[signal_index] = conn;
+    radspa_signal_t * sig = bl00mbox_signal_get_by_index(bud->plugin, signal_index);
+    int16_t * buffer = conn == NULL ? NULL : conn->buffer;
+    if(!bl00mbox_audio_queue_pointer_change((void **) &(sig->buffer), buffer)){
+        sig->buffer = buffer; // no audio task yet
+    }
+}
+
+static bl00mbox_connection_t * weak_delete_connection(bl00mbox_connection_t * conn){
+    /// unlinks conn if nobody listens to it anymore and returns it, else NULL. the audio task
+    /// may still render from it until the new render list arrives, so the caller queues the
+    /// free after rebuilding the render list.
+    if(conn->subs != NULL) return NULL;
 
     // nullify source bud connection;
     bl00mbox_bud_t * bud = conn->source_bud;
-    if(bud != NULL){
-        radspa_signal_t * tx = bl00mbox_signal_get_by_index(bud->plugin, conn->signal_index);
-        if(tx != NULL){
-            bl00mbox_audio_waitfor_pointer_change(&(tx->buffer), NULL);
-        }
-    }
+    if(bud != NULL) bud_set_connection(bud, conn->signal_index, NULL);
 
     // pop from channel list
     bl00mbox_channel_t * chan = bl00mbox_get_channel(conn->channel);
@@ -238,27 +328,197 @@ static bool weak_delete_connection(bl00mbox_connection_t * conn){
                     break;
                 }
             }
-            if(prev->chan_next != NULL) bl00mbox_audio_waitfor_pointer_change(&(prev->chan_next), conn->chan_next);
+            if(prev->chan_next != NULL) prev->chan_next = conn->chan_next;
         } else {
-            bl00mbox_audio_waitfor_pointer_change(&(chan->connections), conn->chan_next);
+            chan->connections = conn->chan_next;
         }
     }
+    return conn;
+}
 
-    free(conn);
+static int32_t render_list_find(bl00mbox_bud_t ** buds, uint16_t num_buds, bl00mbox_bud_t * bud){
+    for(uint16_t i = 0; i < num_buds; i++){
+        if(buds[i] == bud) return i;
+    }
+    return -1;
+}
+
+static bool render_list_equal(bl00mbox_render_list_t * a, bl00mbox_render_list_t * b){
+    if(a->len != b->len || a->num_roots != b->num_roots) return false;
+    if(memcmp(a->buds, b->buds, a->len * sizeof(bl00mbox_bud_t *))) return false;
+    if(memcmp(a->roots, b->roots, a->num_roots * sizeof(int16_t *))) return false;
+    if(memcmp(a->root_sides, b->root_sides, a->num_roots * sizeof(uint8_t))) return false;
+    if(memcmp(a->inputs_start, b->inputs_start, (a->len + 1) * sizeof(uint16_t))) return false;
+    if(memcmp(a->inputs, b->inputs, a->inputs_start[a->len] * sizeof(bl00mbox_render_input_t))) return false;
+    for(uint16_t i = 0; i < a->len; i++){
+        if((a->state[i] ^ b->state[i]) & BL00MBOX_RENDER_PINNED) return false;
+    }
     return true;
 }
 
-bl00mbox_bud_t * bl00mbox_channel_get_bud_by_index(uint8_t channel, uint32_t index){
+static bool bl00mbox_channel_rebuild_render_list(uint8_t channel){
+    /// sorts all buds that contribute to the output mixer so that each bud comes after the
+    /// buds it reads from and hands the result to the audio task. needs to be called after
+    /// every change to the graph. feedback loops are broken up at the connection that closes
+    /// them, the bud at its end reads last buffer's data.
     bl00mbox_channel_t * chan = bl00mbox_get_channel(channel);
-    if(chan == NULL) return NULL;
-    if(chan->buds == NULL) return NULL;
-    bl00mbox_bud_t * bud = chan->buds;
-    while(true){
-        if(bud->index == index) break;
-        bud = bud->chan_next;
-        if(bud == NULL) break;
+    if(chan == NULL) return false;
+    if(chan->render_list_hold) return true;
+    if(channel == bounce_channel) return false;
+    uint16_t num_buds = bl00mbox_channel_buds_num(channel);
+    uint16_t num_roots = bl00mbox_channel_mixer_num(channel);
+    uint32_t num_inputs = 0;
+    for(bl00mbox_bud_t * bud = chan->buds; bud != NULL; bud = bud->chan_next){
+        for(uint16_t j = 0; j < bud->plugin->len_signals; j++){
+            radspa_signal_t * sig = bl00mbox_signal_get_by_index(bud->plugin, j);
+            if(sig->hints & RADSPA_SIGNAL_HINT_INPUT) num_inputs++;
+        }
     }
-    return bud;
+
+    bl00mbox_render_list_t * list = NULL;
+    if(num_buds && num_roots){
+        list = malloc(sizeof(bl00mbox_render_list_t) + num_buds * sizeof(bl00mbox_bud_t *)
+                        + num_roots * sizeof(int16_t *)
+                        + num_inputs * (sizeof(bl00mbox_render_input_t) + sizeof(int16_t))
+                        + (num_buds + 1) * sizeof(uint16_t) + (num_buds + num_roots) * sizeof(uint8_t));
+        bl00mbox_bud_t ** buds = malloc(num_buds * sizeof(bl00mbox_bud_t *));
+        // depth first search state: 0: unvisited, 1: on stack, 2: done
+        uint8_t * state = calloc(num_buds, sizeof(uint8_t));
+        uint16_t * stack = malloc(num_buds * sizeof(uint16_t));
+        uint16_t * stack_signal = malloc(num_buds * sizeof(uint16_t));
+        if(list == NULL || buds == NULL || state == NULL || stack == NULL || stack_signal == NULL){
+            free(list);
+            free(buds);
+            free(state);
+            free(stack);
+            free(stack_signal);
+            return false;
+        }
+
+        bl00mbox_bud_t * bud = chan->buds;
+        for(uint16_t i = 0; i < num_buds; i++){
+            buds[i] = bud;
+            bud = bud->chan_next;
+        }
+
+        list->len = 0;
+        list->num_roots = 0;
+        list->roots = (int16_t **) &(list->buds[num_buds]);
+        list->inputs = (bl00mbox_render_input_t *) &(list->roots[num_roots]);
+        list->inputs_start = (uint16_t *) &(list->inputs[num_inputs]);
+        list->idle_values = (int16_t *) &(list->inputs_start[num_buds + 1]);
+        list->state = (uint8_t *) &(list->idle_values[num_inputs]);
+        list->root_sides = &(list->state[num_buds]);
+        list->stereo = false;
+        bl00mbox_channel_root_t * root = chan->root_list;
+        while(root != NULL){
+            if(root->sides != BL00MBOX_MIXER_STEREO) list->stereo = true;
+            list->root_sides[list->num_roots] = root->sides;
+            list->roots[list->num_roots++] = root->con->buffer;
+            int32_t start = render_list_find(buds, num_buds, root->con->source_bud);
+            root = root->next;
+            if(start < 0 || state[start]) continue;
+            uint16_t depth = 0;
+            stack[depth] = start;
+            stack_signal[depth] = 0;
+            state[start] = 1;
+            while(true){
+                radspa_t * plugin = buds[stack[depth]]->plugin;
+                int32_t next = -1;
+                while(stack_signal[depth] < plugin->len_signals){
+                    uint16_t j = stack_signal[depth]++;
+                    radspa_signal_t * sig = bl00mbox_signal_get_by_index(plugin, j);
+                    if(!(sig->hints & RADSPA_SIGNAL_HINT_INPUT)) continue;
+                    bl00mbox_connection_t * conn = bl00mbox_bud_get_connection(buds[stack[depth]], j);
+                    if(conn == NULL) continue;
+                    next = render_list_find(buds, num_buds, conn->source_bud);
+                    if(next >= 0 && !state[next]) break;
+                    next = -1; // already sorted or feedback loop
+                }
+                if(next >= 0){
+                    depth++;
+                    stack[depth] = next;
+                    stack_signal[depth] = 0;
+                    state[next] = 1;
+                } else {
+                    // all sources are in the list, append self
+                    state[stack[depth]] = 2;
+                    list->buds[list->len++] = buds[stack[depth]];
+                    if(!depth) break;
+                    depth--;
+                }
+            }
+        }
+        free(buds);
+        free(state);
+        free(stack);
+        free(stack_signal);
+
+        // the audio task needs to know who reads from whom to figure out which buds it may skip.
+        // buds that feed the mixer are always needed. a source that doesn't come before its
+        // reader closes a feedback loop, these are always rendered too so that they don't end
+        // up seeing data from the wrong buffer.
+        memset(list->state, 0, list->len);
+        uint16_t num = 0;
+        for(uint16_t i = 0; i < list->len; i++){
+            radspa_t * plugin = list->buds[i]->plugin;
+            list->inputs_start[i] = num;
+            for(uint16_t j = 0; j < plugin->len_signals; j++){
+                radspa_signal_t * sig = bl00mbox_signal_get_by_index(plugin, j);
+                if(!(sig->hints & RADSPA_SIGNAL_HINT_INPUT)) continue;
+                list->inputs[num].signal = j;
+                list->inputs[num].source = BL00MBOX_RENDER_NO_SOURCE;
+                bl00mbox_connection_t * conn = bl00mbox_bud_get_connection(list->buds[i], j);
+                if(conn != NULL){
+                    int32_t source = render_list_find(list->buds, list->len, conn->source_bud);
+                    if(source >= i){
+                        list->state[i] |= BL00MBOX_RENDER_PINNED;
+                        list->state[source] |= BL00MBOX_RENDER_PINNED;
+                    } else if(source >= 0){
+                        list->inputs[num].source = source;
+                    }
+                }
+                num++;
+            }
+        }
+        list->inputs_start[list->len] = num;
+        for(root = chan->root_list; root != NULL; root = root->next){
+            int32_t source = render_list_find(list->buds, list->len, root->con->source_bud);
+            if(source >= 0) list->state[source] |= BL00MBOX_RENDER_PINNED;
+        }
+
+        if(!list->len){
+            free(list);
+            list = NULL;
+        }
+    }
+
+    // skip the round trip to the audio task if nothing changed
+    bl00mbox_render_list_t * old = chan->render_list_latest;
+    if(old == NULL && list == NULL) return true;
+    if(old != NULL && list != NULL && render_list_equal(old, list)){
+        free(list);
+        return true;
+    }
+    if(!bl00mbox_audio_queue_pointer_change((void **) &(chan->render_list), list)){
+        free(list);
+        return false;
+    }
+    chan->render_list_latest = list;
+    bl00mbox_audio_queue_free(old);
+    return true;
+}
+
+bool bl00mbox_channel_hold_render_list(uint8_t channel, bool hold){
+    /// while held the audio task keeps rendering the graph as it was before, so that many
+    /// changes in a row only rebuild the render list once when the hold is released. buds and
+    /// connections that were already rendered must not be deleted while held.
+    bl00mbox_channel_t * chan = bl00mbox_get_channel(channel);
+    if(chan == NULL) return false;
+    if(chan->render_list_hold == hold) return true;
+    chan->render_list_hold = hold;
+    if(hold) return true;
+    return bl00mbox_channel_rebuild_render_list(channel);
 }
 
 bl00mbox_bud_t * bl00mbox_channel_new_bud(uint8_t channel, uint32_t id, uint32_t init_var){
@@ -267,20 +527,29 @@ bl00mbox_bud_t * bl00mbox_channel_new_bud(uint8_t channel, uint32_t id, uint32_t
     /// the bud if successfull, else NULL.
     bl00mbox_channel_t * chan = bl00mbox_get_channel(channel);
     if(chan == NULL) return NULL;
+    if(channel == bounce_channel) return NULL;
     radspa_descriptor_t * desc = bl00mbox_plugin_registry_get_descriptor_from_id(id);
     if(desc == NULL) return NULL;
-    bl00mbox_bud_t * bud = malloc(sizeof(bl00mbox_bud_t));
-    if(bud == NULL) return NULL;
     radspa_t * plugin = desc->create_plugin_instance(init_var);
-    if(plugin == NULL){ free(bud); return NULL; }
+    if(plugin == NULL) return NULL;
+    bl00mbox_bud_t * bud = calloc(1, sizeof(bl00mbox_bud_t) + plugin->len_signals * sizeof(bl00mbox_connection_t *));
+    if(bud == NULL){
+        desc->destroy_plugin_instance(plugin);
+        return NULL;
+    }
 
     bud->init_var = init_var;
     bud->plugin = plugin;
     bud->channel = channel;
     bud->is_being_rendered = false;
-    //TODO: look for empty indices? maybe?
-    bud->index = bl00mbox_bud_index;
-    bl00mbox_bud_index++;
+    memset(&(bud->cycles), 0, sizeof(bl00mbox_cycles_t));
+    bud->sample = NULL;
+    bud->index = bud_slot_acquire(bud);
+    if(!bud->index){
+        desc->destroy_plugin_instance(plugin);
+        free(bud);
+        return NULL;
+    }
     bud->chan_next = NULL;
 
     // append to channel bud list
@@ -309,7 +578,6 @@ bool bl00mbox_channel_delete_bud(uint8_t channel, uint32_t bud_index){
 
     // pop from channel bud list
     bl00mbox_bud_t * seek = chan->buds;
-    bool free_later = false;
     if(chan->buds != NULL){
         bl00mbox_bud_t * prev = NULL;
         while(seek != NULL){
@@ -321,16 +589,20 @@ bool bl00mbox_channel_delete_bud(uint8_t channel, uint32_t bud_index){
         }
         if(seek != NULL){
             if(prev != NULL){
-                bl00mbox_audio_waitfor_pointer_change(&(prev->chan_next), seek->chan_next);
+                prev->chan_next = seek->chan_next;
             } else {
-                bl00mbox_audio_waitfor_pointer_change(&(chan->buds), seek->chan_next);
+                chan->buds = seek->chan_next;
             }
-            free_later = true;
         }
     }
-
-    bud->plugin->descriptor->destroy_plugin_instance(bud->plugin);
-    if(free_later) free(seek);
+    bud_slot_release(bud_index);
+
+    // all connections are gone, make sure the audio task doesn't hold on to it either
+    // before it is destroyed
+    bl00mbox_channel_rebuild_render_list(channel);
+    bl00mbox_audio_queue_plugin_destroy(bud->plugin);
+    bl00mbox_sample_pool_put(bud->sample);
+    bl00mbox_audio_queue_free(bud);
     return true;
 }
 
@@ -347,8 +619,17 @@ bool bl00mbox_channel_clear(uint8_t channel){
 }
 
 bool bl00mbox_channel_connect_signal_to_output_mixer(uint8_t channel, uint32_t bud_index, uint32_t bud_signal_index){
+    return bl00mbox_channel_connect_signal_to_output_mixer_sides(channel, bud_index, bud_signal_index, BL00MBOX_MIXER_STEREO);
+}
+
+bool bl00mbox_channel_connect_signal_to_output_mixer_sides(uint8_t channel, uint32_t bud_index, uint32_t bud_signal_index,
+                uint8_t sides){
+    /// connects to the given BL00MBOX_MIXER_* sides of the output mixer. if the signal already
+    /// feeds the mixer only its sides are changed.
     bl00mbox_channel_t * chan = bl00mbox_get_channel(channel);
     if(chan == NULL) return false;
+    sides &= BL00MBOX_MIXER_STEREO;
+    if(!sides) return false;
     bl00mbox_bud_t * bud = bl00mbox_channel_get_bud_by_index(channel, bud_index);
     if(bud == NULL) return false;
     radspa_signal_t * tx = bl00mbox_signal_get_by_index(bud->plugin, bud_signal_index);
@@ -360,8 +641,8 @@ bool bl00mbox_channel_connect_signal_to_output_mixer(uint8_t channel, uint32_t b
     bl00mbox_connection_subscriber_t * sub = malloc(sizeof(bl00mbox_connection_subscriber_t));
     if(sub == NULL){ free(root); return false; }
 
-    bl00mbox_connection_t * conn;
-    if(tx->buffer == NULL){ // doesn't feed a buffer yet
+    bl00mbox_connection_t * conn = bud->conns[bud_signal_index];
+    if(conn == NULL){ // doesn't feed a buffer yet
         conn = create_connection(channel);
         if(conn == NULL){
             free(sub);
@@ -371,19 +652,26 @@ bool bl00mbox_channel_connect_signal_to_output_mixer(uint8_t channel, uint32_t b
         // set up new connection
         conn->signal_index = bud_signal_index;
         conn->source_bud = bud;
-        tx->buffer = conn->buffer;
+        bud_set_connection(bud, bud_signal_index, conn);
     } else {
-        conn = (bl00mbox_connection_t *) tx->buffer; // buffer sits on top of struct
         if(conn->subs != NULL){
             bl00mbox_connection_subscriber_t * seek = conn->subs;
             while(seek != NULL){
-                if(seek->type == 1){
-                    free(root);
-                    free(sub);
-                    return false;  // already connected
-                }
+                if(seek->type == 1) break;
                 seek = seek->next;
             }
+            if(seek != NULL){ // already connected
+                free(root);
+                free(sub);
+                bl00mbox_channel_root_t * rt = chan->root_list;
+                while(rt != NULL && rt->con != conn){ rt = rt->next; }
+                if(rt == NULL) return false;
+                if(rt->sides == sides) return true;
+                rt->sides = sides;
+                bl00mbox_channel_rebuild_render_list(channel);
+                bl00mbox_channel_event(channel);
+                return true;
+            }
         }
     }
 
@@ -400,6 +688,7 @@ bool bl00mbox_channel_connect_signal_to_output_mixer(uint8_t channel, uint32_t b
     }
 
     root->con = conn;
+    root->sides = sides;
     root->next = NULL;
 
     if(chan->root_list == NULL){
@@ -410,6 +699,7 @@ bool bl00mbox_channel_connect_signal_to_output_mixer(uint8_t channel, uint32_t b
         last_root->next = root;
     }
 
+    bl00mbox_channel_rebuild_render_list(channel);
     bl00mbox_channel_event(channel);
     return true;
 }
@@ -422,10 +712,9 @@ bool bl00mbox_channel_disconnect_signal_from_output_mixer(uint8_t channel, uint3
     if(bud == NULL) return false;
     radspa_signal_t * tx = bl00mbox_signal_get_by_index(bud->plugin, bud_signal_index);
     if(tx == NULL) return false;
-    if(tx->buffer == NULL) return false;
     if(!(tx->hints & RADSPA_SIGNAL_HINT_OUTPUT)) return false;
 
-    bl00mbox_connection_t * conn = (bl00mbox_connection_t *) tx->buffer; // buffer sits on top of struct
+    bl00mbox_connection_t * conn = bud->conns[bud_signal_index];
     if(conn == NULL) return false; //not connected
 
     bl00mbox_channel_root_t * rt = chan->root_list;
@@ -439,9 +728,9 @@ bool bl00mbox_channel_disconnect_signal_from_output_mixer(uint8_t channel, uint3
     if(rt == NULL) return false; // root doesn't exist
 
     if(rt_prev == NULL){
-        bl00mbox_audio_waitfor_pointer_change(&(chan->root_list), rt->next);
+        chan->root_list = rt->next;
     } else {
-        bl00mbox_audio_waitfor_pointer_change(&(rt_prev->next), rt->next);
+        rt_prev->next = rt->next;
     }
     free(rt);
 
@@ -457,15 +746,17 @@ bool bl00mbox_channel_disconnect_signal_from_output_mixer(uint8_t channel, uint3
         }
         if(seek != NULL){
             if(prev != NULL){
-                bl00mbox_audio_waitfor_pointer_change(&(prev->next), seek->next);
+                prev->next = seek->next;
             } else {
-                bl00mbox_audio_waitfor_pointer_change(&(conn->subs), seek->next);
+                conn->subs = seek->next;
             }
             free(seek);
         }
     }
 
-    weak_delete_connection(conn);
+    conn = weak_delete_connection(conn);
+    bl00mbox_channel_rebuild_render_list(channel);
+    bl00mbox_audio_queue_free(conn);
     bl00mbox_channel_event(channel);
     return true;
 }
@@ -476,10 +767,9 @@ bool bl00mbox_channel_disconnect_signal_rx(uint8_t channel, uint32_t bud_rx_inde
 
     radspa_signal_t * rx = bl00mbox_signal_get_by_index(bud_rx->plugin, bud_rx_signal_index);
     if(rx == NULL) return false; // signal index doesn't exist
-    if(rx->buffer ==  NULL) return false;
     if(!(rx->hints & RADSPA_SIGNAL_HINT_INPUT)) return false;
 
-    bl00mbox_connection_t * conn = (bl00mbox_connection_t *) rx->buffer; // buffer sits on top of struct
+    bl00mbox_connection_t * conn = bud_rx->conns[bud_rx_signal_index];
     if(conn == NULL) return false; //not connected
 
     bl00mbox_bud_t * bud_tx = conn->source_bud;
@@ -487,7 +777,7 @@ bool bl00mbox_channel_disconnect_signal_rx(uint8_t channel, uint32_t bud_rx_inde
     radspa_signal_t * tx = bl00mbox_signal_get_by_index(bud_tx->plugin, conn->signal_index);
     if(tx == NULL) return false; // signal index doesn't exist
 
-    bl00mbox_audio_waitfor_pointer_change(&(rx->buffer), NULL);
+    bud_set_connection(bud_rx, bud_rx_signal_index, NULL);
 
     if(conn->subs != NULL){
         bl00mbox_connection_subscriber_t * seek = conn->subs;
@@ -503,15 +793,17 @@ bool bl00mbox_channel_disconnect_signal_rx(uint8_t channel, uint32_t bud_rx_inde
         }
         if(seek != NULL){
             if(prev != NULL){
-                bl00mbox_audio_waitfor_pointer_change(&(prev->next), seek->next);
+                prev->next = seek->next;
             } else {
-                bl00mbox_audio_waitfor_pointer_change(&(conn->subs), seek->next);
+                conn->subs = seek->next;
             }
             free(seek);
         }
     }
 
-    weak_delete_connection(conn);
+    conn = weak_delete_connection(conn);
+    bl00mbox_channel_rebuild_render_list(channel);
+    bl00mbox_audio_queue_free(conn);
     bl00mbox_channel_event(channel);
     return true;
 }
@@ -522,10 +814,9 @@ bool bl00mbox_channel_disconnect_signal_tx(uint8_t channel, uint32_t bud_tx_inde
 
     radspa_signal_t * tx = bl00mbox_signal_get_by_index(bud_tx->plugin, bud_tx_signal_index);
     if(tx == NULL) return false; // signal index doesn't exist
-    if(tx->buffer ==  NULL) return false;
     if(!(tx->hints & RADSPA_SIGNAL_HINT_OUTPUT)) return false;
 
-    bl00mbox_connection_t * conn = (bl00mbox_connection_t *) tx->buffer; // buffer sits on top of struct
+    bl00mbox_connection_t * conn = bud_tx->conns[bud_tx_signal_index];
     if(conn == NULL) return false; //not connected
 
     while(conn->subs != NULL){
@@ -547,12 +838,12 @@ bool bl00mbox_channel_disconnect_signal(uint8_t channel, uint32_t bud_index, uin
     if(bud == NULL) return false; // bud index doesn't exist
     radspa_signal_t * sig = bl00mbox_signal_get_by_index(bud->plugin, signal_index);
     if(sig == NULL) return false; // signal index doesn't exist
-    if(sig->buffer ==  NULL) return false;
+    if(bud->conns[signal_index] == NULL) return false;
 
     bl00mbox_channel_disconnect_signal_rx(channel, bud_index, signal_index);
     bl00mbox_channel_disconnect_signal_tx(channel, bud_index, signal_index);
     bl00mbox_channel_disconnect_signal_from_output_mixer(channel, bud_index, signal_index);
-    if(sig->buffer ==  NULL) return true;
+    if(bud->conns[signal_index] == NULL) return true;
     return false;
 }
 
@@ -568,25 +859,25 @@ bool bl00mbox_channel_connect_signal(uint8_t channel, uint32_t bud_rx_index, uin
     if(!(rx->hints & RADSPA_SIGNAL_HINT_INPUT)) return false;
     if(!(tx->hints & RADSPA_SIGNAL_HINT_OUTPUT)) return false;
 
-    bl00mbox_connection_t * conn;
+    bl00mbox_connection_t * conn = bud_tx->conns[bud_tx_signal_index];
     bl00mbox_connection_subscriber_t * sub;
-    if(tx->buffer == NULL){ // doesn't feed a buffer yet
+    if(conn == NULL){ // doesn't feed a buffer yet
         conn = create_connection(channel);
         if(conn == NULL) return false; // no ram for connection
         // set up new connection
         conn->signal_index = bud_tx_signal_index;
         conn->source_bud = bud_tx;
-        tx->buffer = conn->buffer;
+        bud_set_connection(bud_tx, bud_tx_signal_index, conn);
     } else {
-        if(rx->buffer == tx->buffer) return false; // already connected
-        conn = (bl00mbox_connection_t *) tx->buffer; // buffer sits on top of struct
+        if(bud_rx->conns[bud_rx_signal_index] == conn) return false; // already connected
     }
 
     bl00mbox_channel_disconnect_signal_rx(channel, bud_rx_index, bud_rx_signal_index);
 
     sub = malloc(sizeof(bl00mbox_connection_subscriber_t));
     if(sub == NULL){
-        weak_delete_connection(conn);
+        // a new connection isn't in any render list yet
+        bl00mbox_audio_queue_free(weak_delete_connection(conn));
         return false;
     }
     sub->type = 0;
@@ -603,7 +894,8 @@ bool bl00mbox_channel_connect_signal(uint8_t channel, uint32_t bud_rx_index, uin
         seek->next = sub;
     }
 
-    rx->buffer = tx->buffer;
+    bud_set_connection(bud_rx, bud_rx_signal_index, conn);
+    bl00mbox_channel_rebuild_render_list(channel);
     bl00mbox_channel_event(channel);
     return true;
 }
@@ -651,6 +943,11 @@ uint32_t bl00mbox_channel_bud_get_init_var(uint8_t channel, uint32_t bud_index){
     return bud->init_var;
 }
 
+bool bl00mbox_channel_bud_get_cycles(uint8_t channel, uint32_t bud_index, uint32_t * min, uint32_t * avg, uint32_t * max){
+    bl00mbox_bud_t * bud = bl00mbox_channel_get_bud_by_index(channel, bud_index);
+    return bl00mbox_audio_cycles_get(bud == NULL ? NULL : &(bud->cycles), min, avg, max);
+}
+
 uint16_t bl00mbox_channel_bud_get_num_signals(uint8_t channel, uint32_t bud_index){
     bl00mbox_channel_t * chan = bl00mbox_get_channel(channel);
     if(chan == NULL) return false;
@@ -708,7 +1005,7 @@ bool bl00mbox_channel_bud_set_signal_value(uint8_t channel, uint32_t bud_index,
     if(sig == NULL) return false;
     while(bud->is_being_rendered) {};
 
-    if(value == -32678){
+    if(value == -32768){
         sig->value = -32767;
     } else {
         sig->value = value;
@@ -717,6 +1014,30 @@ bool bl00mbox_channel_bud_set_signal_value(uint8_t channel, uint32_t bud_index,
     return true;
 }
 
+bool bl00mbox_channel_bud_schedule_signal_value(uint8_t channel, uint32_t bud_index, uint32_t bud_signal_index,
+                int16_t value, uint32_t time, bool trigger){
+    /// like bl00mbox_channel_bud_set_signal_value, but the value changes at sample "time" of the
+    /// audio clock. with "trigger" set value is a trigger start velocity. returns false if the
+    /// signal isn't an input or too many events are pending.
+    bl00mbox_bud_t * bud = bl00mbox_channel_get_bud_by_index(channel, bud_index);
+    if(bud == NULL) return false;
+    radspa_signal_t * sig = bl00mbox_signal_get_by_index(bud->plugin, bud_signal_index);
+    if(sig == NULL) return false;
+    if(!(sig->hints & RADSPA_SIGNAL_HINT_INPUT)) return false;
+
+    bl00mbox_audio_event_t event = {
+        .time = time,
+        .plugin = bud->plugin,
+        .signal_index = bud_signal_index,
+        .value = value,
+        .trigger = trigger,
+        .channel = channel,
+    };
+    if(!bl00mbox_audio_queue_event(&event)) return false;
+    bl00mbox_channel_event(channel);
+    return true;
+}
+
 int16_t bl00mbox_channel_bud_get_signal_value(uint8_t channel, uint32_t bud_index, uint32_t bud_signal_index){
     bl00mbox_channel_t * chan = bl00mbox_get_channel(channel);
     if(chan == NULL) return -32768;
@@ -726,8 +1047,9 @@ int16_t bl00mbox_channel_bud_get_signal_value(uint8_t channel, uint32_t bud_inde
     if(sig == NULL) return -32768;
     while(bud->is_being_rendered) {};
 
-    if(sig->buffer != NULL){
-        return sig->buffer[0];
+    bl00mbox_connection_t * conn = bud->conns[bud_signal_index];
+    if(conn != NULL){
+        return conn->buffer[0];
     } else {
         return sig->value;
     }
@@ -784,3 +1106,126 @@ uint32_t bl00mbox_channel_bud_get_table_len(uint8_t channel, uint32_t bud_index)
     if(bud == NULL) return 0;
     return bud->plugin->plugin_table_len;
 }
+
+bool bl00mbox_channel_bud_load_wav(uint8_t channel, uint32_t bud_index, const char * path,
+                uint32_t table_offset, bool adpcm, uint32_t * num_frames, uint32_t * sample_rate){
+    /// reads a 16bit pcm wav file into the plugin table of the bud starting at table_offset,
+    /// multichannel files are reduced to their first channel. with adpcm set it is stored as ima
+    /// adpcm blocks, see sampler_adpcm.h. the file is cut short if it doesn't fit. num_frames and
+    /// sample_rate are set to what has been loaded.
+    bl00mbox_bud_t * bud = bl00mbox_channel_get_bud_by_index(channel, bud_index);
+    if(bud == NULL) return false;
+    radspa_t * plugin = bud->plugin;
+    if(plugin->plugin_table == NULL) return false;
+    if(table_offset > plugin->plugin_table_len) return false;
+    bl00mbox_wav_t wav;
+    FILE * file = bl00mbox_wav_open(path, &wav);
+    if(file == NULL) return false;
+    uint32_t len = plugin->plugin_table_len - table_offset;
+    if(adpcm) len = SAMPLER_ADPCM_CAPACITY(len);
+    if(len > wav.num_frames) len = wav.num_frames;
+    int16_t * dest = &(plugin->plugin_table[table_offset]);
+    if(adpcm){
+        (* num_frames) = bl00mbox_wav_read_adpcm(file, &wav, dest, len);
+    } else {
+        (* num_frames) = bl00mbox_wav_read_mono(file, &wav, dest, len);
+    }
+    (* sample_rate) = wav.sample_rate;
+    fclose(file);
+    return true;
+}
+
+bool bl00mbox_channel_bud_share_sample(uint8_t channel, uint32_t bud_index, const char * path,
+                bool adpcm, uint32_t * num_frames, uint32_t * sample_rate){
+    /// has a sampler bud play a wav file from the sample pool instead of its own table, loading
+    /// it if no other bud uses it yet. the bud can't record while it plays shared data, pass a
+    /// NULL path to go back to the table. adpcm picks the compressed copy of the file, see
+    /// bl00mbox_sample_pool_get. num_frames and sample_rate are set to the sample's.
+    bl00mbox_bud_t * bud = bl00mbox_channel_get_bud_by_index(channel, bud_index);
+    if(bud == NULL) return false;
+    if(bud->plugin->descriptor != &sampler_desc) return false;
+    bl00mbox_sample_t * sample = NULL;
+    if(path != NULL){
+        sample = bl00mbox_sample_pool_get(path, adpcm);
+        if(sample == NULL) return false;
+    }
+    sampler_data_t * data = bud->plugin->plugin_data;
+    if(!bl00mbox_audio_queue_pointer_change((void **) &(data->shared), sample == NULL ? NULL : &(sample->shared))){
+        bl00mbox_sample_pool_put(sample);
+        return false;
+    }
+    // the audio task may still be playing the old one until it sees the new one, which the
+    // pool takes care of
+    bl00mbox_sample_pool_put(bud->sample);
+    bud->sample = sample;
+    (* num_frames) = sample == NULL ? 0 : sample->shared.len;
+    (* sample_rate) = sample == NULL ? 0 : sample->sample_rate;
+    return true;
+}
+
+static bool bl00mbox_bud_set_stream(bl00mbox_bud_t * bud, bl00mbox_stream_t * stream){
+    if(bud->plugin->descriptor != &bl00mbox_stream_sampler_desc) return false;
+    bl00mbox_stream_sampler_data_t * data = bud->plugin->plugin_data;
+    if(!bl00mbox_audio_queue_pointer_change((void **) &(data->stream), stream)) return false;
+    bl00mbox_stream_t * old = data->stream_user;
+    data->stream_user = stream;
+    if(old != NULL){
+        // the audio task may still be playing from it until it sees the new one
+        bl00mbox_stream_release(old);
+        bl00mbox_audio_queue_free(old);
+    }
+    return true;
+}
+
+bool bl00mbox_channel_bud_stream_open(uint8_t channel, uint32_t bud_index, const char * path,
+                uint32_t read_ahead, uint32_t attack_len){
+    /// opens a wav file for a stream sampler bud, replacing the one it had open before. see
+    /// bl00mbox_stream_open for the arguments.
+    bl00mbox_bud_t * bud = bl00mbox_channel_get_bud_by_index(channel, bud_index);
+    if(bud == NULL) return false;
+    if(bud->plugin->descriptor != &bl00mbox_stream_sampler_desc) return false;
+    bl00mbox_stream_t * stream = bl00mbox_stream_open(path, read_ahead, attack_len);
+    if(stream == NULL) return false;
+    if(bl00mbox_bud_set_stream(bud, stream)) return true;
+    bl00mbox_stream_release(stream);
+    free(stream);
+    return false;
+}
+
+bool bl00mbox_channel_bud_stream_close(uint8_t channel, uint32_t bud_index){
+    bl00mbox_bud_t * bud = bl00mbox_channel_get_bud_by_index(channel, bud_index);
+    if(bud == NULL) return false;
+    return bl00mbox_bud_set_stream(bud, NULL);
+}
+
+bool bl00mbox_channel_bounce(uint8_t channel, uint8_t target_channel, uint32_t target_bud_index,
+                uint32_t table_offset, uint32_t num_samples){
+    /// renders num_samples of the channel's output mixer at full volume into the plugin table of
+    /// the target bud, starting at table_offset. runs in a background task, see
+    /// bl00mbox_channel_bounce_poll. neither the channel nor the target bud can be accessed
+    /// before the bounce is done, the channel is silent meanwhile.
+    if(bounce_channel >= 0) return false;
+    bl00mbox_channel_t * chan = bl00mbox_get_channel(channel);
+    if(chan == NULL) return false;
+    bl00mbox_bud_t * target = bl00mbox_channel_get_bud_by_index(target_channel, target_bud_index);
+    if(target == NULL) return false;
+    if(target->channel == channel) return false;
+    radspa_t * plugin = target->plugin;
+    if(plugin->plugin_table == NULL) return false;
+    if(table_offset > plugin->plugin_table_len) return false;
+    if(num_samples > plugin->plugin_table_len - table_offset) return false;
+
+    if(!bl00mbox_audio_bounce_start(chan, &(plugin->plugin_table[table_offset]), num_samples)) return false;
+    bounce_channel = channel;
+    bounce_target = target;
+    return true;
+}
+
+bool bl00mbox_channel_bounce_poll(uint32_t * progress){
+    /// returns true once no bounce is running anymore and makes the bounced channel and target
+    /// available again. progress is set to the number of samples rendered so far.
+    if(!bl00mbox_audio_bounce_poll(progress)) return false;
+    bounce_channel = -1;
+    bounce_target = NULL;
+    return true;
+}
@@ -0,0 +1,121 @@
+//SPDX-License-Identifier: CC0-1.0
+#include "bl00mbox_wav.h"
+#include "sampler_adpcm.h"
+#include <string.h>
+
+#define WAV_FORMAT_PCM 1
+#define WAV_FORMAT_EXTENSIBLE 0xFFFE
+#define WAV_MAX_CHANNELS 8
+
+static bool wav_get(FILE * file, uint32_t * val, uint8_t bytes){
+    uint8_t buf[4];
+    if(fread(buf, 1, bytes, file) != bytes) return false;
+    (* val) = 0;
+    for(uint8_t i = 0; i < bytes; i++){
+        (* val) |= ((uint32_t) buf[i]) << (8*i);
+    }
+    return true;
+}
+
+static bool wav_parse(FILE * file, bl00mbox_wav_t * wav){
+    char id[4];
+    uint32_t len;
+    if(fread(id, 1, 4, file) != 4 || memcmp(id, "RIFF", 4)) return false;
+    if(!wav_get(file, &len, 4)) return false;
+    if(fread(id, 1, 4, file) != 4 || memcmp(id, "WAVE", 4)) return false;
+
+    bool has_fmt = false;
+    while(true){
+        if(fread(id, 1, 4, file) != 4) return false;
+        if(!wav_get(file, &len, 4)) return false;
+        if(!memcmp(id, "fmt ", 4)){
+            uint32_t format, channels, rate, bits, skip;
+            if(len < 16) return false;
+            if(!wav_get(file, &format, 2)) return false;
+            if(!wav_get(file, &channels, 2)) return false;
+            if(!wav_get(file, &rate, 4)) return false;
+            if(!wav_get(file, &skip, 4)) return false; // byte rate
+            if(!wav_get(file, &skip, 2)) return false; // block align
+            if(!wav_get(file, &bits, 2)) return false;
+            if(format != WAV_FORMAT_PCM && format != WAV_FORMAT_EXTENSIBLE) return false;
+            if(bits != 16) return false;
+            if(channels == 0 || channels > WAV_MAX_CHANNELS || rate == 0) return false;
+            wav->num_channels = channels;
+            wav->sample_rate = rate;
+            has_fmt = true;
+            len -= 16;
+        } else if(!memcmp(id, "data", 4)){
+            if(!has_fmt) return false;
+            long start = ftell(file);
+            if(start < 0) return false;
+            // files that were cut short or written by streaming encoders may claim more data
+            // than there is
+            if(fseek(file, 0, SEEK_END)) return false;
+            long end = ftell(file);
+            if(end < start) return false;
+            if(len > (uint32_t) (end - start)) len = end - start;
+            wav->data_start = start;
+            wav->num_frames = len / (2 * wav->num_channels);
+            return !fseek(file, start, SEEK_SET);
+        }
+        // chunks are padded to even length
+        if(fseek(file, len + (len & 1), SEEK_CUR)) return false;
+    }
+}
+
+FILE * bl00mbox_wav_open(const char * path, bl00mbox_wav_t * wav){
+    FILE * file = fopen(path, "rb");
+    if(file == NULL) return NULL;
+    if(!wav_parse(file, wav)){
+        fclose(file);
+        return NULL;
+    }
+    return file;
+}
+
+bool bl00mbox_wav_seek(FILE * file, bl00mbox_wav_t * wav, uint32_t frame){
+    if(frame > wav->num_frames) return false;
+    long pos = wav->data_start + (long) frame * 2 * wav->num_channels;
+    return !fseek(file, pos, SEEK_SET);
+}
+
+uint32_t bl00mbox_wav_read_mono(FILE * file, bl00mbox_wav_t * wav, int16_t * dest, uint32_t num_frames){
+    uint16_t channels = wav->num_channels;
+    if(channels == 1) return fread(dest, 2, num_frames, file);
+    uint32_t ret = 0;
+    while(ret < num_frames){
+        // read as many whole frames as fit into what's left of dest and keep the first
+        // channel in place, so that large reads don't need a buffer of their own
+        int16_t buf[WAV_MAX_CHANNELS];
+        int16_t * frames = &(dest[ret]);
+        uint32_t len = (num_frames - ret) / channels;
+        if(!len){
+            frames = buf;
+            len = 1;
+        }
+        uint32_t read = fread(frames, 2 * channels, len, file);
+        for(uint32_t i = 0; i < read; i++){
+            dest[ret + i] = frames[i * channels];
+        }
+        ret += read;
+        if(read < len) break;
+    }
+    return ret;
+}
+
+uint32_t bl00mbox_wav_read_adpcm(FILE * file, bl00mbox_wav_t * wav, int16_t * dest, uint32_t num_frames){
+    int16_t pcm[SAMPLER_ADPCM_BLOCK_LEN];
+    uint8_t step_index = 0;
+    uint32_t ret = 0;
+    while(ret < num_frames){
+        uint32_t len = num_frames - ret;
+        if(len > SAMPLER_ADPCM_BLOCK_LEN) len = SAMPLER_ADPCM_BLOCK_LEN;
+        uint32_t read = bl00mbox_wav_read_mono(file, wav, pcm, len);
+        if(!read) break;
+        sampler_adpcm_encode_block(pcm, read, dest, &step_index);
+        dest += SAMPLER_ADPCM_BLOCK_WORDS;
+        ret += read;
+        if(read < len) break;
+    }
+    return ret;
+}
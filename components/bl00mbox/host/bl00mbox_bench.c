@@ -0,0 +1,184 @@
+//SPDX-License-Identifier: CC0-1.0
+// render cost benchmark. runs every plugin and patch case for a while and
+// reports nanoseconds per output sample on this machine. absolute numbers
+// don't translate to the badge, but relative changes between two runs do.
+//
+// a baseline written with -c can be passed to a later run with -b, the
+// benchmark then exits with 2 if any case got slower than the threshold.
+// -m renders channels on two threads, see bl00mbox_audio_set_multicore.
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "bl00mbox_host.h"
+
+#define MAX_REPEATS 32
+#define MAX_BASELINE 256
+
+typedef struct {
+    char name[48];
+    float ns_per_sample;
+} baseline_t;
+
+static baseline_t baseline[MAX_BASELINE];
+static uint16_t baseline_num = 0;
+
+static uint32_t seconds_per_repeat = 1;
+static uint32_t repeats = 5;
+static float threshold = 15;
+static const char * filter = NULL;
+static FILE * csv = NULL;
+static uint16_t regressions = 0;
+
+static bool load_baseline(const char * path){
+    FILE * f = fopen(path, "r");
+    if(f == NULL) return false;
+    char line[128];
+    while(fgets(line, sizeof(line), f) != NULL && baseline_num < MAX_BASELINE){
+        char kind[16];
+        baseline_t * b = &(baseline[baseline_num]);
+        if(sscanf(line, "%15[^,],%47[^,],%f", kind, b->name, &(b->ns_per_sample)) == 3){
+            baseline_num++;
+        }
+    }
+    fclose(f);
+    return true;
+}
+
+static baseline_t * find_baseline(const char * name){
+    for(uint16_t i = 0; i < baseline_num; i++){
+        if(!strcmp(baseline[i].name, name)) return &(baseline[i]);
+    }
+    return NULL;
+}
+
+static int compare_float(const void * a, const void * b){
+    float x = *(const float *) a;
+    float y = *(const float *) b;
+    return (x > y) - (x < y);
+}
+
+static void bench(bl00mbox_host_patch_t * patch, const char * kind){
+    if(filter != NULL && strstr(patch->name, filter) == NULL) return;
+    if(!bl00mbox_host_patch_start(patch)){
+        printf("  %-20s setup failed\n", patch->name);
+        regressions++;
+        return;
+    }
+
+    int16_t tx[BL00MBOX_HOST_BLOCK_LEN * 2];
+    uint32_t block = 0;
+    // warm up caches and get envelopes etc going
+    for(; block < BL00MBOX_HOST_BLOCKS_PER_SECOND / 4; block++){
+        bl00mbox_host_patch_render_block(patch, block, tx);
+    }
+
+    uint32_t blocks_per_repeat = seconds_per_repeat * BL00MBOX_HOST_BLOCKS_PER_SECOND;
+    float results[MAX_REPEATS];
+    for(uint32_t r = 0; r < repeats; r++){
+        uint64_t start = bl00mbox_host_time_ns();
+        for(uint32_t i = 0; i < blocks_per_repeat; i++, block++){
+            bl00mbox_host_patch_render_block(patch, block, tx);
+        }
+        uint64_t elapsed = bl00mbox_host_time_ns() - start;
+        results[r] = (float) elapsed / (blocks_per_repeat * BL00MBOX_HOST_BLOCK_LEN);
+    }
+    bl00mbox_host_patch_stop(patch);
+
+    qsort(results, repeats, sizeof(float), compare_float);
+    float median = results[repeats/2];
+    float min = results[0];
+    // fraction of the time between two samples at SAMPLE_RATE
+    float load = median * SAMPLE_RATE / 1e7;
+
+    printf("  %-20s %9.1f %9.1f %8.3f%%", patch->name, median, min, load);
+    baseline_t * b = find_baseline(patch->name);
+    if(b != NULL && b->ns_per_sample > 0){
+        float change = 100 * (median - b->ns_per_sample) / b->ns_per_sample;
+        printf(" %+7.1f%%", change);
+        if(change > threshold){
+            printf(" REGRESSION");
+            regressions++;
+        }
+    }
+    printf("\n");
+    if(csv != NULL) fprintf(csv, "%s,%s,%.2f,%.2f\n", kind, patch->name, median, min);
+}
+
+static void usage(const char * argv0){
+    fprintf(stderr, "usage: %s [-m] [-s seconds] [-r repeats] [-f filter] [-c out.csv] [-b baseline.csv] [-t percent]\n",
+            argv0);
+}
+
+int main(int argc, char ** argv){
+    const char * csv_path = NULL;
+    bool multicore = false;
+    int opt;
+    while((opt = getopt(argc, argv, "ms:r:f:c:b:t:h")) != -1){
+        switch(opt){
+            case 'm':
+                multicore = true;
+                break;
+            case 's':
+                seconds_per_repeat = atoi(optarg);
+                break;
+            case 'r':
+                repeats = atoi(optarg);
+                break;
+            case 'f':
+                filter = optarg;
+                break;
+            case 'c':
+                csv_path = optarg;
+                break;
+            case 'b':
+                if(!load_baseline(optarg)){
+                    perror(optarg);
+                    return 1;
+                }
+                break;
+            case 't':
+                threshold = atof(optarg);
+                break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    if(!seconds_per_repeat) seconds_per_repeat = 1;
+    if(!repeats) repeats = 1;
+    if(repeats > MAX_REPEATS) repeats = MAX_REPEATS;
+
+    if(csv_path != NULL){
+        csv = fopen(csv_path, "w");
+        if(csv == NULL){
+            perror(csv_path);
+            return 1;
+        }
+    }
+
+    bl00mbox_host_init();
+    if(multicore && !bl00mbox_audio_set_multicore(true)){
+        fprintf(stderr, "multicore rendering not available\n");
+        return 1;
+    }
+
+    printf("%u x %us per case, ns per sample (median/min), load at %dHz%s\n", repeats, seconds_per_repeat,
+            SAMPLE_RATE, multicore ? ", multicore" : "");
+    printf("[plugins]%17s %9s %9s\n", "median", "min", "load");
+    for(uint16_t i = 0; i < bl00mbox_host_plugin_cases_num; i++){
+        bench(&(bl00mbox_host_plugin_cases[i]), "plugin");
+    }
+    printf("[patches]\n");
+    for(uint16_t i = 0; i < bl00mbox_host_patch_cases_num; i++){
+        bench(&(bl00mbox_host_patch_cases[i]), "patch");
+    }
+
+    if(csv != NULL) fclose(csv);
+    if(regressions){
+        printf("%u case(s) failed or regressed by more than %.1f%%\n", regressions, threshold);
+        return 2;
+    }
+    return 0;
+}
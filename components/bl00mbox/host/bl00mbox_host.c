@@ -0,0 +1,248 @@
+//SPDX-License-Identifier: CC0-1.0
+#include "bl00mbox_host.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+
+#include "xoroshiro64star.h"
+#include "bl00mbox_stream.h"
+
+// stub for extern/xoroshiro64star.c: same generator, but seedable so that every
+// benchmark case sees the same random data regardless of the order it runs in.
+static uint32_t rng_state[2] = {420, 69};
+
+void bl00mbox_host_rng_seed(uint32_t seed){
+    rng_state[0] = 420 ^ seed;
+    rng_state[1] = 69;
+}
+
+static inline uint32_t rotl(const uint32_t x, int k){
+    return (x << k) | (x >> (32 - k));
+}
+
+uint32_t xoroshiro64star(void){
+    const uint32_t s0 = rng_state[0];
+    uint32_t s1 = rng_state[1];
+    const uint32_t result = s0 * 0x9E3779BB;
+
+    s1 ^= s0;
+    rng_state[0] = rotl(s0, 26) ^ s1 ^ (s1 << 9);
+    rng_state[1] = rotl(s1, 13);
+    return result;
+}
+
+// stand-in for the codec rx buffer that bl00mbox_line_in_interlaced points to
+// during rendering: two detuned sines so that line in fed plugins have
+// something nonconst to chew on. precomputed so that generating it doesn't
+// show up in the benchmark, one second is an integer number of blocks.
+static int16_t line_in[SAMPLE_RATE * 2];
+static uint32_t line_in_pos;
+
+static void line_in_init(){
+    for(uint32_t i = 0; i < SAMPLE_RATE; i++){
+        float t = (float) i / SAMPLE_RATE;
+        line_in[2*i] = 12000 * sinf(2 * M_PI * 220 * t);
+        line_in[2*i+1] = 12000 * sinf(2 * M_PI * 331 * t);
+    }
+}
+
+uint64_t bl00mbox_host_time_ns(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void bl00mbox_host_init(void){
+    bl00mbox_init();
+    line_in_init();
+    bl00mbox_channel_set_free(BL00MBOX_HOST_CHANNEL, false);
+}
+
+bl00mbox_host_patch_t * bl00mbox_host_patch_find(const char * name){
+    for(uint16_t i = 0; i < bl00mbox_host_patch_cases_num; i++){
+        if(!strcmp(bl00mbox_host_patch_cases[i].name, name)) return &(bl00mbox_host_patch_cases[i]);
+    }
+    for(uint16_t i = 0; i < bl00mbox_host_plugin_cases_num; i++){
+        if(!strcmp(bl00mbox_host_plugin_cases[i].name, name)) return &(bl00mbox_host_plugin_cases[i]);
+    }
+    return NULL;
+}
+
+static bool patch_setup(bl00mbox_host_patch_t * patch, uint8_t channel){
+    patch->channel = channel;
+    patch->num_buds = 0;
+    bl00mbox_channel_clear(patch->channel);
+    if(!patch->setup(patch)){
+        bl00mbox_channel_clear(patch->channel);
+        return false;
+    }
+    bl00mbox_channel_set_volume(patch->channel, BL00MBOX_DEFAULT_CHANNEL_VOLUME);
+    bl00mbox_channel_enable(patch->channel);
+    return true;
+}
+
+bool bl00mbox_host_patch_start(bl00mbox_host_patch_t * patch){
+    bl00mbox_host_rng_seed(0);
+    line_in_pos = 0;
+    if(!patch_setup(patch, BL00MBOX_HOST_CHANNEL)) return false;
+    if(patch->background != NULL){
+        if(!patch_setup(patch->background, BL00MBOX_HOST_BACKGROUND_CHANNEL)){
+            bl00mbox_channel_clear(patch->channel);
+            return false;
+        }
+        bl00mbox_channel_set_background_mute_override(patch->background->channel, true);
+    }
+    bl00mbox_channel_set_foreground_index(patch->channel);
+    return true;
+}
+
+void bl00mbox_host_patch_stop(bl00mbox_host_patch_t * patch){
+    if(patch->background != NULL){
+        bl00mbox_channel_set_background_mute_override(patch->background->channel, false);
+        bl00mbox_host_patch_stop(patch->background);
+    }
+    bl00mbox_channel_clear(patch->channel);
+    patch->num_buds = 0;
+}
+
+void bl00mbox_host_patch_render_block(bl00mbox_host_patch_t * patch, uint32_t block, int16_t * tx){
+    if(patch->play != NULL) patch->play(patch, block);
+    if(patch->background != NULL && patch->background->play != NULL){
+        patch->background->play(patch->background, block);
+    }
+    // stands in for the prefetch task, which would make rendering depend on timing
+    bl00mbox_stream_prefetch();
+    bl00mbox_audio_render(&(line_in[2 * line_in_pos]), tx, BL00MBOX_HOST_BLOCK_LEN * 2);
+    line_in_pos += BL00MBOX_HOST_BLOCK_LEN;
+    if(line_in_pos >= SAMPLE_RATE) line_in_pos = 0;
+}
+
+uint32_t bl00mbox_host_new_bud(bl00mbox_host_patch_t * patch, uint32_t plugin_id, uint32_t init_var){
+    if(patch->num_buds >= BL00MBOX_HOST_PATCH_MAX_BUDS) return 0;
+    bl00mbox_bud_t * bud = bl00mbox_channel_new_bud(patch->channel, plugin_id, init_var);
+    if(bud == NULL) return 0;
+    patch->buds[patch->num_buds++] = bud->index;
+    return bud->index;
+}
+
+int32_t bl00mbox_host_signal_index(uint8_t channel, uint32_t bud, const char * signal){
+    uint16_t num_signals = bl00mbox_channel_bud_get_num_signals(channel, bud);
+    char name[64];
+    for(uint16_t i = 0; i < num_signals; i++){
+        char * base = bl00mbox_channel_bud_get_signal_name(channel, bud, i);
+        int8_t mpx = bl00mbox_channel_bud_get_signal_name_multiplex(channel, bud, i);
+        if(base == NULL) continue;
+        if(mpx >= 0){
+            snprintf(name, sizeof(name), "%s%d", base, mpx);
+        } else {
+            snprintf(name, sizeof(name), "%s", base);
+        }
+        if(!strcmp(name, signal)) return i;
+    }
+    return -1;
+}
+
+static int32_t signal_index_or_complain(bl00mbox_host_patch_t * patch, uint32_t bud, const char * signal){
+    int32_t ret = bl00mbox_host_signal_index(patch->channel, bud, signal);
+    if(ret < 0){
+        fprintf(stderr, "%s: bud %d (%s) has no signal \"%s\"\n", patch->name, (int) bud,
+                bl00mbox_channel_bud_get_name(patch->channel, bud), signal);
+    }
+    return ret;
+}
+
+bool bl00mbox_host_connect(bl00mbox_host_patch_t * patch, uint32_t bud_rx, const char * signal_rx,
+                                uint32_t bud_tx, const char * signal_tx){
+    int32_t rx = signal_index_or_complain(patch, bud_rx, signal_rx);
+    int32_t tx = signal_index_or_complain(patch, bud_tx, signal_tx);
+    if(rx < 0 || tx < 0) return false;
+    return bl00mbox_channel_connect_signal(patch->channel, bud_rx, rx, bud_tx, tx);
+}
+
+bool bl00mbox_host_connect_mixer(bl00mbox_host_patch_t * patch, uint32_t bud, const char * signal){
+    int32_t tx = signal_index_or_complain(patch, bud, signal);
+    if(tx < 0) return false;
+    return bl00mbox_channel_connect_signal_to_output_mixer(patch->channel, bud, tx);
+}
+
+bool bl00mbox_host_connect_mixer_sides(bl00mbox_host_patch_t * patch, uint32_t bud, const char * signal, uint8_t sides){
+    int32_t tx = signal_index_or_complain(patch, bud, signal);
+    if(tx < 0) return false;
+    return bl00mbox_channel_connect_signal_to_output_mixer_sides(patch->channel, bud, tx, sides);
+}
+
+bool bl00mbox_host_set(bl00mbox_host_patch_t * patch, uint32_t bud, const char * signal, int16_t value){
+    int32_t sig = signal_index_or_complain(patch, bud, signal);
+    if(sig < 0) return false;
+    return bl00mbox_channel_bud_set_signal_value(patch->channel, bud, sig, value);
+}
+
+void bl00mbox_host_trigger_start(bl00mbox_host_patch_t * patch, uint32_t bud, const char * signal, int16_t velocity){
+    int32_t sig = signal_index_or_complain(patch, bud, signal);
+    if(sig < 0) return;
+    if(velocity < 0) velocity = -velocity;
+    if(bl00mbox_channel_bud_get_signal_value(patch->channel, bud, sig) > 0) velocity = -velocity;
+    bl00mbox_channel_bud_set_signal_value(patch->channel, bud, sig, velocity);
+}
+
+void bl00mbox_host_trigger_stop(bl00mbox_host_patch_t * patch, uint32_t bud, const char * signal){
+    bl00mbox_host_set(patch, bud, signal, 0);
+}
+
+bool bl00mbox_host_schedule(bl00mbox_host_patch_t * patch, uint32_t bud, const char * signal, int16_t value,
+                                uint32_t time, bool trigger){
+    int32_t sig = signal_index_or_complain(patch, bud, signal);
+    if(sig < 0) return false;
+    return bl00mbox_channel_bud_schedule_signal_value(patch->channel, bud, sig, value, time, trigger);
+}
+
+static bool wav_put(FILE * f, uint32_t val, uint8_t bytes){
+    for(uint8_t i = 0; i < bytes; i++){
+        if(fputc((val >> (8*i)) & 0xFF, f) == EOF) return false;
+    }
+    return true;
+}
+
+static bool wav_header(bl00mbox_host_wav_t * wav){
+    uint32_t data_len = wav->num_frames * 4;
+    bool ret = true;
+    ret = ret && (fwrite("RIFF", 1, 4, wav->file) == 4);
+    ret = ret && wav_put(wav->file, 36 + data_len, 4);
+    ret = ret && (fwrite("WAVEfmt ", 1, 8, wav->file) == 8);
+    ret = ret && wav_put(wav->file, 16, 4); // fmt chunk len
+    ret = ret && wav_put(wav->file, 1, 2); // pcm
+    ret = ret && wav_put(wav->file, 2, 2); // stereo
+    ret = ret && wav_put(wav->file, SAMPLE_RATE, 4);
+    ret = ret && wav_put(wav->file, SAMPLE_RATE * 4, 4); // byte rate
+    ret = ret && wav_put(wav->file, 4, 2); // block align
+    ret = ret && wav_put(wav->file, 16, 2); // bits per sample
+    ret = ret && (fwrite("data", 1, 4, wav->file) == 4);
+    ret = ret && wav_put(wav->file, data_len, 4);
+    return ret;
+}
+
+bool bl00mbox_host_wav_open(bl00mbox_host_wav_t * wav, const char * path){
+    wav->file = fopen(path, "wb");
+    wav->num_frames = 0;
+    if(wav->file == NULL) return false;
+    // placeholder, lengths are filled in by bl00mbox_host_wav_close
+    return wav_header(wav);
+}
+
+bool bl00mbox_host_wav_write(bl00mbox_host_wav_t * wav, int16_t * interlaced, uint32_t num_frames){
+    for(uint32_t i = 0; i < 2 * num_frames; i++){
+        if(!wav_put(wav->file, (uint16_t) interlaced[i], 2)) return false;
+    }
+    wav->num_frames += num_frames;
+    return true;
+}
+
+bool bl00mbox_host_wav_close(bl00mbox_host_wav_t * wav){
+    bool ret = fseek(wav->file, 0, SEEK_SET) == 0;
+    ret = ret && wav_header(wav);
+    ret = (fclose(wav->file) == 0) && ret;
+    wav->file = NULL;
+    return ret;
+}
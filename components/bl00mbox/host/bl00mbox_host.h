@@ -0,0 +1,87 @@
+//SPDX-License-Identifier: CC0-1.0
+#pragma once
+
+// host-native harness for bl00mbox. lets us render patches offline and
+// measure render cost on a desktop machine instead of on the badge.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "bl00mbox.h"
+#include "bl00mbox_audio.h"
+#include "bl00mbox_user.h"
+#include "bl00mbox_snapshot.h"
+
+// same block size the st3m audio task uses, FLOW3R_BSP_AUDIO_DMA_BUFFER_SIZE
+#define BL00MBOX_HOST_BLOCK_LEN 64
+#define BL00MBOX_HOST_BLOCKS_PER_SECOND (SAMPLE_RATE/BL00MBOX_HOST_BLOCK_LEN)
+#define BL00MBOX_HOST_PATCH_MAX_BUDS 64
+// channel 0 is the system channel, keep out of its way
+#define BL00MBOX_HOST_CHANNEL 1
+// background layers run here with background mute override
+#define BL00MBOX_HOST_BACKGROUND_CHANNEL 2
+
+struct _bl00mbox_host_patch_t;
+
+typedef struct _bl00mbox_host_patch_t{
+    const char * name;
+    const char * description;
+    // creates and connects all buds in patch->channel. returns false on failure.
+    bool (* setup)(struct _bl00mbox_host_patch_t * patch);
+    // optional, called before each block to generate note events.
+    void (* play)(struct _bl00mbox_host_patch_t * patch, uint32_t block);
+    // optional, rendered in a second channel alongside this one
+    struct _bl00mbox_host_patch_t * background;
+    uint8_t channel;
+    uint8_t num_buds;
+    uint32_t buds[BL00MBOX_HOST_PATCH_MAX_BUDS];
+} bl00mbox_host_patch_t;
+
+// single plugins, fed from the line in test signal where they need audio
+extern bl00mbox_host_patch_t bl00mbox_host_plugin_cases[];
+extern const uint16_t bl00mbox_host_plugin_cases_num;
+// typical application patches
+extern bl00mbox_host_patch_t bl00mbox_host_patch_cases[];
+extern const uint16_t bl00mbox_host_patch_cases_num;
+
+bl00mbox_host_patch_t * bl00mbox_host_patch_find(const char * name);
+
+void bl00mbox_host_init(void);
+// resets rng and line in, (re)builds the patch. returns false on failure.
+bool bl00mbox_host_patch_start(bl00mbox_host_patch_t * patch);
+void bl00mbox_host_patch_stop(bl00mbox_host_patch_t * patch);
+// runs events and renders one block of BL00MBOX_HOST_BLOCK_LEN stereo samples
+// into tx (interlaced).
+void bl00mbox_host_patch_render_block(bl00mbox_host_patch_t * patch, uint32_t block, int16_t * tx);
+
+// patch building helpers, signals are referred to by name with the multiplex
+// index appended, i.e. "input3" for the fourth mixer input.
+uint32_t bl00mbox_host_new_bud(bl00mbox_host_patch_t * patch, uint32_t plugin_id, uint32_t init_var);
+int32_t bl00mbox_host_signal_index(uint8_t channel, uint32_t bud, const char * signal);
+bool bl00mbox_host_connect(bl00mbox_host_patch_t * patch, uint32_t bud_rx, const char * signal_rx,
+                                uint32_t bud_tx, const char * signal_tx);
+bool bl00mbox_host_connect_mixer(bl00mbox_host_patch_t * patch, uint32_t bud, const char * signal);
+// sides are BL00MBOX_MIXER_* bits
+bool bl00mbox_host_connect_mixer_sides(bl00mbox_host_patch_t * patch, uint32_t bud, const char * signal, uint8_t sides);
+bool bl00mbox_host_set(bl00mbox_host_patch_t * patch, uint32_t bud, const char * signal, int16_t value);
+// same semantics as SignalInputTriggerMixin.start/stop in _user.py
+void bl00mbox_host_trigger_start(bl00mbox_host_patch_t * patch, uint32_t bud, const char * signal, int16_t velocity);
+void bl00mbox_host_trigger_stop(bl00mbox_host_patch_t * patch, uint32_t bud, const char * signal);
+// timestamped version of bl00mbox_host_set, time is in samples of bl00mbox_audio_get_clock.
+// with trigger set value is a trigger start velocity.
+bool bl00mbox_host_schedule(bl00mbox_host_patch_t * patch, uint32_t bud, const char * signal, int16_t value,
+                                uint32_t time, bool trigger);
+
+void bl00mbox_host_rng_seed(uint32_t seed);
+uint64_t bl00mbox_host_time_ns(void);
+
+typedef struct {
+    FILE * file;
+    uint32_t num_frames;
+} bl00mbox_host_wav_t;
+
+// 16bit stereo pcm at SAMPLE_RATE
+bool bl00mbox_host_wav_open(bl00mbox_host_wav_t * wav, const char * path);
+bool bl00mbox_host_wav_write(bl00mbox_host_wav_t * wav, int16_t * interlaced, uint32_t num_frames);
+bool bl00mbox_host_wav_close(bl00mbox_host_wav_t * wav);
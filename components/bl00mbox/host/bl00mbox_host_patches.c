@@ -0,0 +1,905 @@
+//SPDX-License-Identifier: CC0-1.0
+#include "bl00mbox_host.h"
+
+#include <stdlib.h>
+#include <math.h>
+#include "sampler_adpcm.h"
+
+#define PLUGIN_NOISE 0
+#define PLUGIN_NOISE_BURST 7
+#define PLUGIN_SLEW_RATE_LIMITER 23
+#define PLUGIN_MIXER 21
+#define PLUGIN_PAN 22
+#define PLUGIN_MULTIPITCH 37
+#define PLUGIN_ENV_ADSR 42
+#define PLUGIN_AMPLIVERTER 68
+#define PLUGIN_RANGE_SHIFTER 69
+#define PLUGIN_FLANGER 123
+#define PLUGIN_POLY_SQUEEZE 172
+#define PLUGIN_OSC 420
+#define PLUGIN_OSC_BANK 421
+#define PLUGIN_REVERB 3200
+#define PLUGIN_CONVOLUTION 3300
+#define PLUGIN_LINE_IN 4001
+#define PLUGIN_STREAM_SAMPLER 4002
+#define PLUGIN_OSC_FM 4202
+#define PLUGIN_DISTORTION 9000
+#define PLUGIN_DELAY_STATIC 42069
+#define PLUGIN_SEQUENCER 56709
+#define PLUGIN_FILTER 69420
+#define PLUGIN_SAMPLER 696969
+#define PLUGIN_LOWPASS 694202
+
+#define SCT_A440 18367
+#define SCT_SEMITONE 200
+#define BLOCKS_PER_BEAT (BL00MBOX_HOST_BLOCKS_PER_SECOND/4)
+
+// note pattern shared by all melodic cases, in semitones relative to A440
+static const int8_t melody[] = {-12, -5, 0, 3, 7, -2, 5, 10};
+#define MELODY_LEN (sizeof(melody)/sizeof(melody[0]))
+
+static int16_t melody_sct(uint32_t step){
+    return SCT_A440 + SCT_SEMITONE * melody[step % MELODY_LEN];
+}
+
+// shorthands, bail out of setup on the first failure
+#define NEW(var, id, init_var) \
+    uint32_t var = bl00mbox_host_new_bud(patch, id, init_var); \
+    if(!var) return false;
+#define CON(rx, rx_sig, tx, tx_sig) \
+    if(!bl00mbox_host_connect(patch, rx, rx_sig, tx, tx_sig)) return false;
+#define MIX(tx, tx_sig) \
+    if(!bl00mbox_host_connect_mixer(patch, tx, tx_sig)) return false;
+#define MIX_LEFT(tx, tx_sig) \
+    if(!bl00mbox_host_connect_mixer_sides(patch, tx, tx_sig, BL00MBOX_MIXER_LEFT)) return false;
+#define MIX_RIGHT(tx, tx_sig) \
+    if(!bl00mbox_host_connect_mixer_sides(patch, tx, tx_sig, BL00MBOX_MIXER_RIGHT)) return false;
+#define SET(bud, sig, val) \
+    if(!bl00mbox_host_set(patch, bud, sig, val)) return false;
+
+// by convention all single plugin cases keep the bud under test in buds[0],
+// optional line in in buds[1]. events go to buds[0].
+
+static bool with_line_in(bl00mbox_host_patch_t * patch, uint32_t id, uint32_t init_var, const char * input){
+    NEW(bud, id, init_var);
+    NEW(line_in, PLUGIN_LINE_IN, 0);
+    CON(bud, input, line_in, "left");
+    return true;
+}
+
+static void play_trigger(bl00mbox_host_patch_t * patch, uint32_t block, const char * trigger){
+    if(block % BLOCKS_PER_BEAT) return;
+    bl00mbox_host_trigger_start(patch, patch->buds[0], trigger, 32767);
+}
+
+static void play_trigger_and_release(bl00mbox_host_patch_t * patch, uint32_t block, const char * trigger){
+    if(block % BLOCKS_PER_BEAT == BLOCKS_PER_BEAT/2){
+        bl00mbox_host_trigger_stop(patch, patch->buds[0], trigger);
+    }
+    play_trigger(patch, block, trigger);
+}
+
+/* SINGLE PLUGIN CASES */
+
+static bool line_in_setup(bl00mbox_host_patch_t * patch){
+    NEW(line_in, PLUGIN_LINE_IN, 0);
+    MIX(line_in, "left");
+    return true;
+}
+
+static bool line_in_stereo_setup(bl00mbox_host_patch_t * patch){
+    NEW(line_in, PLUGIN_LINE_IN, 0);
+    MIX_LEFT(line_in, "left");
+    MIX_RIGHT(line_in, "right");
+    return true;
+}
+
+static bool noise_setup(bl00mbox_host_patch_t * patch){
+    NEW(noise, PLUGIN_NOISE, 0);
+    MIX(noise, "output");
+    return true;
+}
+
+static bool noise_burst_setup(bl00mbox_host_patch_t * patch){
+    NEW(noise_burst, PLUGIN_NOISE_BURST, 0);
+    SET(noise_burst, "length", 100);
+    MIX(noise_burst, "output");
+    return true;
+}
+
+static void noise_burst_play(bl00mbox_host_patch_t * patch, uint32_t block){
+    play_trigger(patch, block, "trigger");
+}
+
+// same as above but with sample accurate triggers every NOISE_BURST_EVENT_PERIOD samples, which
+// never falls on a block boundary. onsets are at multiples of the period counted from the first
+// sample of the case. like python would, events are scheduled a block ahead.
+#define NOISE_BURST_EVENT_PERIOD 6000
+static uint32_t noise_burst_events_start;
+
+static void noise_burst_events_play(bl00mbox_host_patch_t * patch, uint32_t block){
+    if(!block) noise_burst_events_start = bl00mbox_audio_get_clock();
+    uint32_t from = (block + 1) * BL00MBOX_HOST_BLOCK_LEN;
+    uint32_t to = from + BL00MBOX_HOST_BLOCK_LEN;
+    if(!block) from = 0;
+    uint32_t t = from + NOISE_BURST_EVENT_PERIOD - 1;
+    t -= t % NOISE_BURST_EVENT_PERIOD;
+    for(; t < to; t += NOISE_BURST_EVENT_PERIOD){
+        bl00mbox_host_schedule(patch, patch->buds[0], "trigger", 32767, noise_burst_events_start + t, true);
+    }
+}
+
+static bool osc_setup(bl00mbox_host_patch_t * patch){
+    NEW(osc, PLUGIN_OSC, 0);
+    MIX(osc, "output");
+    return true;
+}
+
+static bool osc_fm_in_setup(bl00mbox_host_patch_t * patch){
+    if(!with_line_in(patch, PLUGIN_OSC, 0, "fm")) return false;
+    MIX(patch->buds[0], "output");
+    return true;
+}
+
+static void osc_play(bl00mbox_host_patch_t * patch, uint32_t block){
+    if(block % BLOCKS_PER_BEAT) return;
+    bl00mbox_host_set(patch, patch->buds[0], "pitch", melody_sct(block / BLOCKS_PER_BEAT));
+}
+
+// pitch steps are smoothed out by a slew rate limiter that settles within a beat,
+// the osc sees nonconst pitch for a couple of blocks and then const pitch again
+static bool osc_glide_setup(bl00mbox_host_patch_t * patch){
+    NEW(slew, PLUGIN_SLEW_RATE_LIMITER, 0);
+    NEW(osc, PLUGIN_OSC, 0);
+    SET(slew, "slew_rate", 8);
+    CON(osc, "pitch", slew, "output");
+    MIX(osc, "output");
+    return true;
+}
+
+static void osc_glide_play(bl00mbox_host_patch_t * patch, uint32_t block){
+    if(block % BLOCKS_PER_BEAT) return;
+    bl00mbox_host_set(patch, patch->buds[0], "input", melody_sct(block / BLOCKS_PER_BEAT));
+}
+
+static bool osc_fm_setup(bl00mbox_host_patch_t * patch){
+    NEW(osc, PLUGIN_OSC_FM, 0);
+    MIX(osc, "output");
+    return true;
+}
+
+// the pitch input of buds[0] is swept by an lfo through a range shifter in buds[1] and
+// buds[2]. the lfo runs at audio rate so that the pitch input is nonconst all the time.
+#define VIBRATO_DEPTH 100
+static bool with_vibrato(bl00mbox_host_patch_t * patch, const char * pitch){
+    NEW(lfo, PLUGIN_OSC, 0);
+    NEW(range, PLUGIN_RANGE_SHIFTER, 0);
+    SET(lfo, "pitch", SCT_A440 - 2400 * 6);
+    SET(lfo, "speed", 32767);
+    CON(range, "input", lfo, "output");
+    CON(patch->buds[0], pitch, range, "output");
+    return true;
+}
+
+static void vibrato_set_center(bl00mbox_host_patch_t * patch, int16_t center){
+    bl00mbox_host_set(patch, patch->buds[2], "output_range0", center - VIBRATO_DEPTH);
+    bl00mbox_host_set(patch, patch->buds[2], "output_range1", center + VIBRATO_DEPTH);
+}
+
+static void vibrato_play(bl00mbox_host_patch_t * patch, uint32_t block){
+    if(block % BLOCKS_PER_BEAT) return;
+    vibrato_set_center(patch, melody_sct(block / BLOCKS_PER_BEAT));
+}
+
+static bool osc_vibrato_setup(bl00mbox_host_patch_t * patch){
+    if(!osc_setup(patch)) return false;
+    return with_vibrato(patch, "pitch");
+}
+
+static bool osc_fm_vibrato_setup(bl00mbox_host_patch_t * patch){
+    if(!osc_fm_setup(patch)) return false;
+    return with_vibrato(patch, "pitch");
+}
+
+// harmonic series on top of the melody for the additive cases, partial k at 1/k gain
+#define PARTIALS 16
+// py: [round(2400*math.log2(k)) for k in range(1, 17)]
+static const int16_t partial_sct[PARTIALS] = {
+    0, 2400, 3804, 4800, 5573, 6204, 6738, 7200, 7608, 7973, 8303, 8604, 8881, 9138, 9377, 9600
+};
+
+static bool osc_bank_setup(bl00mbox_host_patch_t * patch){
+    NEW(bank, PLUGIN_OSC_BANK, PARTIALS);
+    char name[16];
+    for(uint8_t k = 0; k < PARTIALS; k++){
+        snprintf(name, sizeof(name), "voice_gain%d", k);
+        SET(bank, name, 4096 / (k + 1));
+    }
+    MIX(bank, "output");
+    return true;
+}
+
+static void osc_bank_play(bl00mbox_host_patch_t * patch, uint32_t block){
+    if(block % BLOCKS_PER_BEAT) return;
+    char name[16];
+    for(uint8_t k = 0; k < PARTIALS; k++){
+        snprintf(name, sizeof(name), "pitch%d", k);
+        bl00mbox_host_set(patch, patch->buds[0], name, melody_sct(block / BLOCKS_PER_BEAT) + partial_sct[k]);
+    }
+}
+
+static bool env_adsr_setup(bl00mbox_host_patch_t * patch){
+    if(!with_line_in(patch, PLUGIN_ENV_ADSR, 0, "input")) return false;
+    MIX(patch->buds[0], "output");
+    return true;
+}
+
+static void env_adsr_play(bl00mbox_host_patch_t * patch, uint32_t block){
+    play_trigger_and_release(patch, block, "trigger");
+}
+
+static bool ampliverter_setup(bl00mbox_host_patch_t * patch){
+    if(!with_line_in(patch, PLUGIN_AMPLIVERTER, 0, "input")) return false;
+    SET(patch->buds[0], "gain", 16000);
+    MIX(patch->buds[0], "output");
+    return true;
+}
+
+static bool filter_setup(bl00mbox_host_patch_t * patch){
+    if(!with_line_in(patch, PLUGIN_FILTER, 0, "input")) return false;
+    MIX(patch->buds[0], "output");
+    return true;
+}
+
+static bool filter_mod_setup(bl00mbox_host_patch_t * patch){
+    if(!filter_setup(patch)) return false;
+    NEW(lfo, PLUGIN_OSC, 0);
+    NEW(range, PLUGIN_RANGE_SHIFTER, 0);
+    SET(lfo, "pitch", SCT_A440 - 2400 * 8);
+    CON(range, "input", lfo, "output");
+    SET(range, "output_range0", SCT_A440 - 2400);
+    SET(range, "output_range1", SCT_A440 + 2400);
+    CON(patch->buds[0], "cutoff", range, "output");
+    return true;
+}
+
+static bool lowpass_setup(bl00mbox_host_patch_t * patch){
+    if(!with_line_in(patch, PLUGIN_LOWPASS, 0, "input")) return false;
+    MIX(patch->buds[0], "output");
+    return true;
+}
+
+static bool delay_setup(bl00mbox_host_patch_t * patch){
+    if(!with_line_in(patch, PLUGIN_DELAY_STATIC, 500, "input")) return false;
+    MIX(patch->buds[0], "output");
+    return true;
+}
+
+static bool reverb_setup(bl00mbox_host_patch_t * patch){
+    if(!with_line_in(patch, PLUGIN_REVERB, 0, "input")) return false;
+    MIX(patch->buds[0], "output");
+    return true;
+}
+
+// a made up speaker cabinet: direct sound and three damped resonances, 40ms long
+#define CONVOLUTION_CASE_LEN (40 * SAMPLE_RATE / 1000)
+
+static bool convolution_setup(bl00mbox_host_patch_t * patch){
+    char path[256];
+    const char * tmp = getenv("TMPDIR");
+    snprintf(path, sizeof(path), "%s/bl00mbox_host_ir.wav", tmp == NULL ? "/tmp" : tmp);
+    bl00mbox_host_wav_t wav;
+    if(!bl00mbox_host_wav_open(&wav, path)) return false;
+    bool ret = true;
+    for(uint32_t i = 0; i < CONVOLUTION_CASE_LEN; i++){
+        float t = (float) i / SAMPLE_RATE;
+        float h = 0.3 * expf(-150 * t) * sinf(2 * M_PI * 110 * t)
+                + 0.2 * expf(-400 * t) * sinf(2 * M_PI * 1200 * t)
+                + 0.1 * expf(-900 * t) * sinf(2 * M_PI * 3100 * t);
+        if(!i) h += 0.5;
+        int16_t frame[2] = { 32767 * h, 0 };
+        ret = ret && bl00mbox_host_wav_write(&wav, frame, 1);
+    }
+    ret = bl00mbox_host_wav_close(&wav) && ret;
+    if(!ret) return false;
+
+    if(!with_line_in(patch, PLUGIN_CONVOLUTION, 0, "input")) return false;
+    uint32_t num_frames, sample_rate;
+    // see convolution.c for table layout
+    if(!bl00mbox_channel_bud_load_wav(patch->channel, patch->buds[0], path, 3, false, &num_frames, &sample_rate)) return false;
+    int16_t * table = bl00mbox_channel_bud_get_table_pointer(patch->channel, patch->buds[0]);
+    if(table == NULL) return false;
+    ((uint32_t *) table)[0] = num_frames;
+    table[2] = 1; // generation
+    MIX(patch->buds[0], "output");
+    return true;
+}
+
+static bool flanger_setup(bl00mbox_host_patch_t * patch){
+    if(!with_line_in(patch, PLUGIN_FLANGER, 0, "input")) return false;
+    SET(patch->buds[0], "decay", 1000);
+    MIX(patch->buds[0], "output");
+    return true;
+}
+
+// chorus: the delay time swept at audio rate around ~20ms
+static bool flanger_chorus_setup(bl00mbox_host_patch_t * patch){
+    if(!with_line_in(patch, PLUGIN_FLANGER, 0, "input")) return false;
+    NEW(lfo, PLUGIN_OSC, 0);
+    NEW(range, PLUGIN_RANGE_SHIFTER, 0);
+    SET(lfo, "pitch", SCT_A440 - 2400 * 8);
+    SET(lfo, "speed", 32767);
+    SET(range, "output_range0", SCT_A440 - 7530 - 300);
+    SET(range, "output_range1", SCT_A440 - 7530 + 300);
+    CON(range, "input", lfo, "output");
+    CON(patch->buds[0], "manual", range, "output");
+    SET(patch->buds[0], "resonance", 0);
+    MIX(patch->buds[0], "output");
+    return true;
+}
+
+static bool distortion_setup(bl00mbox_host_patch_t * patch){
+    if(!with_line_in(patch, PLUGIN_DISTORTION, 0, "input")) return false;
+    int16_t * table = bl00mbox_channel_bud_get_table_pointer(patch->channel, patch->buds[0]);
+    uint32_t table_len = bl00mbox_channel_bud_get_table_len(patch->channel, patch->buds[0]);
+    if(table == NULL) return false;
+    // soft-ish clipper, same shape as the fuzz patch with intensity 2
+    for(uint32_t i = 0; i < table_len; i++){
+        int32_t x = ((int32_t) i - 64) * 512;
+        if(x > 32767) x = 32767;
+        table[i] = x - ((x * ((x * x) >> 15)) >> 17);
+    }
+    MIX(patch->buds[0], "output");
+    return true;
+}
+
+static bool mixer_setup(bl00mbox_host_patch_t * patch){
+    NEW(mixer, PLUGIN_MIXER, 4);
+    NEW(line_in, PLUGIN_LINE_IN, 0);
+    CON(mixer, "input0", line_in, "left");
+    CON(mixer, "input1", line_in, "right");
+    CON(mixer, "input2", line_in, "mid");
+    MIX(mixer, "output");
+    return true;
+}
+
+// osc placed in the stereo field by a pan
+static bool pan_setup(bl00mbox_host_patch_t * patch){
+    NEW(pan, PLUGIN_PAN, 0);
+    NEW(osc, PLUGIN_OSC, 0);
+    CON(pan, "input", osc, "output");
+    MIX_LEFT(pan, "output_left");
+    MIX_RIGHT(pan, "output_right");
+    return true;
+}
+
+// jumps between 5 positions every beat, the pan ramps there over a block
+static void pan_play(bl00mbox_host_patch_t * patch, uint32_t block){
+    if(block % BLOCKS_PER_BEAT) return;
+    uint32_t beat = block / BLOCKS_PER_BEAT;
+    bl00mbox_host_set(patch, patch->buds[0], "pan", ((int32_t) (beat % 5) - 2) * 16383);
+    bl00mbox_host_set(patch, patch->buds[1], "pitch", melody_sct(beat));
+}
+
+// pan swept by a ~2Hz lfo, so it is nonconst all the time
+static bool pan_lfo_setup(bl00mbox_host_patch_t * patch){
+    if(!pan_setup(patch)) return false;
+    NEW(lfo, PLUGIN_OSC, 0);
+    SET(lfo, "pitch", SCT_A440 - 2400 * 8);
+    SET(lfo, "speed", 32767);
+    CON(patch->buds[0], "pan", lfo, "output");
+    return true;
+}
+
+static void pan_lfo_play(bl00mbox_host_patch_t * patch, uint32_t block){
+    if(block % BLOCKS_PER_BEAT) return;
+    bl00mbox_host_set(patch, patch->buds[1], "pitch", melody_sct(block / BLOCKS_PER_BEAT));
+}
+
+// input and output gains moved a little every block, like a fader in a python app. the
+// mixer ramps them over the block, so there must be no steps at block boundaries.
+static void mixer_fade_play(bl00mbox_host_patch_t * patch, uint32_t block){
+    int32_t pos = block % (2 * BLOCKS_PER_BEAT);
+    if(pos > BLOCKS_PER_BEAT) pos = 2 * BLOCKS_PER_BEAT - pos;
+    bl00mbox_host_set(patch, patch->buds[0], "input_gain0", 4096 * pos / BLOCKS_PER_BEAT);
+    if(block % BLOCKS_PER_BEAT) return;
+    bl00mbox_host_set(patch, patch->buds[0], "gain", (block / BLOCKS_PER_BEAT) & 1 ? 2048 : 1024);
+}
+
+static bool multipitch_setup(bl00mbox_host_patch_t * patch){
+    if(!with_line_in(patch, PLUGIN_MULTIPITCH, 4, "mod_in")) return false;
+    SET(patch->buds[0], "shift1", SCT_A440 + 700);
+    SET(patch->buds[0], "shift2", SCT_A440 + 1200);
+    MIX(patch->buds[0], "output0");
+    MIX(patch->buds[0], "output1");
+    return true;
+}
+
+static bool range_shifter_setup(bl00mbox_host_patch_t * patch){
+    if(!with_line_in(patch, PLUGIN_RANGE_SHIFTER, 0, "input")) return false;
+    SET(patch->buds[0], "output_range0", -1000);
+    SET(patch->buds[0], "output_range1", 1000);
+    MIX(patch->buds[0], "output");
+    return true;
+}
+
+static bool slew_rate_limiter_setup(bl00mbox_host_patch_t * patch){
+    if(!with_line_in(patch, PLUGIN_SLEW_RATE_LIMITER, 0, "input")) return false;
+    MIX(patch->buds[0], "output");
+    return true;
+}
+
+#define SAMPLER_CASE_LEN (SAMPLE_RATE/2)
+
+static int16_t sampler_case_pcm(uint32_t i){
+    int32_t env = 32767 - (int32_t) ((32767LL * i) / SAMPLER_CASE_LEN);
+    int32_t saw = (int16_t) (i * 300);
+    return (saw * env) >> 15;
+}
+
+static bool sampler_setup(bl00mbox_host_patch_t * patch){
+    NEW(sampler, PLUGIN_SAMPLER, SAMPLER_CASE_LEN);
+    int16_t * table = bl00mbox_channel_bud_get_table_pointer(patch->channel, sampler);
+    if(table == NULL) return false;
+    // see sampler.c for table layout
+    uint32_t * table32 = (uint32_t *) table;
+    int16_t * pcm = &(table[11]);
+    for(uint32_t i = 0; i < SAMPLER_CASE_LEN; i++){
+        pcm[i] = sampler_case_pcm(i);
+    }
+    table32[3] = SAMPLER_CASE_LEN; // sample length
+    table32[4] = SAMPLE_RATE; // sample rate
+    MIX(sampler, "playback_output");
+    return true;
+}
+
+static void sampler_play(bl00mbox_host_patch_t * patch, uint32_t block){
+    if(block % BLOCKS_PER_BEAT) return;
+    uint32_t step = block / BLOCKS_PER_BEAT;
+    // alternate between unity speed and resampling
+    bl00mbox_host_set(patch, patch->buds[0], "playback_speed", step & 1 ? melody_sct(step) : SCT_A440);
+    bl00mbox_host_trigger_start(patch, patch->buds[0], "playback_trigger", 32767);
+}
+
+static bool sampler_vibrato_setup(bl00mbox_host_patch_t * patch){
+    if(!sampler_setup(patch)) return false;
+    return with_vibrato(patch, "playback_speed");
+}
+
+static void sampler_vibrato_play(bl00mbox_host_patch_t * patch, uint32_t block){
+    if(block % BLOCKS_PER_BEAT) return;
+    uint32_t step = block / BLOCKS_PER_BEAT;
+    vibrato_set_center(patch, step & 1 ? melody_sct(step) : SCT_A440);
+    bl00mbox_host_trigger_start(patch, patch->buds[0], "playback_trigger", 32767);
+}
+
+// writes the sample of the sampler case to a file in $TMPDIR
+static bool sampler_case_write(char * path, size_t path_len){
+    const char * tmp = getenv("TMPDIR");
+    snprintf(path, path_len, "%s/bl00mbox_host_sampler.wav", tmp == NULL ? "/tmp" : tmp);
+    bl00mbox_host_wav_t wav;
+    if(!bl00mbox_host_wav_open(&wav, path)) return false;
+    bool ret = true;
+    for(uint32_t i = 0; i < SAMPLER_CASE_LEN; i++){
+        int16_t frame[2] = { sampler_case_pcm(i), 0 };
+        ret = ret && bl00mbox_host_wav_write(&wav, frame, 1);
+    }
+    return bl00mbox_host_wav_close(&wav) && ret;
+}
+
+// same as the sampler case, but the sample is loaded from a file into the sample pool and
+// played by a sampler without memory of its own
+static bool sampler_shared_setup(bl00mbox_host_patch_t * patch){
+    char path[256];
+    if(!sampler_case_write(path, sizeof(path))) return false;
+    NEW(sampler, PLUGIN_SAMPLER, 0);
+    uint32_t num_frames, sample_rate;
+    if(!bl00mbox_channel_bud_share_sample(patch->channel, sampler, path, false, &num_frames, &sample_rate)) return false;
+    // see sampler.c for table layout
+    uint32_t * table32 = (uint32_t *) bl00mbox_channel_bud_get_table_pointer(patch->channel, sampler);
+    if(table32 == NULL) return false;
+    table32[3] = num_frames; // sample length
+    table32[4] = sample_rate;
+    MIX(sampler, "playback_output");
+    return true;
+}
+
+// same as the sampler case, but the sample is stored as ima adpcm
+static bool sampler_adpcm_setup(bl00mbox_host_patch_t * patch){
+    char path[256];
+    if(!sampler_case_write(path, sizeof(path))) return false;
+    NEW(sampler, PLUGIN_SAMPLER, SAMPLER_ADPCM_WORDS(SAMPLER_CASE_LEN));
+    uint32_t num_frames, sample_rate;
+    if(!bl00mbox_channel_bud_load_wav(patch->channel, sampler, path, 11, true, &num_frames, &sample_rate)) return false;
+    // see sampler.c for table layout
+    int16_t * table = bl00mbox_channel_bud_get_table_pointer(patch->channel, sampler);
+    if(table == NULL) return false;
+    uint32_t * table32 = (uint32_t *) table;
+    table32[3] = num_frames; // sample length
+    table32[4] = sample_rate;
+    table[10] |= 1<<5; // adpcm
+    MIX(sampler, "playback_output");
+    return true;
+}
+
+// two seconds of a decaying saw that changes pitch every 1000 frames, written to a stereo file
+// and streamed with a ring much smaller than the file so that it wraps and refills all the time
+#define STREAM_SAMPLER_CASE_LEN (2 * SAMPLE_RATE)
+
+static bool stream_sampler_setup(bl00mbox_host_patch_t * patch){
+    char path[256];
+    const char * tmp = getenv("TMPDIR");
+    snprintf(path, sizeof(path), "%s/bl00mbox_host_stream.wav", tmp == NULL ? "/tmp" : tmp);
+    bl00mbox_host_wav_t wav;
+    if(!bl00mbox_host_wav_open(&wav, path)) return false;
+    bool ret = true;
+    for(uint32_t i = 0; i < STREAM_SAMPLER_CASE_LEN; i++){
+        int32_t env = 32767 - (int32_t) ((32767LL * i) / STREAM_SAMPLER_CASE_LEN);
+        int32_t saw = (int16_t) (i * (200 + 50 * ((i / 1000) % 7)));
+        int16_t frame[2] = { (saw * env) >> 15, 0 };
+        ret = ret && bl00mbox_host_wav_write(&wav, frame, 1);
+    }
+    ret = bl00mbox_host_wav_close(&wav) && ret;
+    if(!ret) return false;
+
+    NEW(sampler, PLUGIN_STREAM_SAMPLER, 0);
+    // see bl00mbox_stream_sampler.c for table layout
+    int16_t * table = bl00mbox_channel_bud_get_table_pointer(patch->channel, sampler);
+    if(table == NULL) return false;
+    table[8] = 1<<1; // loop
+    if(!bl00mbox_channel_bud_stream_open(patch->channel, sampler, path, 4096, 1024)) return false;
+    MIX(sampler, "playback_output");
+    return true;
+}
+
+#define SEQUENCER_CASE_TRACKS 4
+#define SEQUENCER_CASE_STEPS 16
+
+static bool sequencer_setup(bl00mbox_host_patch_t * patch){
+    NEW(seq, PLUGIN_SEQUENCER, SEQUENCER_CASE_TRACKS + (SEQUENCER_CASE_STEPS << 8));
+    int16_t * table = bl00mbox_channel_bud_get_table_pointer(patch->channel, seq);
+    if(table == NULL) return false;
+    for(uint8_t t = 0; t < SEQUENCER_CASE_TRACKS; t++){
+        int16_t * track = &(table[t * (SEQUENCER_CASE_STEPS + 1)]);
+        track[0] = -32767;
+        for(uint8_t s = 0; s < SEQUENCER_CASE_STEPS; s++){
+            track[s + 1] = ((s + t) % 3) ? 0 : 32767;
+        }
+    }
+    SET(seq, "bpm", 180);
+    for(uint8_t t = 0; t < SEQUENCER_CASE_TRACKS; t++){
+        char name[8];
+        snprintf(name, sizeof(name), "track%d", t);
+        MIX(seq, name);
+    }
+    return true;
+}
+
+#define POLY_SQUEEZE_CASE_VOICES 8
+
+static bool poly_squeeze_setup(bl00mbox_host_patch_t * patch){
+    NEW(poly, PLUGIN_POLY_SQUEEZE, POLY_SQUEEZE_CASE_VOICES + (POLY_SQUEEZE_CASE_VOICES << 8));
+    for(uint8_t v = 0; v < POLY_SQUEEZE_CASE_VOICES; v++){
+        char name[16];
+        snprintf(name, sizeof(name), "pitch_out%d", v);
+        MIX(poly, name);
+    }
+    return true;
+}
+
+// plays chords of 4 notes on 8 inputs, every other chord overlaps the previous
+static void play_chords(bl00mbox_host_patch_t * patch, uint32_t poly, uint32_t block){
+    if(block % BLOCKS_PER_BEAT) return;
+    uint32_t step = block / BLOCKS_PER_BEAT;
+    uint8_t offset = (step & 1) * 4;
+    char name[16];
+    for(uint8_t i = 0; i < 4; i++){
+        snprintf(name, sizeof(name), "trigger_in%d", (4 - offset + i) & 7);
+        bl00mbox_host_trigger_stop(patch, poly, name);
+        snprintf(name, sizeof(name), "pitch_in%d", offset + i);
+        bl00mbox_host_set(patch, poly, name, melody_sct(step + 2 * i));
+        snprintf(name, sizeof(name), "trigger_in%d", offset + i);
+        bl00mbox_host_trigger_start(patch, poly, name, 20000);
+    }
+}
+
+static void poly_squeeze_play(bl00mbox_host_patch_t * patch, uint32_t block){
+    play_chords(patch, patch->buds[0], block);
+}
+
+bl00mbox_host_patch_t bl00mbox_host_plugin_cases[] = {
+    { .name = "line_in", .description = "baseline for line in fed cases", .setup = line_in_setup },
+    { .name = "line_in_stereo", .description = "left and right on their own side of the mixer",
+        .setup = line_in_stereo_setup },
+    { .name = "noise", .setup = noise_setup },
+    { .name = "noise_burst", .setup = noise_burst_setup, .play = noise_burst_play },
+    { .name = "noise_burst_events", .description = "triggered by timestamped events between block boundaries",
+        .setup = noise_burst_setup, .play = noise_burst_events_play },
+    { .name = "osc", .description = "const pitch, changes every beat", .setup = osc_setup, .play = osc_play },
+    { .name = "osc_fm_in", .description = "osc with audio rate fm from line in", .setup = osc_fm_in_setup,
+        .play = osc_play },
+    { .name = "osc_glide", .description = "pitch through slew_rate_limiter", .setup = osc_glide_setup,
+        .play = osc_glide_play },
+    { .name = "osc_fm", .setup = osc_fm_setup, .play = osc_play },
+    { .name = "osc_vibrato", .description = "pitch swept by an audio rate lfo", .setup = osc_vibrato_setup,
+        .play = vibrato_play },
+    { .name = "osc_fm_vibrato", .description = "pitch swept by an audio rate lfo", .setup = osc_fm_vibrato_setup,
+        .play = vibrato_play },
+    { .name = "osc_bank", .description = "16 harmonic partials", .setup = osc_bank_setup, .play = osc_bank_play },
+    { .name = "env_adsr", .setup = env_adsr_setup, .play = env_adsr_play },
+    { .name = "ampliverter", .setup = ampliverter_setup },
+    { .name = "filter", .description = "const cutoff", .setup = filter_setup },
+    { .name = "filter_mod", .description = "cutoff swept by osc+range_shifter", .setup = filter_mod_setup },
+    { .name = "lowpass", .setup = lowpass_setup },
+    { .name = "delay_static", .setup = delay_setup },
+    { .name = "reverb", .setup = reverb_setup },
+    { .name = "convolution", .description = "line in through a 40ms impulse response", .setup = convolution_setup },
+    { .name = "flanger", .setup = flanger_setup },
+    { .name = "flanger_chorus", .description = "delay time swept by an audio rate lfo", .setup = flanger_chorus_setup },
+    { .name = "distortion", .setup = distortion_setup },
+    { .name = "mixer", .description = "4 inputs, 3 connected", .setup = mixer_setup },
+    { .name = "mixer_fade", .description = "gains changed every block", .setup = mixer_setup,
+        .play = mixer_fade_play },
+    { .name = "pan", .description = "osc panned to a new position every beat", .setup = pan_setup,
+        .play = pan_play },
+    { .name = "pan_lfo", .description = "osc panned by an lfo", .setup = pan_lfo_setup, .play = pan_lfo_play },
+    { .name = "multipitch", .setup = multipitch_setup },
+    { .name = "range_shifter", .setup = range_shifter_setup },
+    { .name = "slew_rate_limiter", .setup = slew_rate_limiter_setup },
+    { .name = "sampler", .setup = sampler_setup, .play = sampler_play },
+    { .name = "sampler_vibrato", .description = "playback speed swept by an audio rate lfo",
+        .setup = sampler_vibrato_setup, .play = sampler_vibrato_play },
+    { .name = "sampler_shared", .description = "sampler case played from the sample pool",
+        .setup = sampler_shared_setup, .play = sampler_play },
+    { .name = "sampler_adpcm", .description = "sampler case compressed to ima adpcm",
+        .setup = sampler_adpcm_setup, .play = sampler_play },
+    { .name = "stream_sampler", .description = "file streamed through a small ring, retriggered every beat",
+        .setup = stream_sampler_setup, .play = sampler_play },
+    { .name = "sequencer", .setup = sequencer_setup },
+    { .name = "poly_squeeze", .setup = poly_squeeze_setup, .play = poly_squeeze_play },
+};
+const uint16_t bl00mbox_host_plugin_cases_num = sizeof(bl00mbox_host_plugin_cases)/sizeof(bl00mbox_host_patch_t);
+
+/* PATCH CASES
+ * these mirror the patches in micropython/bl00mbox/_patches.py and what
+ * typical flow3r apps build.
+ */
+
+static bool tinysynth_setup(bl00mbox_host_patch_t * patch){
+    NEW(osc, PLUGIN_OSC_FM, 0);
+    NEW(env, PLUGIN_ENV_ADSR, 0);
+    NEW(amp, PLUGIN_AMPLIVERTER, 0);
+    CON(amp, "gain", env, "output");
+    CON(amp, "input", osc, "output");
+    SET(env, "decay", 500);
+    SET(env, "release", 100);
+    MIX(amp, "output");
+    return true;
+}
+
+static void tinysynth_play(bl00mbox_host_patch_t * patch, uint32_t block){
+    uint32_t osc = patch->buds[0];
+    uint32_t env = patch->buds[1];
+    if(block % BLOCKS_PER_BEAT == BLOCKS_PER_BEAT/2){
+        bl00mbox_host_trigger_stop(patch, env, "trigger");
+    } else if(!(block % BLOCKS_PER_BEAT)){
+        bl00mbox_host_set(patch, osc, "pitch", melody_sct(block / BLOCKS_PER_BEAT));
+        bl00mbox_host_trigger_start(patch, env, "trigger", 32767);
+    }
+}
+
+static bool karplus_strong_setup(bl00mbox_host_patch_t * patch){
+    NEW(noise, PLUGIN_NOISE_BURST, 0);
+    // allpass interpolation
+    NEW(flanger, PLUGIN_FLANGER, 1);
+    SET(noise, "length", 25);
+    SET(flanger, "resonance", 0);
+    SET(flanger, "decay", 1000);
+    SET(flanger, "manual", SCT_A440 - 2 * 2400);
+    CON(flanger, "input", noise, "output");
+    MIX(flanger, "output");
+    return true;
+}
+
+static void karplus_strong_play(bl00mbox_host_patch_t * patch, uint32_t block){
+    if(block % BLOCKS_PER_BEAT) return;
+    uint32_t noise = patch->buds[0];
+    uint32_t flanger = patch->buds[1];
+    bl00mbox_host_set(patch, flanger, "manual", melody_sct(block / BLOCKS_PER_BEAT) - 2400);
+    bl00mbox_host_trigger_start(patch, noise, "trigger", 32767);
+}
+
+#define SYNTH_VOICES 8
+
+static bool synth8_setup(bl00mbox_host_patch_t * patch){
+    NEW(poly, PLUGIN_POLY_SQUEEZE, SYNTH_VOICES + (SYNTH_VOICES << 8));
+    NEW(mixer, PLUGIN_MIXER, SYNTH_VOICES);
+    char name_a[16];
+    char name_b[16];
+    for(uint8_t v = 0; v < SYNTH_VOICES; v++){
+        NEW(osc, PLUGIN_OSC, 0);
+        NEW(env, PLUGIN_ENV_ADSR, 0);
+        NEW(filter, PLUGIN_FILTER, 0);
+        snprintf(name_a, sizeof(name_a), "pitch_out%d", v);
+        CON(osc, "pitch", poly, name_a);
+        snprintf(name_a, sizeof(name_a), "trigger_out%d", v);
+        CON(env, "trigger", poly, name_a);
+        CON(env, "input", osc, "output");
+        CON(filter, "input", env, "output");
+        SET(env, "release", 300);
+        SET(osc, "waveform", 20000);
+        SET(filter, "cutoff", SCT_A440 + 1200);
+        snprintf(name_b, sizeof(name_b), "input%d", v);
+        CON(mixer, name_b, filter, "output");
+    }
+    MIX(mixer, "output");
+    return true;
+}
+
+static void synth8_play(bl00mbox_host_patch_t * patch, uint32_t block){
+    play_chords(patch, patch->buds[0], block);
+}
+
+// synth8 torn down and rebuilt from a snapshot of itself, must render exactly like synth8
+static bool synth8_snapshot_setup(bl00mbox_host_patch_t * patch){
+    if(!synth8_setup(patch)) return false;
+    size_t len = bl00mbox_channel_snapshot_save(patch->channel, NULL, 0, true);
+    uint8_t * snapshot = malloc(len);
+    if(snapshot == NULL) return false;
+    bl00mbox_channel_snapshot_save(patch->channel, snapshot, len, true);
+    bl00mbox_channel_clear(patch->channel);
+    bool ret = bl00mbox_snapshot_get_num_buds(snapshot, len) == patch->num_buds;
+    ret = ret && bl00mbox_channel_snapshot_restore(patch->channel, snapshot, len, patch->buds);
+    free(snapshot);
+    return ret;
+}
+
+// chords on a larger voice pool, most voices are done with their release at any given time
+#define SPARSE_VOICES 16
+
+static bool synth16_sparse_setup(bl00mbox_host_patch_t * patch){
+    NEW(poly, PLUGIN_POLY_SQUEEZE, SPARSE_VOICES + (SYNTH_VOICES << 8));
+    NEW(mixer, PLUGIN_MIXER, SPARSE_VOICES);
+    char name_a[16];
+    char name_b[16];
+    for(uint8_t v = 0; v < SPARSE_VOICES; v++){
+        NEW(osc, PLUGIN_OSC, 0);
+        NEW(env, PLUGIN_ENV_ADSR, 0);
+        snprintf(name_a, sizeof(name_a), "pitch_out%d", v);
+        CON(osc, "pitch", poly, name_a);
+        snprintf(name_a, sizeof(name_a), "trigger_out%d", v);
+        CON(env, "trigger", poly, name_a);
+        CON(env, "input", osc, "output");
+        SET(env, "release", 100);
+        SET(osc, "waveform", 20000);
+        snprintf(name_b, sizeof(name_b), "input%d", v);
+        CON(mixer, name_b, env, "output");
+    }
+    MIX(mixer, "output");
+    return true;
+}
+
+// background layer: detuned saws through a slowly swept filter into a delay
+#define DRONE_VOICES 6
+
+static bool drone_setup(bl00mbox_host_patch_t * patch){
+    NEW(mixer, PLUGIN_MIXER, DRONE_VOICES);
+    NEW(filter, PLUGIN_FILTER, 0);
+    NEW(lfo, PLUGIN_OSC, 0);
+    NEW(range, PLUGIN_RANGE_SHIFTER, 0);
+    NEW(delay, PLUGIN_DELAY_STATIC, 1000);
+    char name[16];
+    for(uint8_t v = 0; v < DRONE_VOICES; v++){
+        NEW(osc, PLUGIN_OSC, 0);
+        SET(osc, "pitch", SCT_A440 - 2400 + 7 * SCT_SEMITONE * (v & 1) + 3 * v);
+        SET(osc, "waveform", 20000);
+        snprintf(name, sizeof(name), "input%d", v);
+        CON(mixer, name, osc, "output");
+    }
+    SET(lfo, "pitch", -10000);
+    SET(range, "output_range0", SCT_A440 - 1200);
+    SET(range, "output_range1", SCT_A440 + 1200);
+    CON(range, "input", lfo, "output");
+    CON(filter, "cutoff", range, "output");
+    CON(filter, "input", mixer, "output");
+    CON(delay, "input", filter, "output");
+    SET(delay, "time", 300);
+    SET(delay, "feedback", 16000);
+    MIX(delay, "output");
+    return true;
+}
+
+static bl00mbox_host_patch_t drone = { .name = "drone", .setup = drone_setup };
+
+// a second of the drone rendered offline into a sampler, which then replays it every beat. the
+// drone is built in the background channel only for the bounce and gone by the time we play.
+#define DRONE_BOUNCE_LEN SAMPLE_RATE
+
+static bool drone_bounced_setup(bl00mbox_host_patch_t * patch){
+    NEW(sampler, PLUGIN_SAMPLER, DRONE_BOUNCE_LEN);
+    MIX(sampler, "playback_output");
+    int16_t * table = bl00mbox_channel_bud_get_table_pointer(patch->channel, sampler);
+    if(table == NULL) return false;
+    uint32_t * table32 = (uint32_t *) table;
+    table32[3] = DRONE_BOUNCE_LEN; // sample length
+    table32[4] = SAMPLE_RATE; // sample rate
+
+    bl00mbox_host_patch_t source = { .name = "drone bounce source", .channel = BL00MBOX_HOST_BACKGROUND_CHANNEL };
+    bool ret = drone_setup(&source);
+    ret = ret && bl00mbox_channel_bounce(source.channel, patch->channel, sampler, 11, DRONE_BOUNCE_LEN);
+    uint32_t progress;
+    while(!bl00mbox_channel_bounce_poll(&progress)){};
+    bl00mbox_channel_clear(source.channel);
+    return ret;
+}
+
+static void drone_bounced_play(bl00mbox_host_patch_t * patch, uint32_t block){
+    if(block % BLOCKS_PER_BEAT) return;
+    bl00mbox_host_trigger_start(patch, patch->buds[0], "playback_trigger", 32767);
+}
+
+// parameter changes from python: apps like gay_drums set dozens of signals per tick on channels
+// with many buds. the ampliverters aren't connected so they cost nothing to render, what's left
+// is the cost of getting to the bud and its signal. python caches signal indices, so do we.
+static int32_t param_storm_gain = -1;
+
+static bool param_storm_setup(bl00mbox_host_patch_t * patch){
+    NEW(osc, PLUGIN_OSC, 0);
+    MIX(osc, "output");
+    while(patch->num_buds < BL00MBOX_HOST_PATCH_MAX_BUDS){
+        NEW(amp, PLUGIN_AMPLIVERTER, 0);
+    }
+    param_storm_gain = bl00mbox_host_signal_index(patch->channel, patch->buds[1], "gain");
+    return param_storm_gain >= 0;
+}
+
+static void param_storm_play(bl00mbox_host_patch_t * patch, uint32_t block){
+    for(uint8_t i = 1; i < patch->num_buds; i++){
+        bl00mbox_channel_bud_set_signal_value(patch->channel, patch->buds[i], param_storm_gain, block + i);
+    }
+}
+
+// same as the osc_bank case, but with an osc bud per partial like apps used to do it
+static bool additive16_setup(bl00mbox_host_patch_t * patch){
+    NEW(mixer, PLUGIN_MIXER, PARTIALS);
+    char name[16];
+    for(uint8_t k = 0; k < PARTIALS; k++){
+        NEW(osc, PLUGIN_OSC, 0);
+        SET(osc, "waveform", -32767);
+        snprintf(name, sizeof(name), "input%d", k);
+        CON(mixer, name, osc, "output");
+        snprintf(name, sizeof(name), "input_gain%d", k);
+        SET(mixer, name, 4096 / (k + 1));
+    }
+    MIX(mixer, "output");
+    return true;
+}
+
+static void additive16_play(bl00mbox_host_patch_t * patch, uint32_t block){
+    if(block % BLOCKS_PER_BEAT) return;
+    for(uint8_t k = 0; k < PARTIALS; k++){
+        bl00mbox_host_set(patch, patch->buds[k + 1], "pitch", melody_sct(block / BLOCKS_PER_BEAT) + partial_sct[k]);
+    }
+}
+
+bl00mbox_host_patch_t bl00mbox_host_patch_cases[] = {
+    { .name = "tinysynth", .description = "osc_fm + env_adsr + ampliverter", .setup = tinysynth_setup,
+        .play = tinysynth_play },
+    { .name = "karplus_strong", .description = "noise_burst into flanger", .setup = karplus_strong_setup,
+        .play = karplus_strong_play },
+    { .name = "synth8", .description = "8 voices of osc + env_adsr + filter, poly_squeeze and mixer",
+        .setup = synth8_setup, .play = synth8_play },
+    { .name = "synth8_snapshot", .description = "synth8 restored from a snapshot", .setup = synth8_snapshot_setup,
+        .play = synth8_play },
+    { .name = "synth16_sparse", .description = "16 voices of osc + env_adsr, most of them idle",
+        .setup = synth16_sparse_setup, .play = synth8_play },
+    { .name = "synth8_drone", .description = "synth8 in foreground, filtered saw drone in a background channel",
+        .setup = synth8_setup, .play = synth8_play, .background = &drone },
+    { .name = "drone_bounced", .description = "drone bounced into a sampler, replayed every beat",
+        .setup = drone_bounced_setup, .play = drone_bounced_play },
+    { .name = "additive16", .description = "16 osc + mixer, compare against osc_bank", .setup = additive16_setup,
+        .play = additive16_play },
+    { .name = "param_storm", .description = "signal values set on 63 buds every block",
+        .setup = param_storm_setup, .play = param_storm_play },
+};
+const uint16_t bl00mbox_host_patch_cases_num = sizeof(bl00mbox_host_patch_cases)/sizeof(bl00mbox_host_patch_t);
@@ -0,0 +1,137 @@
+//SPDX-License-Identifier: CC0-1.0
+// offline renderer: builds one of the host patches and renders it through
+// bl00mbox_audio_render into a stereo wav file.
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "bl00mbox_host.h"
+
+static void usage(const char * argv0){
+    fprintf(stderr, "usage: %s [-m] [-p] [-s seconds] [-o out.wav] patch\n", argv0);
+    fprintf(stderr, "       %s -l\n", argv0);
+}
+
+static void list(){
+    printf("[patches]\n");
+    for(uint16_t i = 0; i < bl00mbox_host_patch_cases_num; i++){
+        bl00mbox_host_patch_t * p = &(bl00mbox_host_patch_cases[i]);
+        printf("  %-20s %s\n", p->name, p->description ? p->description : "");
+    }
+    printf("[plugins]\n");
+    for(uint16_t i = 0; i < bl00mbox_host_plugin_cases_num; i++){
+        bl00mbox_host_patch_t * p = &(bl00mbox_host_plugin_cases[i]);
+        printf("  %-20s %s\n", p->name, p->description ? p->description : "");
+    }
+}
+
+static void print_cycles(const char * name, bool ok, uint32_t min, uint32_t avg, uint32_t max){
+    if(!ok) return;
+    printf("  %-20s %9u %9u %9u\n", name, min, avg, max);
+}
+
+static void profile(bl00mbox_host_patch_t * patch){
+    uint32_t min, avg, max;
+    bool ok = bl00mbox_channel_get_cycles(patch->channel, &min, &avg, &max);
+    printf("[channel %d] ns per block: %u available\n", patch->channel, bl00mbox_audio_get_cycles_per_block());
+    printf("  %-20s %9s %9s %9s\n", "", "min", "avg", "max");
+    print_cycles("total", ok, min, avg, max);
+    for(uint8_t i = 0; i < patch->num_buds; i++){
+        ok = bl00mbox_channel_bud_get_cycles(patch->channel, patch->buds[i], &min, &avg, &max);
+        char name[32];
+        snprintf(name, sizeof(name), "%s (%d)", bl00mbox_channel_bud_get_name(patch->channel, patch->buds[i]),
+                (int) patch->buds[i]);
+        print_cycles(name, ok, min, avg, max);
+    }
+}
+
+int main(int argc, char ** argv){
+    float seconds = 4;
+    const char * out_path = NULL;
+    bool multicore = false;
+    bool profiling = false;
+    int opt;
+    while((opt = getopt(argc, argv, "mps:o:lh")) != -1){
+        switch(opt){
+            case 'p':
+                profiling = true;
+                break;
+            case 'm':
+                multicore = true;
+                break;
+            case 's':
+                seconds = atof(optarg);
+                break;
+            case 'o':
+                out_path = optarg;
+                break;
+            case 'l':
+                list();
+                return 0;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    if(optind != argc - 1 || seconds <= 0){
+        usage(argv[0]);
+        return 1;
+    }
+
+    bl00mbox_host_init();
+    if(multicore && !bl00mbox_audio_set_multicore(true)){
+        fprintf(stderr, "multicore rendering not available\n");
+        return 1;
+    }
+    bl00mbox_host_patch_t * patch = bl00mbox_host_patch_find(argv[optind]);
+    if(patch == NULL){
+        fprintf(stderr, "unknown patch \"%s\", use -l to list\n", argv[optind]);
+        return 1;
+    }
+
+    char default_path[128];
+    if(out_path == NULL){
+        snprintf(default_path, sizeof(default_path), "%s.wav", patch->name);
+        out_path = default_path;
+    }
+
+    if(!bl00mbox_host_patch_start(patch)){
+        fprintf(stderr, "%s: setup failed\n", patch->name);
+        return 1;
+    }
+
+    bl00mbox_host_wav_t wav;
+    if(!bl00mbox_host_wav_open(&wav, out_path)){
+        perror(out_path);
+        return 1;
+    }
+
+    uint32_t num_blocks = seconds * BL00MBOX_HOST_BLOCKS_PER_SECOND;
+    int16_t tx[BL00MBOX_HOST_BLOCK_LEN * 2];
+    uint64_t render_time = 0;
+    for(uint32_t block = 0; block < num_blocks; block++){
+        uint64_t start = bl00mbox_host_time_ns();
+        bl00mbox_host_patch_render_block(patch, block, tx);
+        render_time += bl00mbox_host_time_ns() - start;
+        if(!bl00mbox_host_wav_write(&wav, tx, BL00MBOX_HOST_BLOCK_LEN)){
+            perror(out_path);
+            return 1;
+        }
+    }
+    if(!bl00mbox_host_wav_close(&wav)){
+        perror(out_path);
+        return 1;
+    }
+    if(profiling){
+        // stats cover the last full second
+        profile(patch);
+        if(patch->background != NULL) profile(patch->background);
+    }
+    bl00mbox_host_patch_stop(patch);
+
+    float rendered = (float) num_blocks / BL00MBOX_HOST_BLOCKS_PER_SECOND;
+    printf("%s: rendered %.2fs to %s in %.1fms (%.1fx realtime)\n", patch->name, rendered, out_path,
+            render_time / 1e6, rendered * 1e9 / render_time);
+    return 0;
+}
@@ -8,8 +8,17 @@
 #define BL00MBOX_BACKGROUND_MUTE_OVERRIDE_ENABLE
 #define BL00MBOX_AUTO_FOREGROUNDING
 #define BL00MBOX_LOOPS_ENABLE
+// allows rendering channels on both cores, off until bl00mbox_audio_set_multicore(true)
+#define BL00MBOX_MULTICORE_ENABLE
+// counts cpu cycles spent on each bud and channel
+#define BL00MBOX_PROFILING_ENABLE
+// skips buds that report being idle as well as buds that only idle buds listen to
+#define BL00MBOX_IDLE_SKIP_ENABLE
+// renders channels faster than realtime into plugin tables in a low priority task
+#define BL00MBOX_BOUNCE_ENABLE
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <math.h>
 #include <string.h>
 #include "radspa.h"
@@ -18,19 +27,37 @@
 struct _bl00mbox_bud_t;
 struct _bl00mbox_connection_source_t;
 struct _bl00mbox_channel_root_t;
+struct _bl00mbox_render_list_t;
 struct _bl00mbox_channel_t;
 
 extern int16_t * bl00mbox_line_in_interlaced;
 
+// render cost statistics, collected by the audio task in windows of about a second. the running
+// stats are handed over to the last_* fields once the first render of the next window comes in.
+typedef struct {
+    uint32_t window; // profiling window the running stats belong to
+    uint32_t count; // renders in window
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint32_t last_window;
+    uint32_t last_min;
+    uint32_t last_avg;
+    uint32_t last_max;
+} bl00mbox_cycles_t;
+
 typedef struct _bl00mbox_bud_t{
     radspa_t * plugin; // plugin
     char * name;
-    uint64_t index; // unique index number for bud
-    uint32_t render_pass_id; // may be used by host to determine whether recomputation is necessary
+    uint64_t index; // handle for bud, slot and generation in bl00mbox_user.c bud_slots
     uint32_t init_var; // init var that was used for plugin creation
     uint8_t channel; // index of channel that owns the plugin
     volatile bool is_being_rendered; // true if rendering the plugin is in progress, else false.
+    bl00mbox_cycles_t cycles; // cost of plugin render calls
+    struct _bl00mbox_sample_t * sample; // sample pool reference of sampler buds, user side only
     struct _bl00mbox_bud_t * chan_next; //for linked list in bl00mbox_channel_t
+    // connection of each signal as seen by the user side, signal buffers follow through the queue
+    struct _bl00mbox_connection_t * conns[];
 } bl00mbox_bud_t;
 
 typedef struct _bl00mbox_connection_subscriber_t{
@@ -50,21 +77,62 @@ typedef struct _bl00mbox_connection_t{ //child of bl00mbox_ll_t
     struct _bl00mbox_connection_t * chan_next; //for linked list in bl00mbox_channel_t;
 } bl00mbox_connection_t;
 
+// sides of the output mixer a root feeds. as long as all roots of a channel feed both sides
+// the channel is mixed once and copied to the other side.
+#define BL00MBOX_MIXER_LEFT (1<<0)
+#define BL00MBOX_MIXER_RIGHT (1<<1)
+#define BL00MBOX_MIXER_STEREO (BL00MBOX_MIXER_LEFT | BL00MBOX_MIXER_RIGHT)
+
 typedef struct _bl00mbox_channel_root_t{
     struct _bl00mbox_connection_t * con;
+    uint8_t sides; // BL00MBOX_MIXER_* bits
     struct _bl00mbox_channel_root_t * next;
 } bl00mbox_channel_root_t;
 
+#define BL00MBOX_RENDER_NO_SOURCE UINT16_MAX
+
+// render list state bits. PINNED is set when the list is built, the others belong to the audio task.
+#define BL00MBOX_RENDER_PINNED (1<<0) // feeds the output mixer or is part of a feedback loop
+#define BL00MBOX_RENDER_IDLE (1<<1) // plugin was idle at its last render, idle_values are valid
+#define BL00MBOX_RENDER_NEEDED (1<<2) // somebody listens to the bud in the current block
+#define BL00MBOX_RENDER_DEFERRED (1<<3) // not needed, hasn't been rendered in the current block
+#define BL00MBOX_RENDER_PULL (1<<4) // deferred but turned out to be needed after all
+
+typedef struct{
+    uint16_t signal; // input signal index
+    uint16_t source; // render list position of the bud that feeds the signal or BL00MBOX_RENDER_NO_SOURCE
+} bl00mbox_render_input_t;
+
+// everything the audio task needs to render a channel. changes to the graph build a new one,
+// only state and idle_values are modified after it has been handed over, and only by the audio
+// task. single allocation, all pointers point behind buds.
+typedef struct _bl00mbox_render_list_t{
+    uint16_t len;
+    uint16_t num_roots;
+    int16_t ** roots; // connection buffers that are summed by the output mixer
+    uint8_t * root_sides; // BL00MBOX_MIXER_* bits for each root
+    bool stereo; // some root only feeds one side of the mixer
+    bl00mbox_render_input_t * inputs; // all input signals of all buds, grouped by bud
+    uint16_t * inputs_start; // inputs of buds[i] are inputs[inputs_start[i]] to inputs[inputs_start[i+1]-1]
+    int16_t * idle_values; // input values at the last render that left the plugin idle, same indexing as inputs
+    uint8_t * state; // BL00MBOX_RENDER_* bits for each bud
+    struct _bl00mbox_bud_t * buds[]; // in render order: every bud comes after all buds it reads from
+} bl00mbox_render_list_t;
+
 typedef struct{
     bool is_active; // rendering can be skipped if false
     bool is_free;
     char * name;
     int32_t volume;
-    int32_t dc;
-    struct _bl00mbox_channel_root_t * root_list; // list of all roots associated with channels
+    int32_t dc[2]; // dc blocker state of the left and right side
+    struct _bl00mbox_channel_root_t * root_list; // list of all roots associated with channels, user side only
     uint32_t render_pass_id; // may be used by host to determine whether recomputation is necessary
-    struct _bl00mbox_bud_t * buds; // linked list with all channel buds
-    struct _bl00mbox_connection_t * connections; // linked list with all channel connections
+    struct _bl00mbox_bud_t * buds; // linked list with all channel buds, user side only
+    struct _bl00mbox_connection_t * connections; // linked list with all channel connections, user side only
+    struct _bl00mbox_render_list_t * render_list; // buds that feed root_list, NULL if none. audio task only
+    struct _bl00mbox_render_list_t * render_list_latest; // last render_list that was queued, user side only
+    bool render_list_hold; // graph changes don't rebuild the render list while set, user side only
+    bl00mbox_cycles_t cycles; // cost of rendering and mixing the whole channel
 } bl00mbox_channel_t;
 
 bl00mbox_channel_t * bl00mbox_get_channel(uint8_t chan);
@@ -88,5 +156,44 @@ bool bl00mbox_channel_set_background_mute_override(uint8_t channel_index, bool e
 char * bl00mbox_channel_get_name(uint8_t channel_index);
 void bl00mbox_channel_set_name(uint8_t channel_index, char * new_name);
 
-bool bl00mbox_audio_waitfor_pointer_change(void ** ptr, void * new_val);
-void bl00mbox_audio_bud_render(bl00mbox_bud_t * bud);
+// signal value change that the audio task applies at a given sample of the audio clock, see
+// bl00mbox_audio_queue_event
+typedef struct {
+    uint32_t time; // audio clock sample at which value takes effect
+    radspa_t * plugin;
+    uint16_t signal_index; // must be an input
+    int16_t value;
+    bool trigger; // value is a trigger start velocity, the sign is picked when it is applied
+    uint8_t channel; // channel that owns plugin
+} bl00mbox_audio_event_t;
+
+bool bl00mbox_audio_queue_pointer_change(void ** ptr, void * new_val);
+bool bl00mbox_audio_queue_free(void * ptr);
+bool bl00mbox_audio_queue_plugin_destroy(radspa_t * plugin);
+bool bl00mbox_audio_queue_event(bl00mbox_audio_event_t * event);
+bool bl00mbox_audio_queue_flush();
+// sample index of the first sample of the next block, wraps around after 2^32 samples
+uint32_t bl00mbox_audio_get_clock();
+// number of events so far that didn't take effect at their exact sample: they were due already
+// when they arrived, or more unconnected inputs changed within one block than there are event
+// buffers for. the latter take effect at the start of their block. wraps around.
+uint32_t bl00mbox_audio_get_events_missed();
+// offline render of a channel, see bl00mbox_channel_bounce. the render list is taken away from the
+// audio task and rendered into dest by a background task, stereo channels are mixed down to mono.
+// bl00mbox_audio_bounce_poll gives it back once done. one bounce at a time, the user side must keep
+// its hands off the channel meanwhile.
+bool bl00mbox_audio_bounce_start(bl00mbox_channel_t * chan, int16_t * dest, uint32_t num_samples);
+// true if no bounce is running (anymore). progress is set to the number of samples rendered.
+bool bl00mbox_audio_bounce_poll(uint32_t * progress);
+// interlaced stereo line in of the block that is being rendered, NULL in the bounce task
+int16_t * bl00mbox_audio_get_line_in();
+bool bl00mbox_audio_set_multicore(bool enable);
+bool bl00mbox_audio_get_multicore();
+
+// min/avg/max cpu cycles per block over the last profiling window. returns false and zeroes
+// if there was no render in that window or profiling is disabled. on host builds cycles are ns.
+bool bl00mbox_audio_cycles_get(bl00mbox_cycles_t * cycles, uint32_t * min, uint32_t * avg, uint32_t * max);
+bool bl00mbox_channel_get_cycles(uint8_t channel, uint32_t * min, uint32_t * avg, uint32_t * max);
+// cycles available for rendering one block in realtime at the current block size
+uint32_t bl00mbox_audio_get_cycles_per_block();
+void bl00mbox_audio_bud_render(bl00mbox_bud_t * bud, uint16_t num_samples);
@@ -1,6 +1,7 @@
 //SPDX-License-Identifier: CC0-1.0
 #pragma once
 #include "stdio.h"
+#include <stdlib.h>
 #include "radspa.h"
 
 typedef struct _bl00mbox_plugin_registry_t{
@@ -0,0 +1,30 @@
+//SPDX-License-Identifier: CC0-1.0
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sampler.h"
+
+// wav files loaded into ram once and shared between sampler buds. entries are keyed by file
+// path and refcounted, the data goes away when the last reference is dropped. files are
+// assumed not to change on disk while they're loaded. all of this is user side only.
+
+typedef struct _bl00mbox_sample_t{
+    sampler_shared_t shared; // what the samplers get to see
+    uint32_t sample_rate;
+    uint32_t num_channels; // of the file, the sample only keeps the first one
+    uint32_t hash; // of path
+    uint32_t refcount;
+    char * path;
+    struct _bl00mbox_sample_t * next;
+} bl00mbox_sample_t;
+
+// returns a reference to the sample loaded from path, loading it if nobody holds one yet. with
+// adpcm set the sample is kept compressed, see sampler_adpcm.h. the compressed and the plain
+// copy of a file are separate entries. NULL if the file can't be loaded.
+bl00mbox_sample_t * bl00mbox_sample_pool_get(const char * path, bool adpcm);
+// drops a reference. the memory is only freed once the audio task is past all blocks that were
+// queued before, so samplers must be pointed elsewhere through the audio queue first.
+void bl00mbox_sample_pool_put(bl00mbox_sample_t * sample);
+// number of samples in the pool and the memory they take up in bytes
+void bl00mbox_sample_pool_get_usage(uint32_t * num_samples, uint32_t * num_bytes);
@@ -0,0 +1,34 @@
+//SPDX-License-Identifier: CC0-1.0
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// binary snapshot of a channel graph: plugin ids and init vars of all buds, the values of their
+// unconnected inputs, all connections and the output mixer, optionally plugin tables. all fields
+// little endian:
+//
+//   header      "bl0s", u8 version, u8 flags, u16 number of buds
+//   per bud     u32 plugin id, u32 init var, u16 number of signals, i16 value of each signal,
+//               with BL00MBOX_SNAPSHOT_TABLES: u32 table len, i16 table data
+//   connections u16 count, per connection u16 rx bud, u16 rx signal, u16 tx bud, u16 tx signal
+//   mixer       u16 count, per entry u16 bud, u16 signal, u8 BL00MBOX_MIXER_* sides
+//
+// buds are referred to by their position in the snapshot. values of outputs and trigger inputs
+// are stored as 0 and ignored on restore, restored buds start out untriggered. version 1 had no
+// mixer sides, its mixer entries feed both.
+
+#define BL00MBOX_SNAPSHOT_VERSION 2
+#define BL00MBOX_SNAPSHOT_TABLES (1<<0)
+
+// returns the size of the snapshot of the channel, 0 if the channel doesn't exist. nothing is
+// written past len, if the return value is larger than len buf doesn't hold a full snapshot.
+// buf may be NULL to query the size.
+size_t bl00mbox_channel_snapshot_save(uint8_t channel, uint8_t * buf, size_t len, bool tables);
+// number of buds in a snapshot, -1 if buf doesn't hold a valid snapshot
+int32_t bl00mbox_snapshot_get_num_buds(const uint8_t * buf, size_t len);
+// adds all buds of the snapshot to the channel, existing buds are left alone. bud_indices must
+// have room for bl00mbox_snapshot_get_num_buds entries and receives the new bud indices in
+// snapshot order. on failure nothing is added to the channel.
+bool bl00mbox_channel_snapshot_restore(uint8_t channel, const uint8_t * buf, size_t len, uint32_t * bud_indices);
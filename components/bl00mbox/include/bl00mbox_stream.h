@@ -0,0 +1,63 @@
+//SPDX-License-Identifier: CC0-1.0
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include "bl00mbox_wav.h"
+
+// streamed playback of wav files that are too large to keep in ram. the start of the file (the
+// attack) is preloaded, everything after it is read ahead into a ring buffer by a background
+// task. the audio task plays the attack while the ring is refilled after a restart, so
+// triggering has no latency as long as the attack outlasts the refill.
+//
+// frame p of playback, counted from the start of the file and growing past its end when
+// looping, is attack[p] for p < attack_len and ring[(p - attack_len) % ring_len] else. with
+// loop set the prefetch task continues at the start of the file once it reaches the end.
+
+// bounds for the ring length in frames, rounded up to a power of 2
+#define BL00MBOX_STREAM_RING_MIN (1UL<<12)
+#define BL00MBOX_STREAM_RING_MAX (1UL<<20)
+// the prefetch task tops up all rings at least this often
+#define BL00MBOX_STREAM_PREFETCH_INTERVAL_MS 10
+
+typedef struct _bl00mbox_stream_t{
+    FILE * file;
+    bl00mbox_wav_t wav;
+    int16_t * attack;
+    uint32_t attack_len;
+    int16_t * ring;
+    uint32_t ring_len;
+    uint32_t step; // file frames per output sample, 16.16 fixed point
+
+    // ring state. both counters are in frames since the last restart.
+    uint32_t ring_write; // written by prefetch task
+    uint32_t ring_read; // written by audio task, first frame it still needs
+    uint32_t restart_req; // audio task increments to have the ring refilled from attack_len
+    uint32_t restart_ack; // prefetch task sets it to restart_req once it has started over
+    bool loop; // written by audio task
+
+    // prefetch task only
+    uint32_t file_pos;
+    bool seek;
+    struct _bl00mbox_stream_t * next;
+} bl00mbox_stream_t;
+
+// user side. opens a wav file, preloads attack_len frames and fills a ring of at least
+// read_ahead frames. the stream is prefetched until it is released. returns NULL on failure.
+bl00mbox_stream_t * bl00mbox_stream_open(const char * path, uint32_t read_ahead, uint32_t attack_len);
+// user side. stops prefetching and closes the file. the stream is a single block of memory
+// that the caller frees once the audio task can't see it anymore.
+void bl00mbox_stream_release(bl00mbox_stream_t * stream);
+// audio task. drops the ring contents and has the prefetch task start over at attack_len.
+void bl00mbox_stream_restart(bl00mbox_stream_t * stream);
+// tops up the rings of all streams. this is the body of the prefetch task, the host build has
+// no such task and calls it between blocks instead.
+void bl00mbox_stream_prefetch(void);
+
+// audio task. number of frames in the ring that can be read right now, 0 while a restart is
+// pending.
+static inline uint32_t bl00mbox_stream_get_ready(bl00mbox_stream_t * stream){
+    if(__atomic_load_n(&stream->restart_ack, __ATOMIC_ACQUIRE) != stream->restart_req) return 0;
+    return __atomic_load_n(&stream->ring_write, __ATOMIC_ACQUIRE);
+}
@@ -17,9 +17,17 @@ uint16_t bl00mbox_channel_conns_num(uint8_t channel);
 uint16_t bl00mbox_channel_mixer_num(uint8_t channel);
 uint64_t bl00mbox_channel_get_bud_by_mixer_list_pos(uint8_t channel, uint32_t pos);
 uint32_t bl00mbox_channel_get_signal_by_mixer_list_pos(uint8_t channel, uint32_t pos);
+uint8_t bl00mbox_channel_get_sides_by_mixer_list_pos(uint8_t channel, uint32_t pos);
 bool bl00mbox_channel_clear(uint8_t channel);
+bool bl00mbox_channel_hold_render_list(uint8_t channel, bool hold);
+// connection that feeds or is fed by a signal of bud, NULL if none. the user side must never cast
+// sig->buffer: it is set by the audio task and may point to one of its event buffers.
+bl00mbox_connection_t * bl00mbox_bud_get_connection(bl00mbox_bud_t * bud, uint16_t signal_index);
 
 bool bl00mbox_channel_connect_signal_to_output_mixer(uint8_t channel, uint32_t bud_index, uint32_t bud_signal_index);
+// sides: BL00MBOX_MIXER_LEFT, BL00MBOX_MIXER_RIGHT or both (BL00MBOX_MIXER_STEREO), the above connects to both
+bool bl00mbox_channel_connect_signal_to_output_mixer_sides(uint8_t channel, uint32_t bud_index, uint32_t bud_signal_index,
+                uint8_t sides);
 bool bl00mbox_channel_connect_signal(uint8_t channel, uint32_t bud_rx_index, uint32_t bud_rx_signal_index,
                                                uint32_t bud_tx_index, uint32_t bud_tx_signal_index);
 bool bl00mbox_channel_disconnect_signal_rx(uint8_t channel, uint32_t bud_rx_index, uint32_t bud_rx_signal_index);
@@ -34,6 +42,7 @@ char * bl00mbox_channel_bud_get_name(uint8_t channel, uint32_t bud_index);
 char * bl00mbox_channel_bud_get_description(uint8_t channel, uint32_t bud_index);
 uint32_t bl00mbox_channel_bud_get_plugin_id(uint8_t channel, uint32_t bud_index);
 uint32_t bl00mbox_channel_bud_get_init_var(uint8_t channel, uint32_t bud_index);
+bool bl00mbox_channel_bud_get_cycles(uint8_t channel, uint32_t bud_index, uint32_t * min, uint32_t * avg, uint32_t * max);
 uint16_t bl00mbox_channel_bud_get_num_signals(uint8_t channel, uint32_t bud_index);
 
 char * bl00mbox_channel_bud_get_signal_name(uint8_t channel, uint32_t bud_index, uint32_t bud_signal_index);
@@ -41,6 +50,8 @@ int8_t bl00mbox_channel_bud_get_signal_name_multiplex(uint8_t channel, uint32_t
 char * bl00mbox_channel_bud_get_signal_description(uint8_t channel, uint32_t bud_index, uint32_t bud_signal_index);
 char * bl00mbox_channel_bud_get_signal_unit(uint8_t channel, uint32_t bud_index, uint32_t bud_signal_index);
 bool bl00mbox_channel_bud_set_signal_value(uint8_t channel, uint32_t bud_index, uint32_t bud_signal_index, int16_t value);
+bool bl00mbox_channel_bud_schedule_signal_value(uint8_t channel, uint32_t bud_index, uint32_t bud_signal_index,
+                int16_t value, uint32_t time, bool trigger);
 int16_t bl00mbox_channel_bud_get_signal_value(uint8_t channel, uint32_t bud_index, uint32_t bud_signal_index);
 uint32_t bl00mbox_channel_bud_get_signal_hints(uint8_t channel, uint32_t bud_index, uint32_t bud_signal_index);
 uint16_t bl00mbox_channel_subscriber_num(uint8_t channel, uint64_t bud_index, uint16_t signal_index);
@@ -55,3 +66,15 @@ bool bl00mbox_channel_bud_set_table_value(uint8_t channel, uint32_t bud_index, u
 int16_t bl00mbox_channel_bud_get_table_value(uint8_t channel, uint32_t bud_index, uint32_t table_index);
 uint32_t bl00mbox_channel_bud_get_table_len(uint8_t channel, uint32_t bud_index);
 int16_t * bl00mbox_channel_bud_get_table_pointer(uint8_t channel, uint32_t bud_index);
+
+bool bl00mbox_channel_bud_load_wav(uint8_t channel, uint32_t bud_index, const char * path,
+                uint32_t table_offset, bool adpcm, uint32_t * num_frames, uint32_t * sample_rate);
+bool bl00mbox_channel_bud_share_sample(uint8_t channel, uint32_t bud_index, const char * path,
+                bool adpcm, uint32_t * num_frames, uint32_t * sample_rate);
+bool bl00mbox_channel_bud_stream_open(uint8_t channel, uint32_t bud_index, const char * path,
+                uint32_t read_ahead, uint32_t attack_len);
+bool bl00mbox_channel_bud_stream_close(uint8_t channel, uint32_t bud_index);
+
+bool bl00mbox_channel_bounce(uint8_t channel, uint8_t target_channel, uint32_t target_bud_index,
+                uint32_t table_offset, uint32_t num_samples);
+bool bl00mbox_channel_bounce_poll(uint32_t * progress);
@@ -0,0 +1,28 @@
+//SPDX-License-Identifier: CC0-1.0
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// minimal reader for 16bit pcm wav files, enough for the samplers. other chunks are skipped,
+// multichannel files are read as mono by keeping only the first (left) channel.
+
+typedef struct {
+    uint32_t sample_rate;
+    uint32_t num_frames;
+    uint16_t num_channels;
+    uint32_t data_start; // file offset of the first frame
+} bl00mbox_wav_t;
+
+// opens path and parses the header. on success the file is positioned at the first frame,
+// returns NULL if the file can't be opened or isn't 16bit pcm.
+FILE * bl00mbox_wav_open(const char * path, bl00mbox_wav_t * wav);
+// moves the file to the given frame, returns false if that didn't work out
+bool bl00mbox_wav_seek(FILE * file, bl00mbox_wav_t * wav, uint32_t frame);
+// reads up to num_frames frames from the current position into dest. returns the number of
+// frames read, might be less than num_frames at the end of the file or on errors.
+uint32_t bl00mbox_wav_read_mono(FILE * file, bl00mbox_wav_t * wav, int16_t * dest, uint32_t num_frames);
+// same, but encodes to ima adpcm blocks as described in sampler_adpcm.h on the way. dest must
+// have room for SAMPLER_ADPCM_WORDS(num_frames) words.
+uint32_t bl00mbox_wav_read_adpcm(FILE * file, bl00mbox_wav_t * wav, int16_t * dest, uint32_t num_frames);
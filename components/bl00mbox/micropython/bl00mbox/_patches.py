@@ -377,7 +377,8 @@ class karplus_strong(_Patch):
         self.plugins.noise = chan._new_plugin(bl00mbox.plugins.noise_burst)
         self.plugins.noise.signals.length = 25
 
-        self.plugins.flanger = chan._new_plugin(bl00mbox.plugins.flanger)
+        # allpass interpolation keeps the string bright and in tune
+        self.plugins.flanger = chan._new_plugin(bl00mbox.plugins.flanger, 1)
 
         self.plugins.flanger.signals.resonance = 0
         self.plugins.flanger.signals.decay = 1000
@@ -210,17 +210,33 @@ class _Sampler(_Plugin):
     _SAMPLE_RATE = 8 // 2
     _STATUS = 10
     _BUFFER = 11
+    # see sampler_adpcm.h
+    _ADPCM_BLOCK_LEN = 256
+    _ADPCM_BLOCK_WORDS = 66
 
-    def __init__(self, channel, plugin_id, bud_num, init_var=1000):
+    def __init__(
+        self, channel, plugin_id, bud_num, init_var=1000, shared=False, compressed=False
+    ):
         self._filename = ""
+        self._shared = False
         if bud_num is not None:
             super().__init__(channel, plugin_id, bud_num=bud_num)
-            self._memory_len = self.init_var
+            self._memory_len = self._table_memory_len()
+        elif type(init_var) is str and shared:
+            # no memory of its own, can't record
+            self._memory_len = 0
+            super().__init__(channel, plugin_id, init_var=0)
+            self.load(init_var, shared=True, compressed=compressed)
         elif type(init_var) is str:
-            with wave.open(init_var, "r") as f:
-                self._memory_len = f.getnframes()
-                super().__init__(channel, plugin_id, init_var=self._memory_len)
-                self.load(init_var)
+            info = sys_bl00mbox.wav_get_info(init_var)
+            if info is None:
+                raise bl00mbox.Bl00mboxError("incompatible file format")
+            self._memory_len = info[1]
+            if compressed:
+                blocks = -(-info[1] // self._ADPCM_BLOCK_LEN)
+                self._memory_len = blocks * self._ADPCM_BLOCK_WORDS
+            super().__init__(channel, plugin_id, init_var=self._memory_len)
+            self.load(init_var, compressed=compressed)
         else:
             self._memory_len = int(48 * init_var)
             super().__init__(channel, plugin_id, init_var=self._memory_len)
@@ -272,52 +288,52 @@ class _Sampler(_Plugin):
         )
         if self.filename is not "":
             ret += "\n  file: " + self.filename
+            if self._shared:
+                ret += " (shared)"
+            if self.compressed:
+                ret += " (compressed)"
         ret += "\n  sample rate: " + " " * 6 + str(self.sample_rate)
         return ret
 
-    def load(self, filename):
-        with wave.open(filename, "r") as f:
-            try:
-                assert f.getsampwidth() == 2
-                assert f.getnchannels() in (1, 2)
-                assert f.getcomptype() == "NONE"
-            except AssertionError:
-                raise Bl00mboxError("incompatible file format")
-
-            frames = f.getnframes()
-            if frames > self._memory_len:
-                frames = self._memory_len
-            self._sample_len_frames = frames
-
-            self.sample_rate = f.getframerate()
-
-            BUFFER_SIZE = int(48000 * 2.5)
-
-            if f.getnchannels() == 1:
-                # fast path for mono
-                table = self.table_bytearray
-                for i in range(
-                    2 * self._BUFFER,
-                    (self._sample_len_frames + self._BUFFER) * 2,
-                    BUFFER_SIZE * 2,
-                ):
-                    table[i : i + BUFFER_SIZE * 2] = f.readframes(BUFFER_SIZE)
-            else:
-                # somewhat fast path for stereo
-                table = self.table_int16_array
-                for i in range(
-                    self._BUFFER,
-                    self._sample_len_frames + self._BUFFER,
-                    BUFFER_SIZE,
-                ):
-                    frame = f.readframes(BUFFER_SIZE)
-                    for j in range(0, len(frame) // 4):
-                        value = int.from_bytes(frame[4 * j : 4 * j + 2], "little")
-                        table[i + j] = value
-            self._filename = filename
-            self._set_status_bit(4, 0)
+    def load(self, filename, shared=False, compressed=False):
+        """
+        loads a wav file into the sample buffer. with shared=True the sample is
+        loaded into a pool instead, where all samplers that load the same file
+        this way play from a single copy. compressed=True stores the sample as
+        IMA ADPCM, which takes a quarter of the memory at some loss of quality.
+        recording is not available while a shared or compressed sample is
+        loaded.
+        """
+        if shared:
+            ret = sys_bl00mbox.channel_bud_share_sample(
+                self.channel_num, self.bud_num, filename, compressed
+            )
+            if ret is None:
+                raise bl00mbox.Bl00mboxError("incompatible file format")
+            self._shared = True
+            self._shared_compressed = compressed
+            self._memory_len = ret[1]
+            self._sample_start = 0
+        else:
+            self._unshare()
+            ret = sys_bl00mbox.channel_bud_load_wav(
+                self.channel_num, self.bud_num, filename, self._BUFFER, compressed
+            )
+            if ret is None:
+                raise bl00mbox.Bl00mboxError("incompatible file format")
+            self._set_status_bit(5, compressed)
+            self._memory_len = self._table_memory_len()
+        sample_rate, frames = ret
+        self._sample_len_frames = frames
+        self.sample_rate = sample_rate
+        self._filename = filename
+        self._set_status_bit(4, 0)
 
     def save(self, filename):
+        if self._shared:
+            raise bl00mbox.Bl00mboxError("shared samples can't be saved")
+        if self.compressed:
+            raise bl00mbox.Bl00mboxError("compressed samples can't be saved")
         with wave.open(filename, "w") as f:
             f.setnchannels(1)
             f.setsampwidth(2)
@@ -334,6 +350,38 @@ class _Sampler(_Plugin):
                 self._filename = filename
                 self._set_status_bit(4, 0)
 
+    def bounce(self, channel, num_samples=None, wait=True):
+        """
+        renders the output of another channel into the sample buffer, see
+        Channel.bounce. records the whole buffer if num_samples is None.
+        """
+        self._unshare()
+        self._set_status_bit(5, 0)
+        self._memory_len = self._table_memory_len()
+        if num_samples is None or num_samples > self._memory_len:
+            num_samples = self._memory_len
+        # the table is off limits while the bounce runs
+        self._sample_start = 0
+        self._sample_len_frames = num_samples
+        self.sample_rate = 48000
+        self._filename = ""
+        channel.bounce(self, num_samples, self._BUFFER, wait)
+
+    def _table_memory_len(self):
+        if self._get_status_bit(5):
+            blocks = self.init_var // self._ADPCM_BLOCK_WORDS
+            return blocks * self._ADPCM_BLOCK_LEN
+        return self.init_var
+
+    def _unshare(self):
+        if self._shared:
+            sys_bl00mbox.channel_bud_share_sample(
+                self.channel_num, self.bud_num, None, False
+            )
+            self._shared = False
+            self._memory_len = self._table_memory_len()
+            self._filename = ""
+
     def _offset_index(self, index):
         index += self._sample_start
         if index >= self._memory_len:
@@ -421,6 +469,22 @@ class _Sampler(_Plugin):
     def buffer_length(self):
         return self._memory_len
 
+    @property
+    def shared(self):
+        """
+        True if the sampler plays a sample from the shared pool, see load()
+        """
+        return self._shared
+
+    @property
+    def compressed(self):
+        """
+        True if the sample is stored as IMA ADPCM, see load()
+        """
+        if self._shared:
+            return self._shared_compressed
+        return self._get_status_bit(5)
+
     @property
     def sample_rate(self):
         table = self.table_uint32_array
@@ -433,6 +497,176 @@ class _Sampler(_Plugin):
             table[self._SAMPLE_RATE] = int(val)
 
 
+@_plugin_set_subclass(4002)
+class _StreamSampler(_Plugin):
+    # divide by two if uint32_t
+    _READ_HEAD_POS = 0 // 2
+    _SAMPLE_LEN = 2 // 2
+    _SAMPLE_RATE = 4 // 2
+    _UNDERRUNS = 6 // 2
+    _STATUS = 8
+
+    def __init__(
+        self,
+        channel,
+        plugin_id,
+        bud_num,
+        filename=None,
+        read_ahead_ms=500,
+        attack_ms=100,
+    ):
+        self._filename = ""
+        super().__init__(channel, plugin_id, bud_num=bud_num)
+        if filename is not None:
+            self.open(filename, read_ahead_ms, attack_ms)
+
+    def __repr__(self):
+        ret = super().__repr__()
+        ret += "\n  playback "
+        if self.playback_loop:
+            ret += "(looped): "
+        else:
+            ret += "(single): "
+        if self.playback_progress is not None:
+            dots = int(self.playback_progress * 20)
+            ret += (
+                "["
+                + "#" * dots
+                + "-" * (20 - dots)
+                + "] "
+                + str(int(self.playback_progress * 100))
+                + "%"
+            )
+        else:
+            ret += "idle"
+        if self.filename is not "":
+            ret += "\n  file: " + self.filename
+            if self._shared:
+                ret += " (shared)"
+            if self.compressed:
+                ret += " (compressed)"
+        ret += "\n  underruns: " + str(self.underruns)
+        return ret
+
+    def open(self, filename, read_ahead_ms=500, attack_ms=100):
+        """
+        streams a 16bit wav file from flash or sd card instead of loading it
+        into ram. the first 'attack_ms' of the file are preloaded so that
+        triggering is instant, the rest is read 'read_ahead_ms' ahead in the
+        background. stereo files play their left channel.
+        """
+        if not sys_bl00mbox.channel_bud_stream_open(
+            self.channel_num,
+            self.bud_num,
+            filename,
+            int(48 * read_ahead_ms),
+            int(48 * attack_ms),
+        ):
+            raise bl00mbox.Bl00mboxError("can't stream " + filename)
+        self._filename = filename
+
+    def close(self):
+        sys_bl00mbox.channel_bud_stream_close(self.channel_num, self.bud_num)
+        self._filename = ""
+
+    def _set_status_bit(self, bit, val):
+        table = self.table_int16_array
+        if val:
+            table[self._STATUS] = (table[self._STATUS] | (1 << bit)) & 0xFF
+        else:
+            table[self._STATUS] = (table[self._STATUS] & ~(1 << bit)) & 0xFF
+
+    def _get_status_bit(self, bit):
+        table = self.table_int16_array
+        return bool(table[self._STATUS] & (1 << bit))
+
+    @property
+    def filename(self):
+        return self._filename
+
+    @property
+    def playback_loop(self):
+        return self._get_status_bit(1)
+
+    @playback_loop.setter
+    def playback_loop(self, val):
+        self._set_status_bit(1, val)
+
+    @property
+    def playback_progress(self):
+        if self._get_status_bit(0):
+            table = self.table_uint32_array
+            return table[self._READ_HEAD_POS] / table[self._SAMPLE_LEN]
+        return None
+
+    @property
+    def sample_length(self):
+        return self.table_uint32_array[self._SAMPLE_LEN]
+
+    @property
+    def sample_rate(self):
+        return self.table_uint32_array[self._SAMPLE_RATE]
+
+    @property
+    def underruns(self):
+        """
+        number of samples that had to be skipped because reading from the
+        file didn't keep up. if this goes up try more read ahead, if it goes
+        up right after triggering try a longer attack.
+        """
+        return self.table_uint32_array[self._UNDERRUNS]
+
+
+@_plugin_set_subclass(3300)
+class _Convolution(_Plugin):
+    # divide by two if uint32_t
+    _IR_LEN = 0 // 2
+    _GENERATION = 2
+    _IR = 3
+
+    def __init__(self, channel, plugin_id, bud_num, init_var=100):
+        self._filename = ""
+        if bud_num is not None:
+            super().__init__(channel, plugin_id, bud_num=bud_num)
+        elif type(init_var) is str:
+            info = sys_bl00mbox.wav_get_info(init_var)
+            if info is None:
+                raise bl00mbox.Bl00mboxError("incompatible file format")
+            # room for the whole file, in ms
+            super().__init__(channel, plugin_id, init_var=-(-info[1] // 48))
+            self.load(init_var)
+        else:
+            super().__init__(channel, plugin_id, init_var=init_var)
+
+    def load(self, filename):
+        """
+        loads an impulse response from a wav file. it should be at 48kHz,
+        longer responses are cut to the length the plugin was created with.
+        the new response fades in over the next few blocks.
+        """
+        ret = sys_bl00mbox.channel_bud_load_wav(
+            self.channel_num, self.bud_num, filename, self._IR, False
+        )
+        if ret is None:
+            raise bl00mbox.Bl00mboxError("incompatible file format")
+        self.table_uint32_array[self._IR_LEN] = ret[1]
+        # the plugin only picks up the new response when this changes
+        table = self.table_int16_array
+        table[self._GENERATION] = (table[self._GENERATION] + 1) & 0x7FFF
+        self._filename = filename
+
+    @property
+    def filename(self):
+        return self._filename
+
+    @property
+    def impulse_response_length(self):
+        """
+        length of the impulse response in samples
+        """
+        return self.table_uint32_array[self._IR_LEN]
+
+
 @_plugin_set_subclass(9000)
 class _Distortion(_Plugin):
     def curve_set_power(self, power=2, volume=32767, gate=0):
@@ -5,6 +5,7 @@ import sys_bl00mbox
 # note: consider the 'sys_bl00mbox' api super unstable for now pls :3
 
 import math
+import time
 import uctypes
 import bl00mbox
 from bl00mbox import _helpers as helpers
@@ -14,6 +15,43 @@ class Bl00mboxError(Exception):
     pass
 
 
+def clock():
+    """
+    current time of the audio clock in samples, i.e. the first sample of the
+    next block that is going to be rendered. wraps around after 2**32 samples.
+    events scheduled for a time that has already passed are applied at the
+    start of the next block, give them a block or two of headroom.
+    """
+    return sys_bl00mbox.audio_get_clock()
+
+
+def events_missed():
+    """
+    number of scheduled events so far that didn't take effect at their exact
+    sample, either because they were late or because too many unconnected
+    inputs changed within the same block. the latter are applied at the start
+    of their block. if this goes up, schedule earlier or spread the changes.
+    """
+    return sys_bl00mbox.audio_get_events_missed()
+
+
+def bounce_progress():
+    """
+    number of samples rendered so far by the bounce that is currently running,
+    None if there is none. finishes the bounce if it is done, see
+    Channel.bounce.
+    """
+    return sys_bl00mbox.bounce_poll()
+
+
+def sample_pool_usage():
+    """
+    (number of samples, bytes) held by the shared sample pool, see
+    Sampler.load
+    """
+    return sys_bl00mbox.sample_pool_get_usage()
+
+
 def _makeSignal(plugin, signal_num):
     hints = sys_bl00mbox.channel_bud_get_signal_hints(
         plugin.channel_num, plugin.bud_num, signal_num
@@ -34,13 +72,20 @@ def _makeSignal(plugin, signal_num):
     return signal
 
 
+# sides of the channel mixer, see BL00MBOX_MIXER_* in bl00mbox_audio.h
+_MIXER_LEFT = 1
+_MIXER_RIGHT = 2
+_MIXER_STEREO = 3
+_mixer_side_names = {_MIXER_LEFT: " left", _MIXER_RIGHT: " right", _MIXER_STEREO: ""}
+
+
 class ChannelMixer:
-    def __init__(self, channel):
+    def __init__(self, channel, sides=_MIXER_STEREO):
         self._channel = channel
-        pass
+        self._sides = sides
 
     def __repr__(self):
-        ret = "[channel mixer]"
+        ret = "[channel mixer" + _mixer_side_names[self._sides] + "]"
         ret += " (" + str(len(self.connections)) + " connections)"
         for con in self.connections:
             ret += "\n  " + con.name
@@ -55,6 +100,11 @@ class ChannelMixer:
     def connections(self):
         ret = []
         for i in range(sys_bl00mbox.channel_mixer_num(self._channel.channel_num)):
+            sides = sys_bl00mbox.channel_get_sides_by_mixer_list_pos(
+                self._channel.channel_num, i
+            )
+            if not (sides & self._sides):
+                continue
             b = sys_bl00mbox.channel_get_bud_by_mixer_list_pos(
                 self._channel.channel_num, i
             )
@@ -286,8 +336,11 @@ class SignalOutput(Signal):
             val.value = self
         elif isinstance(val, ChannelMixer):
             if val._channel.channel_num == self._plugin.channel_num:
-                sys_bl00mbox.channel_connect_signal_to_output_mixer(
-                    self._plugin.channel_num, self._plugin.bud_num, self._signal_num
+                sys_bl00mbox.channel_connect_signal_to_output_mixer_sides(
+                    self._plugin.channel_num,
+                    self._plugin.bud_num,
+                    self._signal_num,
+                    val._sides,
                 )
 
     @property
@@ -370,6 +423,24 @@ class SignalInput(Signal):
     def _stop(self):
         self.value = 0
 
+    def _event(self, value, time, trigger=False):
+        if trigger:
+            return (self._plugin.bud_num, self._signal_num, int(value), time, True)
+        return (self._plugin.bud_num, self._signal_num, int(value), time)
+
+    def schedule(self, value, time):
+        """
+        sets the value at sample 'time' of bl00mbox.clock(). doesn't disconnect
+        the signal, the value only takes effect once it is unplugged.
+        """
+        self._plugin._check_existence()
+        return (
+            sys_bl00mbox.channel_schedule(
+                self._plugin.channel_num, (self._event(value, time),)
+            )
+            == 1
+        )
+
 
 class SignalInputTriggerMixin:
     def start(self, velocity=32767):
@@ -378,6 +449,18 @@ class SignalInputTriggerMixin:
     def stop(self):
         self._stop()
 
+    def schedule_start(self, time, velocity=32767):
+        self._plugin._check_existence()
+        return (
+            sys_bl00mbox.channel_schedule(
+                self._plugin.channel_num, (self._event(velocity, time, True),)
+            )
+            == 1
+        )
+
+    def schedule_stop(self, time):
+        return self.schedule(0, time)
+
 
 class SignalPitchMixin:
     @property
@@ -590,6 +673,62 @@ class Channel:
     def clear(self):
         sys_bl00mbox.channel_clear(self.channel_num)
 
+    def schedule(self, events):
+        """
+        schedules many value changes with a single call. 'events' is a list of
+        (signal, value, time) tuples with time in samples of bl00mbox.clock(),
+        or (signal, velocity, time, True) for trigger starts. all signals must
+        be inputs of plugins in this channel. returns how many events were
+        scheduled, there's a limit on how many can be pending.
+        """
+        return sys_bl00mbox.channel_schedule(
+            self.channel_num, [e[0]._event(*e[1:]) for e in events]
+        )
+
+    def save(self, tables=False):
+        """
+        returns a snapshot of all plugins in the channel with their connections,
+        the output mixer and the values of unconnected inputs as bytes. with
+        'tables' set plugin tables such as sequencer patterns and sampler data
+        are included. to be restored with Channel.load.
+        """
+        return sys_bl00mbox.channel_snapshot_save(self.channel_num, tables)
+
+    def load(self, snapshot):
+        """
+        adds the plugins from a snapshot made by Channel.save to this channel in
+        a single call and returns them as a list in the order they were created
+        in originally. plugins that are already in the channel stay untouched.
+        """
+        self.free = False
+        buds = sys_bl00mbox.channel_snapshot_restore(self.channel_num, snapshot)
+        if buds is None:
+            raise Bl00mboxError("snapshot restore failed")
+        return [bl00mbox._plugins._make_new_plugin(self, 0, b) for b in buds]
+
+    def bounce(self, plugin, num_samples, table_offset=0, wait=True):
+        """
+        renders 'num_samples' of the channel output at full volume into the
+        table of a plugin in another channel, starting at 'table_offset'. this
+        runs in the background faster than realtime, the channel is silent
+        meanwhile. line in plugins render silence during the bounce, scheduled
+        events of the channel are held back until it is done, so they are
+        applied late. with 'wait' unset this returns
+        right away and bl00mbox.bounce_progress() returns None once the bounce
+        is done. until then neither this channel nor the plugin can be used.
+        """
+        if not sys_bl00mbox.channel_bounce(
+            self.channel_num,
+            plugin.channel_num,
+            plugin.bud_num,
+            table_offset,
+            num_samples,
+        ):
+            raise Bl00mboxError("bounce failed")
+        if wait:
+            while bounce_progress() is not None:
+                time.sleep_ms(5)
+
     @property
     def name(self):
         if self._channel_num == 0:
@@ -687,6 +826,30 @@ class Channel:
         else:
             raise Bl00mboxError("can't connect this")
 
+    # one side of the mixer only. connecting a signal that already feeds the mixer moves it
+    # to the new side(s).
+    @property
+    def mixer_left(self):
+        return ChannelMixer(self, _MIXER_LEFT)
+
+    @mixer_left.setter
+    def mixer_left(self, val):
+        if isinstance(val, SignalOutput):
+            val.value = self.mixer_left
+        else:
+            raise Bl00mboxError("can't connect this")
+
+    @property
+    def mixer_right(self):
+        return ChannelMixer(self, _MIXER_RIGHT)
+
+    @mixer_right.setter
+    def mixer_right(self, val):
+        if isinstance(val, SignalOutput):
+            val.value = self.mixer_right
+        else:
+            raise Bl00mboxError("can't connect this")
+
     @property
     def background_mute_override(self):
         return sys_bl00mbox.channel_get_background_mute_override(self.channel_num)
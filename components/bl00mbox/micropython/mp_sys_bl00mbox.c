@@ -6,7 +6,10 @@
 
 #include "bl00mbox.h"
 #include "bl00mbox_plugin_registry.h"
+#include "bl00mbox_sample_pool.h"
+#include "bl00mbox_snapshot.h"
 #include "bl00mbox_user.h"
+#include "bl00mbox_wav.h"
 #include "radspa.h"
 
 // ========================
@@ -187,6 +190,14 @@ STATIC mp_obj_t mp_channel_get_signal_by_mixer_list_pos(mp_obj_t chan,
 STATIC MP_DEFINE_CONST_FUN_OBJ_2(mp_channel_get_signal_by_mixer_list_pos_obj,
                                  mp_channel_get_signal_by_mixer_list_pos);
 
+STATIC mp_obj_t mp_channel_get_sides_by_mixer_list_pos(mp_obj_t chan,
+                                                       mp_obj_t pos) {
+    return mp_obj_new_int(bl00mbox_channel_get_sides_by_mixer_list_pos(
+        mp_obj_get_int(chan), mp_obj_get_int(pos)));
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(mp_channel_get_sides_by_mixer_list_pos_obj,
+                                 mp_channel_get_sides_by_mixer_list_pos);
+
 // ========================
 //      BUD OPERATIONS
 // ========================
@@ -323,6 +334,39 @@ STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_channel_bud_set_signal_value_obj,
                                            4, 4,
                                            mp_channel_bud_set_signal_value);
 
+// schedules (bud, signal, value, time[, trigger]) tuples in one go, see
+// bl00mbox_channel_bud_schedule_signal_value. time is in samples of the audio
+// clock. stops at the first event that can't be scheduled and returns how many
+// were.
+STATIC mp_obj_t mp_channel_schedule(mp_obj_t chan, mp_obj_t events) {
+    uint8_t channel = mp_obj_get_int(chan);
+    mp_obj_iter_buf_t iter_buf;
+    mp_obj_t iterable = mp_getiter(events, &iter_buf);
+    mp_obj_t item;
+    mp_int_t num = 0;
+    while ((item = mp_iternext(iterable)) != MP_OBJ_STOP_ITERATION) {
+        size_t len;
+        mp_obj_t *fields;
+        mp_obj_get_array(item, &len, &fields);
+        if (len < 4 || len > 5) {
+            mp_raise_ValueError(
+                MP_ERROR_TEXT("event must be (bud, signal, value, time)"));
+        }
+        int32_t value = mp_obj_get_int(fields[2]);
+        if (value > 32767) value = 32767;
+        if (value < -32767) value = -32767;
+        bool trigger = (len == 5) && mp_obj_is_true(fields[4]);
+        if (!bl00mbox_channel_bud_schedule_signal_value(
+                channel, mp_obj_get_int(fields[0]), mp_obj_get_int(fields[1]),
+                value, mp_obj_get_int_truncated(fields[3]), trigger)) {
+            break;
+        }
+        num++;
+    }
+    return mp_obj_new_int(num);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(mp_channel_schedule_obj, mp_channel_schedule);
+
 STATIC mp_obj_t mp_channel_bud_get_signal_value(mp_obj_t chan, mp_obj_t bud,
                                                 mp_obj_t signal) {
     int16_t val = bl00mbox_channel_bud_get_signal_value(
@@ -426,6 +470,176 @@ STATIC mp_obj_t mp_channel_bud_get_table_len(mp_obj_t chan, mp_obj_t bud) {
 STATIC MP_DEFINE_CONST_FUN_OBJ_2(mp_channel_bud_get_table_len_obj,
                                  mp_channel_bud_get_table_len);
 
+// ========================
+//        WAV FILES
+// ========================
+
+// (sample rate, frames, channels) of a 16bit pcm wav file, None if it can't be
+// read
+STATIC mp_obj_t mp_wav_get_info(mp_obj_t path) {
+    bl00mbox_wav_t wav;
+    FILE *file = bl00mbox_wav_open(mp_obj_str_get_str(path), &wav);
+    if (file == NULL) return mp_const_none;
+    fclose(file);
+    mp_obj_t items[3] = {
+        mp_obj_new_int_from_uint(wav.sample_rate),
+        mp_obj_new_int_from_uint(wav.num_frames),
+        mp_obj_new_int_from_uint(wav.num_channels),
+    };
+    return mp_obj_new_tuple(3, items);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(mp_wav_get_info_obj, mp_wav_get_info);
+
+// (sample rate, frames) that were loaded into the table, None on failure
+STATIC mp_obj_t mp_channel_bud_load_wav(size_t n_args, const mp_obj_t *args) {
+    uint32_t num_frames, sample_rate;
+    bool success = bl00mbox_channel_bud_load_wav(
+        mp_obj_get_int(args[0]),      // chan
+        mp_obj_get_int(args[1]),      // bud_index
+        mp_obj_str_get_str(args[2]),  // path
+        mp_obj_get_int(args[3]),      // table_offset
+        mp_obj_is_true(args[4]),      // adpcm
+        &num_frames, &sample_rate);
+    if (!success) return mp_const_none;
+    mp_obj_t items[2] = {
+        mp_obj_new_int_from_uint(sample_rate),
+        mp_obj_new_int_from_uint(num_frames),
+    };
+    return mp_obj_new_tuple(2, items);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_channel_bud_load_wav_obj, 5, 5,
+                                           mp_channel_bud_load_wav);
+
+// ========================
+//       SAMPLE POOL
+// ========================
+
+// (sample rate, frames) of the shared sample the bud plays now, None on
+// failure. path None goes back to the table.
+STATIC mp_obj_t mp_channel_bud_share_sample(size_t n_args,
+                                            const mp_obj_t *args) {
+    uint32_t num_frames, sample_rate;
+    const char *path =
+        args[2] == mp_const_none ? NULL : mp_obj_str_get_str(args[2]);
+    bool success = bl00mbox_channel_bud_share_sample(
+        mp_obj_get_int(args[0]),  // chan
+        mp_obj_get_int(args[1]),  // bud_index
+        path,                     // path
+        mp_obj_is_true(args[3]),  // adpcm
+        &num_frames, &sample_rate);
+    if (!success) return mp_const_none;
+    mp_obj_t items[2] = {
+        mp_obj_new_int_from_uint(sample_rate),
+        mp_obj_new_int_from_uint(num_frames),
+    };
+    return mp_obj_new_tuple(2, items);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_channel_bud_share_sample_obj, 4,
+                                           4, mp_channel_bud_share_sample);
+
+// (number of samples, bytes) in the sample pool
+STATIC mp_obj_t mp_sample_pool_get_usage() {
+    uint32_t num_samples, num_bytes;
+    bl00mbox_sample_pool_get_usage(&num_samples, &num_bytes);
+    mp_obj_t items[2] = {
+        mp_obj_new_int_from_uint(num_samples),
+        mp_obj_new_int_from_uint(num_bytes),
+    };
+    return mp_obj_new_tuple(2, items);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(mp_sample_pool_get_usage_obj,
+                                 mp_sample_pool_get_usage);
+
+// ========================
+//         STREAMS
+// ========================
+
+STATIC mp_obj_t mp_channel_bud_stream_open(size_t n_args, const mp_obj_t *args) {
+    bool success = bl00mbox_channel_bud_stream_open(
+        mp_obj_get_int(args[0]),      // chan
+        mp_obj_get_int(args[1]),      // bud_index
+        mp_obj_str_get_str(args[2]),  // path
+        mp_obj_get_int(args[3]),      // read_ahead
+        mp_obj_get_int(args[4]));     // attack_len
+    return mp_obj_new_bool(success);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_channel_bud_stream_open_obj, 5, 5,
+                                           mp_channel_bud_stream_open);
+
+STATIC mp_obj_t mp_channel_bud_stream_close(mp_obj_t chan, mp_obj_t bud) {
+    bool ret = bl00mbox_channel_bud_stream_close(mp_obj_get_int(chan),
+                                                 mp_obj_get_int(bud));
+    return mp_obj_new_bool(ret);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(mp_channel_bud_stream_close_obj,
+                                 mp_channel_bud_stream_close);
+
+// ========================
+//        SNAPSHOTS
+// ========================
+
+STATIC mp_obj_t mp_channel_snapshot_save(mp_obj_t chan, mp_obj_t tables) {
+    uint8_t channel = mp_obj_get_int(chan);
+    bool with_tables = mp_obj_is_true(tables);
+    size_t len = bl00mbox_channel_snapshot_save(channel, NULL, 0, with_tables);
+    if (!len) return mp_const_none;
+    vstr_t vstr;
+    vstr_init_len(&vstr, len);
+    bl00mbox_channel_snapshot_save(channel, (uint8_t *)vstr.buf, len,
+                                   with_tables);
+    return mp_obj_new_bytes_from_vstr(&vstr);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(mp_channel_snapshot_save_obj,
+                                 mp_channel_snapshot_save);
+
+// returns the list of new bud indices in snapshot order, None on failure
+STATIC mp_obj_t mp_channel_snapshot_restore(mp_obj_t chan, mp_obj_t data) {
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(data, &bufinfo, MP_BUFFER_READ);
+    int32_t num_buds = bl00mbox_snapshot_get_num_buds(bufinfo.buf, bufinfo.len);
+    if (num_buds < 0) return mp_const_none;
+    uint32_t *bud_indices = m_new(uint32_t, num_buds);
+    bool success = bl00mbox_channel_snapshot_restore(
+        mp_obj_get_int(chan), bufinfo.buf, bufinfo.len, bud_indices);
+    mp_obj_t ret = mp_const_none;
+    if (success) {
+        ret = mp_obj_new_list(num_buds, NULL);
+        for (int32_t i = 0; i < num_buds; i++) {
+            mp_obj_list_store(ret, MP_OBJ_NEW_SMALL_INT(i),
+                              mp_obj_new_int(bud_indices[i]));
+        }
+    }
+    m_del(uint32_t, bud_indices, num_buds);
+    return ret;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(mp_channel_snapshot_restore_obj,
+                                 mp_channel_snapshot_restore);
+
+// ========================
+//         BOUNCE
+// ========================
+
+STATIC mp_obj_t mp_channel_bounce(size_t n_args, const mp_obj_t *args) {
+    bool success = bl00mbox_channel_bounce(
+        mp_obj_get_int(args[0]),   // chan
+        mp_obj_get_int(args[1]),   // target_chan
+        mp_obj_get_int(args[2]),   // target_bud_index
+        mp_obj_get_int(args[3]),   // table_offset
+        mp_obj_get_int(args[4]));  // num_samples
+    return mp_obj_new_bool(success);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_channel_bounce_obj, 5, 5,
+                                           mp_channel_bounce);
+
+// returns None if no bounce is running (anymore), else the number of samples
+// rendered so far
+STATIC mp_obj_t mp_bounce_poll(void) {
+    uint32_t progress;
+    if (bl00mbox_channel_bounce_poll(&progress)) return mp_const_none;
+    return mp_obj_new_int(progress);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(mp_bounce_poll_obj, mp_bounce_poll);
+
 // ========================
 //  CONNECTION OPERATIONS
 // ========================
@@ -470,6 +684,19 @@ STATIC mp_obj_t mp_channel_connect_signal_to_output_mixer(
 STATIC MP_DEFINE_CONST_FUN_OBJ_3(mp_channel_connect_signal_to_output_mixer_obj,
                                  mp_channel_connect_signal_to_output_mixer);
 
+STATIC mp_obj_t mp_channel_connect_signal_to_output_mixer_sides(
+    size_t n_args, const mp_obj_t *args) {
+    bool success = bl00mbox_channel_connect_signal_to_output_mixer_sides(
+        mp_obj_get_int(args[0]),   // chan
+        mp_obj_get_int(args[1]),   // bud_index
+        mp_obj_get_int(args[2]),   // bud_signal_index
+        mp_obj_get_int(args[3]));  // sides
+    return mp_obj_new_bool(success);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(
+    mp_channel_connect_signal_to_output_mixer_sides_obj, 4, 4,
+    mp_channel_connect_signal_to_output_mixer_sides);
+
 STATIC mp_obj_t mp_channel_disconnect_signal_from_output_mixer(
     mp_obj_t chan, mp_obj_t bud, mp_obj_t signal) {
     bool ret = bl00mbox_channel_disconnect_signal_from_output_mixer(
@@ -480,6 +707,71 @@ STATIC MP_DEFINE_CONST_FUN_OBJ_3(
     mp_channel_disconnect_signal_from_output_mixer_obj,
     mp_channel_disconnect_signal_from_output_mixer);
 
+// ========================
+//     AUDIO OPERATIONS
+// ========================
+
+STATIC mp_obj_t mp_audio_set_multicore(mp_obj_t enable) {
+    return mp_obj_new_bool(
+        bl00mbox_audio_set_multicore(mp_obj_is_true(enable)));
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(mp_audio_set_multicore_obj,
+                                 mp_audio_set_multicore);
+
+STATIC mp_obj_t mp_audio_get_multicore(void) {
+    return mp_obj_new_bool(bl00mbox_audio_get_multicore());
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(mp_audio_get_multicore_obj,
+                                 mp_audio_get_multicore);
+
+STATIC mp_obj_t mp_audio_get_clock(void) {
+    return mp_obj_new_int_from_uint(bl00mbox_audio_get_clock());
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(mp_audio_get_clock_obj, mp_audio_get_clock);
+
+STATIC mp_obj_t mp_audio_get_events_missed(void) {
+    return mp_obj_new_int_from_uint(bl00mbox_audio_get_events_missed());
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(mp_audio_get_events_missed_obj,
+                                 mp_audio_get_events_missed);
+
+STATIC mp_obj_t mp_audio_get_cycles_per_block(void) {
+    return mp_obj_new_int_from_uint(bl00mbox_audio_get_cycles_per_block());
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(mp_audio_get_cycles_per_block_obj,
+                                 mp_audio_get_cycles_per_block);
+
+// (min, avg, max) cpu cycles per block during the last second, None if the
+// channel/bud wasn't rendered
+STATIC mp_obj_t mp_cycles_tuple(bool ok, uint32_t min, uint32_t avg,
+                                uint32_t max) {
+    if (!ok) return mp_const_none;
+    mp_obj_t items[3] = {
+        mp_obj_new_int_from_uint(min),
+        mp_obj_new_int_from_uint(avg),
+        mp_obj_new_int_from_uint(max),
+    };
+    return mp_obj_new_tuple(3, items);
+}
+
+STATIC mp_obj_t mp_channel_get_cycles(mp_obj_t chan) {
+    uint32_t min, avg, max;
+    bool ok =
+        bl00mbox_channel_get_cycles(mp_obj_get_int(chan), &min, &avg, &max);
+    return mp_cycles_tuple(ok, min, avg, max);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(mp_channel_get_cycles_obj,
+                                 mp_channel_get_cycles);
+
+STATIC mp_obj_t mp_channel_bud_get_cycles(mp_obj_t chan, mp_obj_t bud) {
+    uint32_t min, avg, max;
+    bool ok = bl00mbox_channel_bud_get_cycles(
+        mp_obj_get_int(chan), mp_obj_get_int(bud), &min, &avg, &max);
+    return mp_cycles_tuple(ok, min, avg, max);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(mp_channel_bud_get_cycles_obj,
+                                 mp_channel_bud_get_cycles);
+
 STATIC const mp_map_elem_t bl00mbox_globals_table[] = {
     { MP_OBJ_NEW_QSTR(MP_QSTR___name__),
       MP_OBJ_NEW_QSTR(MP_QSTR_sys_bl00mbox) },
@@ -533,6 +825,8 @@ STATIC const mp_map_elem_t bl00mbox_globals_table[] = {
       MP_ROM_PTR(&mp_channel_get_bud_by_mixer_list_pos_obj) },
     { MP_ROM_QSTR(MP_QSTR_channel_get_signal_by_mixer_list_pos),
       MP_ROM_PTR(&mp_channel_get_signal_by_mixer_list_pos_obj) },
+    { MP_ROM_QSTR(MP_QSTR_channel_get_sides_by_mixer_list_pos),
+      MP_ROM_PTR(&mp_channel_get_sides_by_mixer_list_pos_obj) },
 
     // BUD OPERATIONS
     { MP_ROM_QSTR(MP_QSTR_channel_new_bud),
@@ -565,6 +859,8 @@ STATIC const mp_map_elem_t bl00mbox_globals_table[] = {
       MP_ROM_PTR(&mp_channel_bud_set_signal_value_obj) },
     { MP_ROM_QSTR(MP_QSTR_channel_bud_get_signal_value),
       MP_ROM_PTR(&mp_channel_bud_get_signal_value_obj) },
+    { MP_ROM_QSTR(MP_QSTR_channel_schedule),
+      MP_ROM_PTR(&mp_channel_schedule_obj) },
     { MP_ROM_QSTR(MP_QSTR_channel_bud_get_signal_hints),
       MP_ROM_PTR(&mp_channel_bud_get_signal_hints_obj) },
     { MP_ROM_QSTR(MP_QSTR_channel_subscriber_num),
@@ -588,6 +884,34 @@ STATIC const mp_map_elem_t bl00mbox_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR_channel_bud_get_table_len),
       MP_ROM_PTR(&mp_channel_bud_get_table_len_obj) },
 
+    // WAV FILES
+    { MP_ROM_QSTR(MP_QSTR_wav_get_info), MP_ROM_PTR(&mp_wav_get_info_obj) },
+    { MP_ROM_QSTR(MP_QSTR_channel_bud_load_wav),
+      MP_ROM_PTR(&mp_channel_bud_load_wav_obj) },
+
+    // SAMPLE POOL
+    { MP_ROM_QSTR(MP_QSTR_channel_bud_share_sample),
+      MP_ROM_PTR(&mp_channel_bud_share_sample_obj) },
+    { MP_ROM_QSTR(MP_QSTR_sample_pool_get_usage),
+      MP_ROM_PTR(&mp_sample_pool_get_usage_obj) },
+
+    // STREAMS
+    { MP_ROM_QSTR(MP_QSTR_channel_bud_stream_open),
+      MP_ROM_PTR(&mp_channel_bud_stream_open_obj) },
+    { MP_ROM_QSTR(MP_QSTR_channel_bud_stream_close),
+      MP_ROM_PTR(&mp_channel_bud_stream_close_obj) },
+
+    // SNAPSHOTS
+    { MP_ROM_QSTR(MP_QSTR_channel_snapshot_save),
+      MP_ROM_PTR(&mp_channel_snapshot_save_obj) },
+    { MP_ROM_QSTR(MP_QSTR_channel_snapshot_restore),
+      MP_ROM_PTR(&mp_channel_snapshot_restore_obj) },
+
+    // BOUNCE
+    { MP_ROM_QSTR(MP_QSTR_channel_bounce),
+      MP_ROM_PTR(&mp_channel_bounce_obj) },
+    { MP_ROM_QSTR(MP_QSTR_bounce_poll), MP_ROM_PTR(&mp_bounce_poll_obj) },
+
     // CONNECTION OPERATIONS
     { MP_ROM_QSTR(MP_QSTR_channel_connect_signal),
       MP_ROM_PTR(&mp_channel_connect_signal_obj) },
@@ -597,9 +921,26 @@ STATIC const mp_map_elem_t bl00mbox_globals_table[] = {
       MP_ROM_PTR(&mp_channel_disconnect_signal_tx_obj) },
     { MP_ROM_QSTR(MP_QSTR_channel_connect_signal_to_output_mixer),
       MP_ROM_PTR(&mp_channel_connect_signal_to_output_mixer_obj) },
+    { MP_ROM_QSTR(MP_QSTR_channel_connect_signal_to_output_mixer_sides),
+      MP_ROM_PTR(&mp_channel_connect_signal_to_output_mixer_sides_obj) },
     { MP_ROM_QSTR(MP_QSTR_channel_disconnect_signal_from_output_mixer),
       MP_ROM_PTR(&mp_channel_disconnect_signal_from_output_mixer_obj) },
 
+    // AUDIO OPERATIONS
+    { MP_ROM_QSTR(MP_QSTR_audio_set_multicore),
+      MP_ROM_PTR(&mp_audio_set_multicore_obj) },
+    { MP_ROM_QSTR(MP_QSTR_audio_get_multicore),
+      MP_ROM_PTR(&mp_audio_get_multicore_obj) },
+    { MP_ROM_QSTR(MP_QSTR_audio_get_clock), MP_ROM_PTR(&mp_audio_get_clock_obj) },
+    { MP_ROM_QSTR(MP_QSTR_audio_get_events_missed),
+      MP_ROM_PTR(&mp_audio_get_events_missed_obj) },
+    { MP_ROM_QSTR(MP_QSTR_audio_get_cycles_per_block),
+      MP_ROM_PTR(&mp_audio_get_cycles_per_block_obj) },
+    { MP_ROM_QSTR(MP_QSTR_channel_get_cycles),
+      MP_ROM_PTR(&mp_channel_get_cycles_obj) },
+    { MP_ROM_QSTR(MP_QSTR_channel_bud_get_cycles),
+      MP_ROM_PTR(&mp_channel_bud_get_cycles_obj) },
+
     // CONSTANTS
     { MP_ROM_QSTR(MP_QSTR_NUM_CHANNELS), MP_ROM_INT(BL00MBOX_CHANNELS) },
     { MP_ROM_QSTR(MP_QSTR_RADSPA_SIGNAL_HINT_SCT),
@@ -9,27 +9,34 @@ radspa_descriptor_t bl00mbox_line_in_desc = {
 };
 
 void bl00mbox_line_in_run(radspa_t * line_in, uint16_t num_samples, uint32_t render_pass_id){
-    if(bl00mbox_line_in_interlaced == NULL) return;
     radspa_signal_t * left_sig = radspa_signal_get_by_index(line_in, 0);
     radspa_signal_t * right_sig = radspa_signal_get_by_index(line_in, 1);
     radspa_signal_t * mid_sig = radspa_signal_get_by_index(line_in, 2);
     radspa_signal_t * gain_sig = radspa_signal_get_by_index(line_in, 3);
+    int16_t * line_in_interlaced = bl00mbox_audio_get_line_in();
+    if(line_in_interlaced == NULL){
+        // not rendered by the audio task, i.e. bounced: there's no line in to go with it
+        radspa_signal_set_const_value(left_sig, 0);
+        radspa_signal_set_const_value(right_sig, 0);
+        radspa_signal_set_const_value(mid_sig, 0);
+        return;
+    }
 
     for(uint16_t i = 0; i < num_samples; i++){
         int32_t gain = radspa_signal_get_value(gain_sig, i, render_pass_id);
         if(left_sig->buffer != NULL){
-            int16_t left = radspa_gain(bl00mbox_line_in_interlaced[2*i], gain);
+            int16_t left = radspa_gain(line_in_interlaced[2*i], gain);
             radspa_signal_set_value(left_sig, i, left);
         }
 
         if(right_sig->buffer != NULL){
-            int16_t right = radspa_gain(bl00mbox_line_in_interlaced[2*i+1], gain);
+            int16_t right = radspa_gain(line_in_interlaced[2*i+1], gain);
             radspa_signal_set_value(right_sig, i, right);
         }
 
         if(mid_sig->buffer != NULL){
-            int16_t mid = bl00mbox_line_in_interlaced[2*i]>>1;
-            mid += bl00mbox_line_in_interlaced[2*i+1]>>1;
+            int16_t mid = line_in_interlaced[2*i]>>1;
+            mid += line_in_interlaced[2*i+1]>>1;
             mid = radspa_gain(mid, gain);
             radspa_signal_set_value(mid_sig, i, mid);
         }
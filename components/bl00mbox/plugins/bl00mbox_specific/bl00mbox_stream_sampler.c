@@ -0,0 +1,183 @@
+#include "bl00mbox_stream_sampler.h"
+
+radspa_descriptor_t bl00mbox_stream_sampler_desc = {
+    .name = "stream_sampler",
+    .id = 4002,
+    .description = "plays wav files from flash or sd card without loading them into ram. the start of "
+                   "the file is preloaded for instant triggering, the rest is read ahead in the background."
+                   "\ntable layout: [0:2] read head position (uint32_t), [2:4] sample length (uint32_t), "
+                   "[4:6] sample rate (uint32_t), [6:8] underruns (uint32_t), [8] status (int16_t bitmask)",
+    .create_plugin_instance = bl00mbox_stream_sampler_create,
+    .destroy_plugin_instance = bl00mbox_stream_sampler_destroy
+};
+
+#define STREAM_SAMPLER_NUM_SIGNALS 3
+#define STREAM_SAMPLER_OUTPUT 0
+#define STREAM_SAMPLER_TRIGGER 1
+#define STREAM_SAMPLER_SPEED 2
+
+#define READ_HEAD_POS 0
+#define SAMPLE_LEN 2
+#define SAMPLE_RATE 4
+#define UNDERRUNS 6
+#define STATUS 8
+#define STATUS_PLAYBACK_ACTIVE 0
+#define STATUS_PLAYBACK_LOOP 1
+#define STATUS_STREAM_OPEN 2
+#define TABLE_LEN 9
+
+static inline bool stream_get(bl00mbox_stream_t * stream, uint64_t frame, uint32_t ready, int16_t * ret){
+    if(frame < stream->attack_len){
+        (* ret) = stream->attack[frame];
+        return true;
+    }
+    uint64_t index = frame - stream->attack_len;
+    if(index >= ready) return false;
+    (* ret) = stream->ring[index & (stream->ring_len - 1)];
+    return true;
+}
+
+void bl00mbox_stream_sampler_run(radspa_t * stream_sampler, uint16_t num_samples, uint32_t render_pass_id){
+    radspa_signal_t * output_sig = radspa_signal_get_by_index(stream_sampler, STREAM_SAMPLER_OUTPUT);
+    radspa_signal_t * trigger_sig = radspa_signal_get_by_index(stream_sampler, STREAM_SAMPLER_TRIGGER);
+    radspa_signal_t * speed_sig = radspa_signal_get_by_index(stream_sampler, STREAM_SAMPLER_SPEED);
+    bl00mbox_stream_sampler_data_t * data = stream_sampler->plugin_data;
+    int16_t * table = stream_sampler->plugin_table;
+    uint32_t * table32 = (uint32_t *) table;
+
+    bl00mbox_stream_t * stream = data->stream;
+    if(stream != data->stream_prev){
+        data->stream_prev = stream;
+        data->playback_active = false;
+    }
+
+    int16_t trigger = radspa_signal_get_const_value(trigger_sig, render_pass_id);
+    bool trigger_const = trigger != RADSPA_SIGNAL_NONCONST;
+    if(trigger_const) trigger = radspa_trigger_get(trigger, &(data->trigger_prev));
+
+    if(stream == NULL){
+        radspa_signal_set_const_value(output_sig, 0);
+        table32[READ_HEAD_POS/2] = 0;
+        table32[SAMPLE_LEN/2] = 0;
+        table32[SAMPLE_RATE/2] = 0;
+        table[STATUS] &= ~((1<<STATUS_PLAYBACK_ACTIVE) | (1<<STATUS_STREAM_OPEN));
+        return;
+    }
+
+    bool loop = table[STATUS] & (1<<STATUS_PLAYBACK_LOOP);
+    __atomic_store_n(&stream->loop, loop, __ATOMIC_RELAXED);
+    uint32_t ready = bl00mbox_stream_get_ready(stream);
+    uint32_t num_frames = stream->wav.num_frames;
+    uint32_t underruns = 0;
+
+    bool output_mute = !data->playback_active;
+    int16_t ret = 0;
+    for(uint16_t i = 0; i < num_samples; i++){
+        if((!trigger_const) || (!i)){
+            if(!trigger_const) trigger = radspa_trigger_get(radspa_signal_get_value(trigger_sig, i, render_pass_id), &(data->trigger_prev));
+            if(trigger > 0){
+                data->playback_active = true;
+                data->read_head_pos_long = 0;
+                data->volume = trigger;
+                // the ring still starts right after the attack if nothing has been read from it
+                if(stream->ring_read){
+                    bl00mbox_stream_restart(stream);
+                    ready = 0;
+                }
+                if(output_mute){
+                    radspa_signal_set_values(output_sig, 0, i, 0);
+                    output_mute = false;
+                }
+            } else if(trigger < 0){
+                data->playback_active = false;
+            }
+        }
+
+        uint64_t frame = data->read_head_pos_long >> 16;
+        if(data->playback_active && (!loop) && (frame >= num_frames)) data->playback_active = false;
+        if(!data->playback_active){
+            if(!output_mute) radspa_signal_set_value(output_sig, i, 0);
+            continue;
+        }
+
+        int16_t a, b;
+        if(!stream_get(stream, frame, ready, &a)){
+            // prefetch hasn't caught up, wait for it
+            underruns++;
+            radspa_signal_set_value(output_sig, i, 0);
+            continue;
+        }
+        if(loop || (frame + 1 < num_frames)){
+            if(!stream_get(stream, frame + 1, ready, &b)){
+                underruns++;
+                radspa_signal_set_value(output_sig, i, 0);
+                continue;
+            }
+        } else {
+            b = a;
+        }
+        // 15 bits so that the product fits into int32_t for any step between samples
+        int32_t frac = (data->read_head_pos_long & 0xFFFF) >> 1;
+        ret = a + ((((int32_t) b - a) * frac) >> 15);
+        ret = radspa_mult_shift(ret, data->volume);
+        radspa_signal_set_value(output_sig, i, ret);
+
+        int16_t speed = radspa_signal_get_value(speed_sig, i, render_pass_id);
+        if(speed != data->speed_prev){
+            if(speed == RADSPA_SIGNAL_VAL_SCT_A440){
+                // exact so that files at 48kHz play back sample by sample
+                data->speed_mult = 1<<11;
+            } else {
+                data->speed_mult = radspa_sct_to_rel_freq(radspa_clip(speed - 18376 - 10986 - 4800), 0);
+                if(data->speed_mult > (1<<13)) data->speed_mult = (1<<13);
+            }
+            data->speed_prev = speed;
+        }
+        data->read_head_pos_long += ((uint64_t) stream->step * data->speed_mult) >> 11;
+    }
+    if(output_mute) radspa_signal_set_const_value(output_sig, 0);
+
+    // hand consumed ring frames back to the prefetch task
+    uint64_t frame = data->read_head_pos_long >> 16;
+    if(data->playback_active && (frame > stream->attack_len)){
+        uint64_t consumed = frame - stream->attack_len;
+        if(consumed > ready) consumed = ready;
+        if(consumed > stream->ring_read) __atomic_store_n(&stream->ring_read, (uint32_t) consumed, __ATOMIC_RELEASE);
+    }
+
+    table32[SAMPLE_LEN/2] = num_frames;
+    table32[SAMPLE_RATE/2] = stream->wav.sample_rate;
+    table32[UNDERRUNS/2] += underruns;
+    table[STATUS] |= 1<<(STATUS_STREAM_OPEN);
+    if(data->playback_active){
+        table[STATUS] |= 1<<(STATUS_PLAYBACK_ACTIVE);
+        table32[READ_HEAD_POS/2] = loop ? frame % num_frames : frame;
+    } else {
+        table[STATUS] &= ~(1<<(STATUS_PLAYBACK_ACTIVE));
+        table32[READ_HEAD_POS/2] = 0;
+    }
+}
+
+radspa_t * bl00mbox_stream_sampler_create(uint32_t init_var){
+    radspa_t * stream_sampler = radspa_standard_plugin_create(&bl00mbox_stream_sampler_desc,
+                STREAM_SAMPLER_NUM_SIGNALS, sizeof(bl00mbox_stream_sampler_data_t), TABLE_LEN);
+    if(stream_sampler == NULL) return NULL;
+    stream_sampler->render = bl00mbox_stream_sampler_run;
+    radspa_signal_set(stream_sampler, STREAM_SAMPLER_OUTPUT, "playback_output", RADSPA_SIGNAL_HINT_OUTPUT, 0);
+    radspa_signal_set(stream_sampler, STREAM_SAMPLER_TRIGGER, "playback_trigger", RADSPA_SIGNAL_HINT_INPUT | RADSPA_SIGNAL_HINT_TRIGGER, 0);
+    radspa_signal_set(stream_sampler, STREAM_SAMPLER_SPEED, "playback_speed", RADSPA_SIGNAL_HINT_INPUT | RADSPA_SIGNAL_HINT_SCT, RADSPA_SIGNAL_VAL_SCT_A440);
+    bl00mbox_stream_sampler_data_t * data = stream_sampler->plugin_data;
+    data->speed_mult = 1<<11;
+    data->speed_prev = RADSPA_SIGNAL_VAL_SCT_A440;
+    return stream_sampler;
+}
+
+void bl00mbox_stream_sampler_destroy(radspa_t * stream_sampler){
+    // the audio task is done with the plugin, so the stream can go right away
+    bl00mbox_stream_sampler_data_t * data = stream_sampler->plugin_data;
+    if(data->stream_user != NULL){
+        bl00mbox_stream_release(data->stream_user);
+        free(data->stream_user);
+    }
+    radspa_standard_plugin_destroy(stream_sampler);
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include "radspa.h"
+#include "radspa_helpers.h"
+// SPECIAL REQUIREMENTS
+#include "bl00mbox_stream.h"
+
+typedef struct {
+    bl00mbox_stream_t * stream; // set through the audio queue, NULL if no file is open
+    bl00mbox_stream_t * stream_user; // same, but as far as the user side is concerned
+    bl00mbox_stream_t * stream_prev;
+    uint64_t read_head_pos_long; // frames, 16.16 fixed point
+    uint32_t speed_mult;
+    int16_t speed_prev;
+    int16_t trigger_prev;
+    int16_t volume;
+    bool playback_active;
+} bl00mbox_stream_sampler_data_t;
+
+extern radspa_descriptor_t bl00mbox_stream_sampler_desc;
+radspa_t * bl00mbox_stream_sampler_create(uint32_t init_var);
+void bl00mbox_stream_sampler_run(radspa_t * stream_sampler, uint16_t num_samples, uint32_t render_pass_id);
+void bl00mbox_stream_sampler_destroy(radspa_t * stream_sampler);
@@ -4,7 +4,7 @@
 // this file, kindly append "-modified" to the version string below so it is not mistaken
 // for an official release.
 
-// Version 0.2.1
+// Version 0.2.2
 
 /* Realtime Audio Developer's Simple Plugin Api
  *
@@ -43,6 +43,8 @@
 #define RADSPA_SIGNAL_HINT_TRIGGER (1<<2)
 #define RADSPA_SIGNAL_HINT_GAIN (1<<3)
 #define RADSPA_SIGNAL_HINT_SCT (1<<5)
+// input is not watched while the plugin is idle, see IDLE PLUGINS below
+#define RADSPA_SIGNAL_HINT_IDLE_IGNORE (1<<6)
 
 #define RADSPA_SIGNAL_VAL_SCT_A440 (INT16_MAX - 6*2400)
 #define RADSPA_SIGNAL_VAL_UNITY_GAIN (1<<12)
@@ -77,7 +79,7 @@ typedef struct _radspa_signal_t{
     int16_t * buffer;
     // static value to be used when buffer is NULL for input signals only
     int16_t value;
-    // when the signal has last requested to render its source
+    // unused, kept for compatibility
     uint32_t render_pass_id;
 } radspa_signal_t;
 
@@ -91,6 +93,10 @@ typedef struct _radspa_t{
     // stores id number of render pass.
     uint32_t render_pass_id;
 
+    // may be set by the render function if the plugin is idle, see IDLE PLUGINS below. the
+    // host never writes to it.
+    bool idle;
+
     // init var that was used for creating the plugin. if the plugin needs to modify the value to
     // a valid range it may do so at any point in time.
     uint32_t init_var;
@@ -103,6 +109,21 @@ typedef struct _radspa_t{
     radspa_signal_t signals[]; 
 } radspa_t;
 
+/* IDLE PLUGINS
+ *
+ * Optional. A plugin may set plugin->idle at the end of a render call to promise the host that:
+ * - all of its outputs have been written with radspa_signal_set_const_value() in this call,
+ * - rendering it again would write the same constant outputs and leave its internal state
+ *   unchanged for as long as all of its inputs keep their current values.
+ * Inputs with RADSPA_SIGNAL_HINT_IDLE_IGNORE don't count for the latter, i.e. the plugin promises
+ * that their value doesn't matter for as long as it stays idle.
+ *
+ * The host may then skip render calls until one of the remaining inputs changes value or turns
+ * nonconst. It may also stop rendering plugins whose outputs are only read through ignored
+ * inputs of idle plugins; these plugins don't see the passage of time until somebody listens
+ * to them again. Plugins that don't touch the field are never skipped.
+ */
+
 /* REQUIREMENTS
  * Hosts must provide implementations for the following functions:
  */
@@ -113,7 +134,14 @@ typedef struct _radspa_t{
  */
 extern uint32_t radspa_sct_to_rel_freq(int16_t sct, int16_t undersample_pow);
 
-// Return 1 if the buffer wasn't rendered already, 0 otherwise.
+/* Same as radspa_sct_to_rel_freq for a whole buffer, rel_freq[i] must equal
+ * radspa_sct_to_rel_freq(sct[i], undersample_pow). For plugins with audio rate pitch inputs.
+ */
+extern void radspa_sct_to_rel_freq_buffer(const int16_t * sct, uint32_t * rel_freq, uint16_t num_samples, int16_t undersample_pow);
+
+// Return 1 if the buffer wasn't rendered already, 0 otherwise. Hosts that render all sources
+// of a plugin before the plugin itself may always return 0, the helpers in radspa_helpers.h
+// rely on that and don't call this function.
 extern bool radspa_host_request_buffer_render(int16_t * buf);
 
 
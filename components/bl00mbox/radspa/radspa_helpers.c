@@ -1,4 +1,5 @@
 //SPDX-License-Identifier: CC0-1.0
+#include <stdlib.h>
 #include "radspa_helpers.h"
 
 extern inline int16_t radspa_signal_get_value(radspa_signal_t * sig, int16_t index, uint32_t render_pass_id);
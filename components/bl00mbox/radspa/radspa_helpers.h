@@ -67,16 +67,12 @@ inline radspa_signal_t * radspa_signal_get_by_index(radspa_t * plugin, uint16_t
 }
 
 /* returns the value that a signal has at a given moment in time. time is
- * represented as the buffer index. requests rendering from host and requires implementation
- * of radspa_host_request_buffer_render.
+ * represented as the buffer index. the host renders all sources of a plugin
+ * before the plugin itself, so the buffer is always up to date.
  */
 
 inline int16_t radspa_signal_get_value(radspa_signal_t * sig, int16_t index, uint32_t render_pass_id){
     if(sig->buffer != NULL){
-        if(sig->render_pass_id != render_pass_id){
-            radspa_host_request_buffer_render(sig->buffer);
-            sig->render_pass_id = render_pass_id;
-        }
         if(sig->buffer[1] == -32768) return sig->buffer[0];
         return sig->buffer[index];
     }
@@ -99,11 +95,16 @@ inline void radspa_signal_set_value(radspa_signal_t * sig, int16_t index, int32_
     }
 }
 
+/* like radspa_signal_set_value, but marks the buffer as constant if all values written to it are
+ * the same so that readers can take their fast paths. all indices from 0 to num_samples-1 must be
+ * written in ascending order, don't mix with other setters for the same signal in a render call.
+ * hosts may define RADSPA_SIGNAL_CHECK_CONST_DISABLE to get plain radspa_signal_set_value
+ * behavior, output must be the same either way.
+ */
 inline void radspa_signal_set_value_check_const(radspa_signal_t * sig, int16_t index, int32_t val){
-    // disabled for now, causes issues somewhere, no time to track it down
+#ifdef RADSPA_SIGNAL_CHECK_CONST_DISABLE
     radspa_signal_set_value(sig, index, val);
-    return;
-
+#else
     if(sig->buffer == NULL){
         if(!index) sig->value = radspa_clip(val);
         return;
@@ -112,11 +113,14 @@ inline void radspa_signal_set_value_check_const(radspa_signal_t * sig, int16_t i
     if(index == 0){
         sig->buffer[0] = val;
     } else if(index == 1){
-        if(val == sig->buffer[0]) sig->buffer[1] = -32768;
+        // always write, else a marker left over from the last render pass may survive
+        sig->buffer[1] = (val == sig->buffer[0]) ? -32768 : val;
     } else {
+        // all samples so far were the same: [1] holds the marker, restore its value
         if((sig->buffer[1] == -32768) && (val != sig->buffer[0])) sig->buffer[1] = sig->buffer[0];
         sig->buffer[index] = val;
     }
+#endif
 }
 
 inline int16_t radspa_signal_set_value_check_const_result(radspa_signal_t * sig){
@@ -149,10 +153,6 @@ inline void radspa_signal_set_values(radspa_signal_t * sig, uint16_t start, uint
 
 inline int16_t radspa_signal_get_const_value(radspa_signal_t * sig, uint32_t render_pass_id){
     if(sig->buffer != NULL){
-        if(sig->render_pass_id != render_pass_id){
-            radspa_host_request_buffer_render(sig->buffer);
-            sig->render_pass_id = render_pass_id;
-        }
         if(sig->buffer[1] == -32768) return sig->buffer[0];
         return RADSPA_SIGNAL_NONCONST;
     }
@@ -32,7 +32,17 @@ void ampliverter_run(radspa_t * ampliverter, uint16_t num_samples, uint32_t rend
     radspa_signal_t * bias_sig = radspa_signal_get_by_index(ampliverter, AMPLIVERTER_BIAS);
     
 
-    static int16_t ret = 0;
+    // optional: if the output doesn't depend on the input anymore we can tell the host that
+    // we're idle, it may then skip rendering us and whatever feeds our input. see radspa.h.
+    int16_t gain_const = radspa_signal_get_const_value(gain_sig, render_pass_id);
+    int16_t bias_const = radspa_signal_get_const_value(bias_sig, render_pass_id);
+    ampliverter->idle = (gain_const == 0) && (bias_const != RADSPA_SIGNAL_NONCONST);
+    if(ampliverter->idle){
+        radspa_signal_set_const_value(output_sig, bias_const);
+        return;
+    }
+
+    int16_t ret = 0;
     for(uint16_t i = 0; i < num_samples; i++){
         // step 2: render the outputs. most of the time a simple for loop will be fine.
         // using {*radspa_signal_t}->get_value is required to automatically switch between
@@ -46,7 +56,7 @@ void ampliverter_run(radspa_t * ampliverter, uint16_t num_samples, uint32_t rend
             ret = radspa_mult_shift(ret, gain);
             ret = radspa_add_sat(ret, bias);
         }
-        radspa_signal_set_value(output_sig, i, ret);
+        radspa_signal_set_value_check_const(output_sig, i, ret);
     }
 }
 
@@ -66,7 +76,7 @@ radspa_t * ampliverter_create(uint32_t init_var){
     // step 3: standard_plugin_create has already created dummy signals for us, we just need to
     // fill them
     radspa_signal_set(ampliverter, AMPLIVERTER_OUTPUT, "output", RADSPA_SIGNAL_HINT_OUTPUT, 0);
-    radspa_signal_set(ampliverter, AMPLIVERTER_INPUT, "input", RADSPA_SIGNAL_HINT_INPUT, 0);
+    radspa_signal_set(ampliverter, AMPLIVERTER_INPUT, "input", RADSPA_SIGNAL_HINT_INPUT | RADSPA_SIGNAL_HINT_IDLE_IGNORE, 0);
     radspa_signal_set(ampliverter, AMPLIVERTER_GAIN, "gain", RADSPA_SIGNAL_HINT_INPUT, 32767);
     radspa_signal_set(ampliverter, AMPLIVERTER_BIAS, "bias", RADSPA_SIGNAL_HINT_INPUT, 0);
     return ampliverter;
@@ -0,0 +1,208 @@
+#include "convolution.h"
+
+radspa_descriptor_t convolution_desc = {
+    .name = "convolution",
+    .id = 3300,
+    .description = "convolves the input with an impulse response from the table, e.g. a speaker cabinet "
+                   "or a room. an impulse response sample of 32767 is unity gain. the wet signal is "
+                   "delayed by 128 samples. cpu load grows with the length of the response."
+                   "\ninit_var: maximum length of the impulse response in ms, 1-2000, default 100. "
+                   "memory use is ~2KB per 128 samples of that."
+                   "\ntable layout: [0:2] impulse response length in samples (uint32_t), [2] generation "
+                   "(int16_t), [3:48*init_var+3] impulse response (int16_t). the impulse response is "
+                   "only picked up when generation changes, so it must be set last.",
+    .create_plugin_instance = convolution_create,
+    .destroy_plugin_instance = radspa_standard_plugin_destroy
+};
+
+#define CONVOLUTION_NUM_SIGNALS 4
+#define CONVOLUTION_OUTPUT 0
+#define CONVOLUTION_INPUT 1
+#define CONVOLUTION_DRY_GAIN 2
+#define CONVOLUTION_WET_GAIN 3
+
+#define CONVOLUTION_IR_LEN 0
+#define CONVOLUTION_GENERATION 2
+#define CONVOLUTION_IR 3
+
+// partitions of a new impulse response that are transformed per render call
+#define CONVOLUTION_PREPARE_PER_RUN 2
+
+/* uniformly partitioned overlap-save: the impulse response is cut into partitions of
+ * CONVOLUTION_BLOCK_LEN samples, each zero padded to twice that and transformed once. every
+ * block of input is transformed together with the block before it, the spectra of the
+ * last num_ir_partitions input blocks are kept in history. the output spectrum is the
+ * sum of history[block - j] * ir_spectra[j], the second half of its inverse transform is
+ * the convolution of the input block with the whole response.
+ *
+ * scaling: input and response are int16_t, their spectra grow by up to the fft length
+ * (2^8). the response is shifted up by 2^4 before its transform, the rounding noise of the
+ * transform is about the same in absolute terms for every partition and would otherwise
+ * drown the quiet tail of a long response. that still leaves room for the sum of 2000ms of
+ * partition products in int64_t. the result must be divided by 2^4 * 2^8 * 32768 in total.
+ * 2^21 of that go before the inverse transform, which puts a full scale sine at 2^20 in the
+ * spectrum. that leaves 6dB for the garbage half of the result before the spectrum is
+ * clipped, and the inverse transform can't overflow. the other 2^6 come after it, which
+ * keeps a bit of sub-lsb precision until the end.
+ *
+ * per block there's one forward and one inverse fft of 256 real samples plus 129 complex
+ * multiply-adds per partition; the latter dominate for anything longer than a few
+ * partitions.
+ */
+#define CONVOLUTION_IR_SHIFT 4
+#define CONVOLUTION_SPECTRUM_SHIFT 21
+#define CONVOLUTION_OUTPUT_SHIFT 6
+// |spectrum| may not exceed this or the inverse transform could overflow
+#define CONVOLUTION_SPECTRUM_LIMIT (1L<<21)
+
+static void convolution_load(convolution_data_t * data, int16_t * table){
+    /// picks up a new impulse response, its partitions are transformed over the next few
+    /// render calls and take part as soon as they're ready
+    uint32_t len = ((uint32_t *) table)[CONVOLUTION_IR_LEN / 2];
+    uint32_t max_len = data->num_partitions * CONVOLUTION_BLOCK_LEN;
+    if(len > max_len) len = max_len;
+    data->num_ir_partitions = (len + CONVOLUTION_BLOCK_LEN - 1) / CONVOLUTION_BLOCK_LEN;
+    data->num_ready = 0;
+    // history might hold old input beyond what the idle check looked at so far
+    data->quiet = 0;
+}
+
+static void convolution_prepare(convolution_data_t * data, int16_t * table){
+    uint32_t len = ((uint32_t *) table)[CONVOLUTION_IR_LEN / 2];
+    int16_t * ir = &table[CONVOLUTION_IR];
+    uint32_t start = data->num_ready * CONVOLUTION_BLOCK_LEN;
+    for(uint16_t i = 0; i < CONVOLUTION_BLOCK_LEN; i++){
+        data->time[i] = (start + i) < len ? ir[start + i] * (1 << CONVOLUTION_IR_SHIFT) : 0;
+        data->time[CONVOLUTION_BLOCK_LEN + i] = 0;
+    }
+    fft_real(data->time, &data->ir_spectra[data->num_ready * CONVOLUTION_NUM_BINS],
+            data->work, CONVOLUTION_LOG2_FFT_LEN);
+    data->num_ready++;
+}
+
+static void convolution_process(convolution_data_t * data){
+    /// called whenever a block of input is complete
+    for(uint16_t i = 0; i < 2 * CONVOLUTION_BLOCK_LEN; i++) data->time[i] = data->input[i];
+    memcpy(data->input, &data->input[CONVOLUTION_BLOCK_LEN], CONVOLUTION_BLOCK_LEN * sizeof(int16_t));
+
+    data->head++;
+    if(data->head >= data->num_partitions) data->head = 0;
+    fft_complex_t * history = &data->history[data->head * CONVOLUTION_NUM_BINS];
+    fft_real(data->time, history, data->work, CONVOLUTION_LOG2_FFT_LEN);
+
+    int64_t * acc_re = data->acc_re;
+    int64_t * acc_im = data->acc_im;
+    memset(acc_re, 0, sizeof(data->acc_re));
+    memset(acc_im, 0, sizeof(data->acc_im));
+    fft_complex_t * ir = data->ir_spectra;
+    for(uint16_t j = 0; j < data->num_ready; j++){
+        for(uint16_t k = 0; k < CONVOLUTION_NUM_BINS; k++){
+            acc_re[k] += (int64_t) history[k].re * ir[k].re - (int64_t) history[k].im * ir[k].im;
+            acc_im[k] += (int64_t) history[k].re * ir[k].im + (int64_t) history[k].im * ir[k].re;
+        }
+        ir += CONVOLUTION_NUM_BINS;
+        if(history == data->history){
+            history += (data->num_partitions - 1) * CONVOLUTION_NUM_BINS;
+        } else {
+            history -= CONVOLUTION_NUM_BINS;
+        }
+    }
+
+    for(uint16_t k = 0; k < CONVOLUTION_NUM_BINS; k++){
+        int64_t re = acc_re[k] >> CONVOLUTION_SPECTRUM_SHIFT;
+        int64_t im = acc_im[k] >> CONVOLUTION_SPECTRUM_SHIFT;
+        // only happens if the output clips anyways
+        if(re > CONVOLUTION_SPECTRUM_LIMIT) re = CONVOLUTION_SPECTRUM_LIMIT;
+        if(re < -CONVOLUTION_SPECTRUM_LIMIT) re = -CONVOLUTION_SPECTRUM_LIMIT;
+        if(im > CONVOLUTION_SPECTRUM_LIMIT) im = CONVOLUTION_SPECTRUM_LIMIT;
+        if(im < -CONVOLUTION_SPECTRUM_LIMIT) im = -CONVOLUTION_SPECTRUM_LIMIT;
+        data->spectrum[k].re = re;
+        data->spectrum[k].im = im;
+    }
+    fft_real_inverse(data->spectrum, data->time, data->work, CONVOLUTION_LOG2_FFT_LEN);
+    // the first half is circular convolution garbage
+    for(uint16_t i = 0; i < CONVOLUTION_BLOCK_LEN; i++){
+        int32_t ret = data->time[CONVOLUTION_BLOCK_LEN + i] + (1L<<(CONVOLUTION_OUTPUT_SHIFT - 1));
+        data->output[i] = radspa_clip(ret >> CONVOLUTION_OUTPUT_SHIFT);
+    }
+}
+
+void convolution_run(radspa_t * convolution, uint16_t num_samples, uint32_t render_pass_id){
+    radspa_signal_t * output_sig = radspa_signal_get_by_index(convolution, CONVOLUTION_OUTPUT);
+    if(output_sig->buffer == NULL) return;
+    convolution_data_t * data = convolution->plugin_data;
+    int16_t * table = convolution->plugin_table;
+    radspa_signal_t * input_sig = radspa_signal_get_by_index(convolution, CONVOLUTION_INPUT);
+    radspa_signal_t * dry_gain_sig = radspa_signal_get_by_index(convolution, CONVOLUTION_DRY_GAIN);
+    radspa_signal_t * wet_gain_sig = radspa_signal_get_by_index(convolution, CONVOLUTION_WET_GAIN);
+
+    if(table[CONVOLUTION_GENERATION] != data->generation_prev){
+        data->generation_prev = table[CONVOLUTION_GENERATION];
+        convolution_load(data, table);
+    }
+    for(uint8_t i = 0; i < CONVOLUTION_PREPARE_PER_RUN; i++){
+        if(data->num_ready >= data->num_ir_partitions) break;
+        convolution_prepare(data, table);
+    }
+
+    int16_t input_const = radspa_signal_get_const_value(input_sig, render_pass_id);
+    // input block, history and output block only hold zeroes
+    uint32_t quiet_len = (data->num_ir_partitions + 2) * CONVOLUTION_BLOCK_LEN;
+    convolution->idle = (input_const == 0) && (data->quiet >= quiet_len)
+                        && (data->num_ready == data->num_ir_partitions);
+    if(convolution->idle){
+        radspa_signal_set_const_value(output_sig, 0);
+        return;
+    }
+
+    int32_t dry_gain = radspa_signal_get_value(dry_gain_sig, 0, render_pass_id);
+    int32_t wet_gain = radspa_signal_get_value(wet_gain_sig, 0, render_pass_id);
+
+    for(uint16_t i = 0; i < num_samples; i++){
+        int16_t input = input_const;
+        if(input_const == RADSPA_SIGNAL_NONCONST) input = input_sig->buffer[i];
+
+        data->input[CONVOLUTION_BLOCK_LEN + data->fill] = input;
+        int32_t wet = data->output[data->fill];
+        if(input){
+            data->quiet = 0;
+        } else if(data->quiet < quiet_len){
+            data->quiet++;
+        }
+
+        int16_t ret = radspa_add_sat((input * dry_gain) >> 12, (wet * wet_gain) >> 12);
+        radspa_signal_set_value(output_sig, i, ret);
+
+        data->fill++;
+        if(data->fill == CONVOLUTION_BLOCK_LEN){
+            convolution_process(data);
+            data->fill = 0;
+        }
+    }
+}
+
+radspa_t * convolution_create(uint32_t init_var){
+    if(init_var == 0) init_var = 100;
+    if(init_var > 2000) init_var = 2000;
+    uint32_t max_len = init_var * 48;
+    uint32_t num_partitions = (max_len + CONVOLUTION_BLOCK_LEN - 1) / CONVOLUTION_BLOCK_LEN;
+    uint32_t spectra_len = num_partitions * CONVOLUTION_NUM_BINS;
+
+    radspa_t * convolution = radspa_standard_plugin_create(&convolution_desc, CONVOLUTION_NUM_SIGNALS,
+                sizeof(convolution_data_t) + 2 * spectra_len * sizeof(fft_complex_t), CONVOLUTION_IR + max_len);
+    if(convolution == NULL) return NULL;
+    convolution->render = convolution_run;
+
+    convolution_data_t * data = convolution->plugin_data;
+    data->num_partitions = num_partitions;
+    data->ir_spectra = (fft_complex_t *) &(data[1]);
+    data->history = &data->ir_spectra[spectra_len];
+
+    radspa_signal_set(convolution, CONVOLUTION_OUTPUT, "output", RADSPA_SIGNAL_HINT_OUTPUT, 0);
+    radspa_signal_set(convolution, CONVOLUTION_INPUT, "input", RADSPA_SIGNAL_HINT_INPUT, 0);
+    radspa_signal_set(convolution, CONVOLUTION_DRY_GAIN, "dry_gain",
+            RADSPA_SIGNAL_HINT_INPUT | RADSPA_SIGNAL_HINT_GAIN | RADSPA_SIGNAL_HINT_IDLE_IGNORE, 0);
+    radspa_signal_set(convolution, CONVOLUTION_WET_GAIN, "wet_gain",
+            RADSPA_SIGNAL_HINT_INPUT | RADSPA_SIGNAL_HINT_GAIN | RADSPA_SIGNAL_HINT_IDLE_IGNORE, RADSPA_SIGNAL_VAL_UNITY_GAIN);
+    return convolution;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <radspa.h>
+#include <radspa_helpers.h>
+#include "fft.h"
+
+// partition length in samples, same as the longest block the host renders so that a block
+// never has to wait for more than one transform
+#define CONVOLUTION_BLOCK_LEN 128
+#define CONVOLUTION_LOG2_FFT_LEN 8
+#define CONVOLUTION_NUM_BINS (CONVOLUTION_BLOCK_LEN + 1)
+
+typedef struct {
+    // samples of the current block that were taken in so far
+    uint16_t fill;
+    // index of the newest input spectrum in history
+    uint16_t head;
+    // room in history and ir_spectra, in partitions
+    uint16_t num_partitions;
+    // partitions of the impulse response in the table, and how many of those are transformed
+    uint16_t num_ir_partitions;
+    uint16_t num_ready;
+    int16_t generation_prev;
+    // samples in a row with zero input
+    uint32_t quiet;
+    // the last two blocks of input, the newer one is being filled
+    int16_t input[2 * CONVOLUTION_BLOCK_LEN];
+    // wet output of the last complete block
+    int16_t output[CONVOLUTION_BLOCK_LEN];
+    // scratch space for transforms
+    int32_t time[2 * CONVOLUTION_BLOCK_LEN];
+    fft_complex_t work[CONVOLUTION_BLOCK_LEN];
+    fft_complex_t spectrum[CONVOLUTION_NUM_BINS];
+    int64_t acc_re[CONVOLUTION_NUM_BINS];
+    int64_t acc_im[CONVOLUTION_NUM_BINS];
+    // num_partitions * CONVOLUTION_NUM_BINS entries each, live right behind this struct.
+    // history is a ring buffer of the spectra of past input blocks.
+    fft_complex_t * ir_spectra;
+    fft_complex_t * history;
+} convolution_data_t;
+
+extern radspa_descriptor_t convolution_desc;
+radspa_t * convolution_create(uint32_t init_var);
+void convolution_run(radspa_t * convolution, uint16_t num_samples, uint32_t render_pass_id);
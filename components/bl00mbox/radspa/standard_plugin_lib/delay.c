@@ -22,7 +22,6 @@ radspa_descriptor_t delay_desc = {
 void delay_run(radspa_t * delay, uint16_t num_samples, uint32_t render_pass_id){
     radspa_signal_t * output_sig = radspa_signal_get_by_index(delay, DELAY_OUTPUT);
     delay_data_t * data = delay->plugin_data;
-    int16_t * buf = delay->plugin_table;
     radspa_signal_t * input_sig = radspa_signal_get_by_index(delay, DELAY_INPUT);
     radspa_signal_t * time_sig = radspa_signal_get_by_index(delay, DELAY_TIME);
     radspa_signal_t * feedback_sig = radspa_signal_get_by_index(delay, DELAY_FEEDBACK);
@@ -30,16 +29,21 @@ void delay_run(radspa_t * delay, uint16_t num_samples, uint32_t render_pass_id){
     radspa_signal_t * dry_vol_sig = radspa_signal_get_by_index(delay, DELAY_DRY_VOL);
     radspa_signal_t * rec_vol_sig = radspa_signal_get_by_index(delay, DELAY_REC_VOL);
 
-    static int16_t ret = 0;
+    int16_t ret = 0;
     
-    int32_t buffer_size = delay->plugin_table_len;
     int32_t time = radspa_signal_get_value(time_sig, 0, render_pass_id);
     if(time < 0) time = -time;
     if(time > data->max_delay) time = data->max_delay;
     if(time != data->time_prev){
-        data->read_head_position = data->write_head_position;
-        data->read_head_position -= time * (48000/1000);
-        if(data->read_head_position < 0) data->read_head_position += buffer_size;
+        uint32_t time_samples = time * (48000/1000);
+        if(time_samples < 1) time_samples = 1;
+        time_samples <<= DELAY_LINE_FRAC_BITS;
+        if(data->time_prev < 0){
+            delay_line_jump_time(&data->line, time_samples);
+        } else {
+            // glide instead of jumping, which would click
+            delay_line_set_time(&data->line, time_samples, num_samples);
+        }
         data->time_prev = time;
     }
     int16_t fb = radspa_signal_get_value(feedback_sig, 0, render_pass_id);
@@ -50,33 +54,38 @@ void delay_run(radspa_t * delay, uint16_t num_samples, uint32_t render_pass_id){
 
     
     for(uint16_t i = 0; i < num_samples; i++){
-
-        data->write_head_position++;
-        while(data->write_head_position >= buffer_size) data->write_head_position -= buffer_size; // maybe faster than %
-        data->read_head_position++;
-        while(data->read_head_position >= buffer_size) data->read_head_position -= buffer_size;
-    
         int16_t dry = radspa_signal_get_value(input_sig, i, render_pass_id);
-        int16_t wet = buf[data->read_head_position];
+        uint32_t time = delay_line_glide(&data->line);
+        int16_t wet;
+        if(data->line.ramp_left){
+            wet = delay_line_read_linear(&data->line, time);
+        } else {
+            // settled on a whole number of samples
+            wet = delay_line_read(&data->line, time >> DELAY_LINE_FRAC_BITS);
+        }
 
         if(rec_vol){
-            buf[data->write_head_position] = radspa_add_sat(radspa_mult_shift(rec_vol, dry), radspa_mult_shift(wet,fb));
+            delay_line_write(&data->line, radspa_add_sat(radspa_mult_shift(rec_vol, dry), radspa_mult_shift(wet,fb)));
+        } else {
+            // leave the buffer as it is, it keeps looping
+            data->line.write_head++;
         }
         
         ret = radspa_add_sat(radspa_mult_shift(dry_vol,dry), radspa_mult_shift(wet,level));
 
-        radspa_signal_set_value(output_sig, i, ret);
+        radspa_signal_set_value_check_const(output_sig, i, ret);
     }
 }
 
 radspa_t * delay_create(uint32_t init_var){
     if(init_var == 0) init_var = 500;
     if(init_var > 10000) init_var = 10000;
-    uint32_t buffer_size = init_var*(48000/1000);
+    uint32_t buffer_size = delay_line_buffer_len(init_var*(48000/1000));
     radspa_t * delay = radspa_standard_plugin_create(&delay_desc, DELAY_NUM_SIGNALS, sizeof(delay_data_t), buffer_size);
 
     if(delay == NULL) return NULL;
     delay_data_t * plugin_data = delay->plugin_data;
+    delay_line_init(&plugin_data->line, delay->plugin_table, buffer_size);
     plugin_data->time_prev = -1;
     plugin_data->max_delay = init_var;
     delay->render = delay_run;
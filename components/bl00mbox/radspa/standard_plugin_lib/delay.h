@@ -1,10 +1,10 @@
 #pragma once
 #include <radspa.h>
 #include <radspa_helpers.h>
+#include "delay_line.h"
 
 typedef struct {
-    int32_t read_head_position;
-    int32_t write_head_position;
+    delay_line_t line;
     int32_t max_delay;
     int32_t time_prev;
 } delay_data_t;
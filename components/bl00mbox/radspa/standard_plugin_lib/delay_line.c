@@ -0,0 +1,44 @@
+#include "delay_line.h"
+
+uint32_t delay_line_buffer_len(uint32_t max_time){
+    // + 1 for the sample on the other side of the linear/allpass interpolation
+    uint32_t len = 1;
+    while(len < max_time + 1) len <<= 1;
+    return len;
+}
+
+void delay_line_init(delay_line_t * line, int16_t * buf, uint32_t buf_len){
+    line->buf = buf;
+    line->mask = buf_len - 1;
+    line->write_head = 0;
+    line->time = DELAY_LINE_ONE;
+    line->time_target = DELAY_LINE_ONE;
+    line->time_step = 0;
+    line->ramp_left = 0;
+    line->allpass_prev = 0;
+    delay_line_allpass_update(line, DELAY_LINE_ONE);
+}
+
+void delay_line_set_time(delay_line_t * line, uint32_t time, uint16_t num_samples){
+    if(time == line->time_target) return;
+    line->time_target = time;
+    int32_t diff = time - line->time;
+    uint32_t abs_diff = diff < 0 ? -diff : diff;
+    uint32_t len = num_samples ? num_samples : 1;
+    if(abs_diff > len * DELAY_LINE_MAX_RATE) len = abs_diff / DELAY_LINE_MAX_RATE;
+    line->time_step = diff / (int32_t) len;
+    line->ramp_left = len;
+}
+
+void delay_line_jump_time(delay_line_t * line, uint32_t time){
+    line->time = time;
+    line->time_target = time;
+    line->ramp_left = 0;
+}
+
+void delay_line_allpass_update(delay_line_t * line, uint32_t time){
+    /// coeff = (1 - d)/(1 + d) for a fractional delay d in [0.5..1.5), in Q15
+    int32_t d = ((time - DELAY_LINE_ONE/2) & (DELAY_LINE_ONE - 1)) + DELAY_LINE_ONE/2;
+    line->allpass_coeff = ((int32_t) (DELAY_LINE_ONE - d) << 15) / (int32_t) (DELAY_LINE_ONE + d);
+    line->allpass_time = time;
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <radspa.h>
+#include <radspa_helpers.h>
+
+// circular buffer of int16_t samples with fractional read positions, shared by plugins that
+// delay their input. the buffer length is a power of 2, so wrapping around is a single and.
+//
+// delay times are in samples, 20.12 fixed point. reads happen before the write of the same
+// sample: a read at time t returns the sample written t samples before the next one, so t
+// must be at least one sample (two for allpass reads).
+
+#define DELAY_LINE_FRAC_BITS 12
+#define DELAY_LINE_ONE (1UL<<DELAY_LINE_FRAC_BITS)
+// the smoothed delay time moves by at most this much per sample, i.e. playback runs at
+// 0.5x to 1.5x speed while it catches up with a large jump
+#define DELAY_LINE_MAX_RATE (DELAY_LINE_ONE/2)
+
+typedef struct {
+    int16_t * buf;
+    uint32_t mask;
+    uint32_t write_head;
+
+    // smoothed delay time, see delay_line_set_time()
+    uint32_t time;
+    uint32_t time_target;
+    int32_t time_step;
+    uint32_t ramp_left;
+
+    // state of the allpass interpolator, there's one per line
+    uint32_t allpass_time;
+    int32_t allpass_coeff;
+    int16_t allpass_prev;
+} delay_line_t;
+
+// smallest power of 2 that holds max_time samples of history. max_time in whole samples.
+uint32_t delay_line_buffer_len(uint32_t max_time);
+// buf_len must be delay_line_buffer_len() of something, buf is used as is
+void delay_line_init(delay_line_t * line, int16_t * buf, uint32_t buf_len);
+// glides the smoothed delay time to time by the end of the next num_samples samples, or
+// slower if that'd be faster than DELAY_LINE_MAX_RATE. a glide that is still running keeps
+// going if the target doesn't change, so this may be called every block.
+void delay_line_set_time(delay_line_t * line, uint32_t time, uint16_t num_samples);
+// sets the smoothed delay time right away
+void delay_line_jump_time(delay_line_t * line, uint32_t time);
+// recomputes the allpass coefficient, call through delay_line_read_allpass()
+void delay_line_allpass_update(delay_line_t * line, uint32_t time);
+
+static inline uint32_t delay_line_glide(delay_line_t * line){
+    /// advances the smoothed delay time by one sample and returns it
+    if(line->ramp_left){
+        line->ramp_left--;
+        line->time = line->ramp_left ? line->time + line->time_step : line->time_target;
+    }
+    return line->time;
+}
+
+static inline void delay_line_write(delay_line_t * line, int16_t val){
+    line->buf[line->write_head & line->mask] = val;
+    line->write_head++;
+}
+
+static inline int16_t delay_line_read(delay_line_t * line, uint32_t time){
+    /// time in whole samples
+    return line->buf[(line->write_head - time) & line->mask];
+}
+
+static inline int16_t delay_line_read_linear(delay_line_t * line, uint32_t time){
+    uint32_t pos = line->write_head - (time >> DELAY_LINE_FRAC_BITS);
+    int32_t frac = time & (DELAY_LINE_ONE - 1);
+    int32_t a = line->buf[pos & line->mask];
+    int32_t b = line->buf[(pos - 1) & line->mask];
+    return a + (((b - a) * frac) >> DELAY_LINE_FRAC_BITS);
+}
+
+static inline int16_t delay_line_read_allpass(delay_line_t * line, uint32_t time){
+    /// first order allpass interpolation. unlike linear interpolation it doesn't dull the
+    /// signal at fractional delays, which keeps tuned feedback loops (karplus-strong) bright
+    /// and in tune. it has a memory though and gets noisy if time jumps around a lot, sweeps
+    /// should use linear reads instead. only one allpass read per line and sample.
+    if(time != line->allpass_time) delay_line_allpass_update(line, time);
+    // the allpass takes care of 0.5..1.5 samples, the buffer of the rest
+    uint32_t pos = line->write_head - ((time - DELAY_LINE_ONE/2) >> DELAY_LINE_FRAC_BITS);
+    int32_t a = line->buf[pos & line->mask];
+    int32_t b = line->buf[(pos - 1) & line->mask];
+    int32_t ret = b + ((line->allpass_coeff * (a - line->allpass_prev)) >> 15);
+    line->allpass_prev = radspa_clip(ret);
+    return line->allpass_prev;
+}
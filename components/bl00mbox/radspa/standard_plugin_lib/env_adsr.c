@@ -164,8 +164,11 @@ void env_adsr_run(radspa_t * env_adsr, uint16_t num_samples, uint32_t render_pas
         data->env_prev = 0;
         radspa_signal_set_const_value(&env_adsr->signals[ENV_ADSR_OUTPUT], 0);
         radspa_signal_set_const_value(&env_adsr->signals[ENV_ADSR_ENV_OUTPUT], 0);
+        // nothing but a trigger can get us out of here
+        env_adsr->idle = data->env_phase == ENV_ADSR_PHASE_OFF;
         return;
     }
+    env_adsr->idle = false;
 
     int32_t env = data->env_counter >> 17;
     env = (env * data->velocity) >> 15;
@@ -203,14 +206,14 @@ radspa_t * env_adsr_create(uint32_t init_var){
     radspa_t * env_adsr = radspa_standard_plugin_create(&env_adsr_desc, ENV_ADSR_NUM_SIGNALS, sizeof(env_adsr_data_t), 0);
     env_adsr->render = env_adsr_run;
     radspa_signal_set(env_adsr, ENV_ADSR_OUTPUT, "output", RADSPA_SIGNAL_HINT_OUTPUT, 0);
-    radspa_signal_set(env_adsr, ENV_ADSR_INPUT, "input", RADSPA_SIGNAL_HINT_INPUT, 32767);
+    radspa_signal_set(env_adsr, ENV_ADSR_INPUT, "input", RADSPA_SIGNAL_HINT_INPUT | RADSPA_SIGNAL_HINT_IDLE_IGNORE, 32767);
     radspa_signal_set(env_adsr, ENV_ADSR_ENV_OUTPUT, "env_output", RADSPA_SIGNAL_HINT_OUTPUT | RADSPA_SIGNAL_HINT_GAIN, 0);
     radspa_signal_set(env_adsr, ENV_ADSR_TRIGGER, "trigger", RADSPA_SIGNAL_HINT_INPUT | RADSPA_SIGNAL_HINT_TRIGGER, 0);
-    radspa_signal_set(env_adsr, ENV_ADSR_ATTACK, "attack", RADSPA_SIGNAL_HINT_INPUT, 100);
-    radspa_signal_set(env_adsr, ENV_ADSR_DECAY, "decay", RADSPA_SIGNAL_HINT_INPUT, 250);
-    radspa_signal_set(env_adsr, ENV_ADSR_SUSTAIN, "sustain", RADSPA_SIGNAL_HINT_INPUT, 16000);
-    radspa_signal_set(env_adsr, ENV_ADSR_RELEASE, "release", RADSPA_SIGNAL_HINT_INPUT, 50);
-    radspa_signal_set(env_adsr, ENV_ADSR_GAIN, "gain", RADSPA_SIGNAL_HINT_INPUT | RADSPA_SIGNAL_HINT_GAIN, RADSPA_SIGNAL_VAL_UNITY_GAIN);
+    radspa_signal_set(env_adsr, ENV_ADSR_ATTACK, "attack", RADSPA_SIGNAL_HINT_INPUT | RADSPA_SIGNAL_HINT_IDLE_IGNORE, 100);
+    radspa_signal_set(env_adsr, ENV_ADSR_DECAY, "decay", RADSPA_SIGNAL_HINT_INPUT | RADSPA_SIGNAL_HINT_IDLE_IGNORE, 250);
+    radspa_signal_set(env_adsr, ENV_ADSR_SUSTAIN, "sustain", RADSPA_SIGNAL_HINT_INPUT | RADSPA_SIGNAL_HINT_IDLE_IGNORE, 16000);
+    radspa_signal_set(env_adsr, ENV_ADSR_RELEASE, "release", RADSPA_SIGNAL_HINT_INPUT | RADSPA_SIGNAL_HINT_IDLE_IGNORE, 50);
+    radspa_signal_set(env_adsr, ENV_ADSR_GAIN, "gain", RADSPA_SIGNAL_HINT_INPUT | RADSPA_SIGNAL_HINT_GAIN | RADSPA_SIGNAL_HINT_IDLE_IGNORE, RADSPA_SIGNAL_VAL_UNITY_GAIN);
     radspa_signal_get_by_index(env_adsr, ENV_ADSR_ATTACK)->unit = "ms";
     radspa_signal_get_by_index(env_adsr, ENV_ADSR_DECAY)->unit = "ms";
     radspa_signal_get_by_index(env_adsr, ENV_ADSR_SUSTAIN)->unit = "ms";
@@ -0,0 +1,180 @@
+#include "fft.h"
+
+// cos(2*pi*k/FFT_MAX_LEN) for the first quarter wave, Q30
+// py: [round((1<<30)*math.cos(2*math.pi*k/1024)) for k in range(257)]
+static const int32_t fft_cos_table[FFT_MAX_LEN/4 + 1] = {
+    1073741824, 1073721611, 1073660973, 1073559913, 1073418433, 1073236540, 1073014240, 1072751542,
+    1072448455, 1072104991, 1071721163, 1071296985, 1070832474, 1070327646, 1069782521, 1069197120,
+    1068571464, 1067905576, 1067199483, 1066453210, 1065666786, 1064840240, 1063973603, 1063066909,
+    1062120190, 1061133483, 1060106826, 1059040255, 1057933813, 1056787540, 1055601479, 1054375676,
+    1053110176, 1051805027, 1050460278, 1049075980, 1047652185, 1046188946, 1044686319, 1043144360,
+    1041563127, 1039942680, 1038283080, 1036584389, 1034846671, 1033069992, 1031254418, 1029400018,
+    1027506862, 1025575020, 1023604567, 1021595575, 1019548121, 1017462281, 1015338134, 1013175761,
+    1010975242, 1008736660, 1006460100, 1004145648, 1001793390, 999403415, 996975812, 994510675,
+    992008094, 989468165, 986890984, 984276646, 981625251, 978936898, 976211688, 973449725,
+    970651112, 967815955, 964944360, 962036435, 959092290, 956112036, 953095785, 950043650,
+    946955747, 943832191, 940673101, 937478595, 934248793, 930983817, 927683790, 924348837,
+    920979082, 917574653, 914135678, 910662286, 907154608, 903612776, 900036924, 896427186,
+    892783698, 889106597, 885396022, 881652112, 877875009, 874064853, 870221790, 866345964,
+    862437520, 858496606, 854523370, 850517961, 846480531, 842411232, 838310216, 834177638,
+    830013654, 825818421, 821592095, 817334838, 813046808, 808728167, 804379079, 799999706,
+    795590213, 791150767, 786681534, 782182683, 777654384, 773096806, 768510122, 763894504,
+    759250125, 754577161, 749875788, 745146182, 740388522, 735602987, 730789757, 725949013,
+    721080937, 716185713, 711263525, 706314559, 701339000, 696337036, 691308855, 686254647,
+    681174602, 676068911, 670937767, 665781362, 660599890, 655393548, 650162530, 644907034,
+    639627258, 634323400, 628995660, 623644239, 618269338, 612871159, 607449906, 602005783,
+    596538995, 591049748, 585538248, 580004702, 574449320, 568872310, 563273883, 557654248,
+    552013618, 546352205, 540670223, 534967884, 529245404, 523502998, 517740883, 511959275,
+    506158392, 500338453, 494499676, 488642281, 482766489, 476872522, 470960600, 465030947,
+    459083786, 453119340, 447137835, 441139496, 435124548, 429093217, 423045732, 416982319,
+    410903207, 404808624, 398698801, 392573967, 386434353, 380280190, 374111709, 367929144,
+    361732726, 355522689, 349299266, 343062693, 336813204, 330551034, 324276419, 317989595,
+    311690799, 305380268, 299058239, 292724951, 286380643, 280025552, 273659918, 267283981,
+    260897982, 254502159, 248096755, 241682010, 235258165, 228825464, 222384147, 215934457,
+    209476638, 203010932, 196537583, 190056834, 183568930, 177074115, 170572633, 164064728,
+    157550647, 151030634, 144504935, 137973796, 131437462, 124896179, 118350194, 111799753,
+    105245103, 98686491, 92124163, 85558366, 78989349, 72417357, 65842639, 59265442,
+    52686014, 46104602, 39521455, 32936819, 26350943, 19764076, 13176464, 6588356,
+    0,
+};
+
+static inline void fft_twiddle(uint32_t m, int32_t * re, int32_t * im){
+    /// e^(-2*pi*i*m/FFT_MAX_LEN) for m in [0..FFT_MAX_LEN)
+    uint32_t r = m & (FFT_MAX_LEN/4 - 1);
+    int32_t c = fft_cos_table[r];
+    int32_t s = fft_cos_table[FFT_MAX_LEN/4 - r];
+    switch(m / (FFT_MAX_LEN/4)){
+        case 0: *re = c; *im = -s; break;
+        case 1: *re = -s; *im = -c; break;
+        case 2: *re = -c; *im = s; break;
+        default: *re = s; *im = c; break;
+    }
+}
+
+static void fft_bit_reverse(fft_complex_t * data, uint8_t log2_len){
+    uint32_t len = 1UL << log2_len;
+    uint32_t j = 0;
+    for(uint32_t i = 0; i < len; i++){
+        if(i < j){
+            fft_complex_t tmp = data[i];
+            data[i] = data[j];
+            data[j] = tmp;
+        }
+        // j = bit reversed i + 1
+        uint32_t bit = len >> 1;
+        while(j & bit){
+            j ^= bit;
+            bit >>= 1;
+        }
+        j |= bit;
+    }
+}
+
+void fft_complex(fft_complex_t * data, uint8_t log2_len){
+    /// decimation in frequency. each radix-4 butterfly does the work of two radix-2 stages
+    /// and its outputs go where those would have put them, so the result comes out in bit
+    /// reversed order no matter if there's a radix-2 stage at the end.
+    uint32_t len = 1UL << log2_len;
+    uint32_t span = len;
+    for(; span >= 4; span >>= 2){
+        uint32_t quarter = span >> 2;
+        uint32_t step = FFT_MAX_LEN / span;
+        for(uint32_t k = 0; k < quarter; k++){
+            int32_t w1_re, w1_im, w2_re, w2_im, w3_re, w3_im;
+            fft_twiddle(k * step, &w1_re, &w1_im);
+            fft_twiddle(2 * k * step, &w2_re, &w2_im);
+            fft_twiddle(3 * k * step, &w3_re, &w3_im);
+            for(uint32_t g = k; g < len; g += span){
+                fft_complex_t * a = &data[g];
+                fft_complex_t a0 = a[0];
+                fft_complex_t a1 = a[quarter];
+                fft_complex_t a2 = a[2 * quarter];
+                fft_complex_t a3 = a[3 * quarter];
+                fft_complex_t t0 = { a0.re + a2.re, a0.im + a2.im };
+                fft_complex_t t1 = { a0.re - a2.re, a0.im - a2.im };
+                fft_complex_t t2 = { a1.re + a3.re, a1.im + a3.im };
+                // (a1 - a3) * -i
+                fft_complex_t t3 = { a1.im - a3.im, a3.re - a1.re };
+                a[0] = (fft_complex_t) { t0.re + t2.re, t0.im + t2.im };
+                fft_complex_t b1 = { t0.re - t2.re, t0.im - t2.im };
+                fft_complex_t b2 = { t1.re + t3.re, t1.im + t3.im };
+                fft_complex_t b3 = { t1.re - t3.re, t1.im - t3.im };
+                if(k){
+                    fft_complex_mult(&a[quarter], b1, w2_re, w2_im);
+                    fft_complex_mult(&a[2 * quarter], b2, w1_re, w1_im);
+                    fft_complex_mult(&a[3 * quarter], b3, w3_re, w3_im);
+                } else {
+                    a[quarter] = b1;
+                    a[2 * quarter] = b2;
+                    a[3 * quarter] = b3;
+                }
+            }
+        }
+    }
+    if(span == 2){
+        for(uint32_t g = 0; g < len; g += 2){
+            fft_complex_t a = data[g];
+            fft_complex_t b = data[g + 1];
+            data[g] = (fft_complex_t) { a.re + b.re, a.im + b.im };
+            data[g + 1] = (fft_complex_t) { a.re - b.re, a.im - b.im };
+        }
+    }
+    fft_bit_reverse(data, log2_len);
+}
+
+void fft_complex_inverse(fft_complex_t * data, uint8_t log2_len){
+    /// conj(fft(conj(x)))
+    uint32_t len = 1UL << log2_len;
+    for(uint32_t i = 0; i < len; i++) data[i].im = -data[i].im;
+    fft_complex(data, log2_len);
+    for(uint32_t i = 0; i < len; i++) data[i].im = -data[i].im;
+}
+
+void fft_real(const int32_t * in, fft_complex_t * out, fft_complex_t * work, uint8_t log2_len){
+    /// z[t] = x[2t] + i*x[2t+1] is transformed to Z = E + i*O with E, O the transforms of the
+    /// even and odd samples, which are pulled apart again by conjugate symmetry:
+    /// 2*E[k] = Z[k] + conj(Z[n-k]), 2*i*O[k] = Z[k] - conj(Z[n-k]), X[k] = E[k] + W^k*O[k]
+    uint32_t half = 1UL << (log2_len - 1);
+    for(uint32_t t = 0; t < half; t++){
+        work[t].re = in[2 * t];
+        work[t].im = in[2 * t + 1];
+    }
+    fft_complex(work, log2_len - 1);
+    uint32_t step = FFT_MAX_LEN >> log2_len;
+    for(uint32_t k = 0; k <= half; k++){
+        fft_complex_t z = work[k & (half - 1)];
+        fft_complex_t zc = work[(half - k) & (half - 1)];
+        // 2*E and 2*O
+        fft_complex_t e = { z.re + zc.re, z.im - zc.im };
+        fft_complex_t o = { z.im + zc.im, zc.re - z.re };
+        int32_t w_re, w_im;
+        fft_twiddle(k * step, &w_re, &w_im);
+        fft_complex_mult(&o, o, w_re, w_im);
+        out[k].re = (e.re + o.re) >> 1;
+        out[k].im = (e.im + o.im) >> 1;
+    }
+}
+
+void fft_real_inverse(const fft_complex_t * in, int32_t * out, fft_complex_t * work, uint8_t log2_len){
+    /// undoes the split of fft_real, 2*E[k] = X[k] + conj(X[n-k]) and
+    /// 2*O[k] = (X[k] - conj(X[n-k])) * W^-k, then 2*Z = 2*E + 2*i*O is transformed back
+    /// by a complex transform of half the length, which takes care of the factor 2.
+    uint32_t half = 1UL << (log2_len - 1);
+    uint32_t step = FFT_MAX_LEN >> log2_len;
+    for(uint32_t k = 0; k < half; k++){
+        fft_complex_t x = in[k];
+        fft_complex_t xc = in[half - k];
+        fft_complex_t e = { x.re + xc.re, x.im - xc.im };
+        fft_complex_t o = { x.re - xc.re, x.im + xc.im };
+        int32_t w_re, w_im;
+        fft_twiddle(k * step, &w_re, &w_im);
+        fft_complex_mult(&o, o, w_re, -w_im);
+        work[k].re = e.re - o.im;
+        work[k].im = e.im + o.re;
+    }
+    fft_complex_inverse(work, log2_len - 1);
+    for(uint32_t t = 0; t < half; t++){
+        out[2 * t] = work[t].re;
+        out[2 * t + 1] = work[t].im;
+    }
+}
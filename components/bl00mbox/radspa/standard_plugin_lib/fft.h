@@ -0,0 +1,41 @@
+#pragma once
+#include <radspa.h>
+#include <radspa_helpers.h>
+
+// fixed point fft for plugins that work in the frequency domain (convolution, spectrum
+// analysis, vocoders...). data is int32_t, twiddle factors are Q30. none of the transforms
+// scale: every stage may double the magnitude of the data, so a transform of length n grows
+// it by up to n. the caller leaves that much headroom, i.e. int16_t input is fine up to
+// n = 2^15, and scales the result as it sees fit.
+//
+// the complex transform runs radix-4 butterflies, plus a single radix-2 stage if log2 of the
+// length is odd. lengths are powers of 2 up to FFT_MAX_LEN.
+
+#define FFT_MAX_LOG2_LEN 10
+#define FFT_MAX_LEN (1UL<<FFT_MAX_LOG2_LEN)
+
+typedef struct {
+    int32_t re;
+    int32_t im;
+} fft_complex_t;
+
+// in place, natural order in and out. X[k] = sum(x[t] * e^(-2*pi*i*k*t/len))
+void fft_complex(fft_complex_t * data, uint8_t log2_len);
+// in place, natural order in and out. x[t] = sum(X[k] * e^(2*pi*i*k*t/len)), so
+// fft_complex_inverse(fft_complex(x)) == len * x
+void fft_complex_inverse(fft_complex_t * data, uint8_t log2_len);
+
+// transform of len real samples to the len/2 + 1 bins from dc to nyquist, the other half
+// is the complex conjugate of those. runs a complex transform of half the length.
+// len may be up to FFT_MAX_LEN, work holds len/2 entries.
+void fft_real(const int32_t * in, fft_complex_t * out, fft_complex_t * work, uint8_t log2_len);
+// inverse of fft_real: fft_real_inverse(fft_real(x)) == len * x. in is left alone.
+void fft_real_inverse(const fft_complex_t * in, int32_t * out, fft_complex_t * work, uint8_t log2_len);
+
+static inline void fft_complex_mult(fft_complex_t * ret, fft_complex_t a, int32_t re, int32_t im){
+    /// ret = a * (re + i*im), re and im in Q30
+    int64_t r = (int64_t) a.re * re - (int64_t) a.im * im;
+    int64_t j = (int64_t) a.re * im + (int64_t) a.im * re;
+    ret->re = (r + (1LL<<29)) >> 30;
+    ret->im = (j + (1LL<<29)) >> 30;
+}
@@ -56,13 +56,14 @@ static inline void get_mode_coeffs(uint8_t mode, filter_data_t * data, int32_t *
     }
 }
 
-static inline void get_coeffs(filter_data_t * data, int16_t pitch, int16_t reso, int16_t mode){
+static inline void get_coeffs(filter_data_t * data, int16_t pitch, const uint32_t * pitch_rel_freq, int16_t reso, int16_t mode){
     if((pitch != data->pitch_prev) || (reso != data->reso_prev)){
         int32_t mqi = reso>>2;
         if(mqi < 0) mqi = -mqi;
         if(mqi < 171) mqi = 171;
 
-        uint32_t freq = radspa_sct_to_rel_freq(pitch, 0);
+        // nonconst pitch comes converted for the whole block
+        uint32_t freq = pitch_rel_freq == NULL ? radspa_sct_to_rel_freq(pitch, 0) : (* pitch_rel_freq);
         if(freq > (3UL<<29)) freq = 3UL<<29;
 
         // unit: 1<<21 <=> 1, range: [0..1<<21]
@@ -146,7 +147,7 @@ void filter_run(radspa_t * filter, uint16_t num_samples, uint32_t render_pass_id
 
     if((pitch_const != RADSPA_SIGNAL_NONCONST) && (reso_const != RADSPA_SIGNAL_NONCONST) && (mode_const != RADSPA_SIGNAL_NONCONST)){
         always_update_coeffs = false;
-        get_coeffs(data, pitch, reso, mode);
+        get_coeffs(data, pitch, NULL, reso, mode);
     }
     if((input_const != RADSPA_SIGNAL_NONCONST) && (mix_const != RADSPA_SIGNAL_NONCONST) && (gain_const != RADSPA_SIGNAL_NONCONST)
         && (data->const_output != RADSPA_SIGNAL_NONCONST)){
@@ -156,13 +157,25 @@ void filter_run(radspa_t * filter, uint16_t num_samples, uint32_t render_pass_id
 
     int16_t out[num_samples];
 
+    // coefficients only follow nonconst pitch at event boundaries, convert just those
+    uint16_t num_events = (num_samples + RADSPA_EVENT_MASK) / (RADSPA_EVENT_MASK + 1);
+    bool pitch_nonconst = always_update_coeffs && (pitch_const == RADSPA_SIGNAL_NONCONST);
+    int16_t event_pitch[pitch_nonconst ? num_events : 1];
+    uint32_t event_rel_freq[pitch_nonconst ? num_events : 1];
+    if(pitch_nonconst){
+        for(uint16_t i = 0; i < num_events; i++){
+            event_pitch[i] = radspa_signal_get_value(pitch_sig, i * (RADSPA_EVENT_MASK + 1), render_pass_id);
+        }
+        radspa_sct_to_rel_freq_buffer(event_pitch, event_rel_freq, num_events, 0);
+    }
+
     for(uint16_t i = 0; i < num_samples; i++){
         if(!(i & (RADSPA_EVENT_MASK))){
             if(always_update_coeffs){
-                if(pitch_const == RADSPA_SIGNAL_NONCONST) pitch = radspa_signal_get_value(pitch_sig, i, render_pass_id);
+                if(pitch_nonconst) pitch = event_pitch[i / (RADSPA_EVENT_MASK + 1)];
                 if(reso_const == RADSPA_SIGNAL_NONCONST) reso = radspa_signal_get_value(reso_sig, i, render_pass_id);
                 if(mode_const == RADSPA_SIGNAL_NONCONST) mode = radspa_signal_get_value(mode_sig, i, render_pass_id);
-                get_coeffs(data, pitch, reso, mode);
+                get_coeffs(data, pitch, pitch_nonconst ? &(event_rel_freq[i / (RADSPA_EVENT_MASK + 1)]) : NULL, reso, mode);
             }
             if(gain_const == RADSPA_SIGNAL_NONCONST) gain = radspa_signal_get_value(gain_sig, i, render_pass_id);
             if(mix_const == RADSPA_SIGNAL_NONCONST) mix = radspa_signal_get_value(mix_sig, i, render_pass_id);
@@ -251,6 +264,6 @@ radspa_t * filter_create(uint32_t real_init_var){
         data->in_history[i] = 0;
         data->out_history[i] = 0;
     }
-    get_coeffs(data, RADSPA_SIGNAL_VAL_SCT_A440, RADSPA_SIGNAL_VAL_UNITY_GAIN, -32767);
+    get_coeffs(data, RADSPA_SIGNAL_VAL_SCT_A440, NULL, RADSPA_SIGNAL_VAL_UNITY_GAIN, -32767);
     return filter;
 }
@@ -4,13 +4,17 @@ radspa_t * flanger_create(uint32_t init_var);
 radspa_descriptor_t flanger_desc = {
     .name = "flanger",
     .id = 123,
-    .description = "flanger with subsample interpolation and negative mix/resonance capability.",
+    .description = "flanger with subsample interpolation and negative mix/resonance capability."
+                   "\ninit_var: 0: linear interpolation, for sweeps. 1: allpass interpolation, stays bright "
+                   "and in tune at high resonance but doesn't like fast sweeps, for karplus-strong",
     .create_plugin_instance = flanger_create,
     .destroy_plugin_instance = radspa_standard_plugin_destroy
 };
 
 #define FLANGER_BUFFER_SIZE 4800
 #define FIXED_POINT_DIGITS 4
+// audio rate changes of manual are spread over this many samples
+#define FLANGER_SMOOTH_SAMPLES 32
 #define VARIABLE_NAME ((FLANGER_BUFFER_SIZE)<<(FIXED_POINT_DIGITS))
 
 #define FLANGER_NUM_SIGNALS 7
@@ -22,17 +26,12 @@ radspa_descriptor_t flanger_desc = {
 #define FLANGER_LEVEL 5
 #define FLANGER_MIX 6
 
-static inline int32_t fixed_point_list_access(int32_t * buf, int32_t fp_index, uint32_t buf_len){
-    int32_t index = (fp_index) >> (FIXED_POINT_DIGITS);
-    while(index >= buf_len) index -= buf_len;
-    int32_t next_index = index + 1;
-    while(next_index >= buf_len) next_index -= buf_len;
-
-    int32_t subindex = (fp_index) & ((1<<(FIXED_POINT_DIGITS)) - 1);
-    int32_t ret =  buf[index] * ((1<<(FIXED_POINT_DIGITS)) - subindex);
-    ret += (buf[next_index]) * subindex;
-    ret = ret >> (FIXED_POINT_DIGITS);
-    return radspa_clip(ret);
+static inline uint32_t manual_to_time(int16_t manual){
+    /// see below, returns delay time for delay_line_t
+    int32_t manual_invert = ((2400*(FIXED_POINT_DIGITS)) - 7572) - manual; // magic numbers
+    uint32_t rho = radspa_sct_to_rel_freq(radspa_clip(manual_invert), 0);
+    if(rho > VARIABLE_NAME) rho = VARIABLE_NAME;
+    return rho;
 }
 
 /* delay_time = 1/freq
@@ -52,7 +51,6 @@ void flanger_run(radspa_t * flanger, uint16_t num_samples, uint32_t render_pass_
     radspa_signal_t * output_sig = radspa_signal_get_by_index(flanger, FLANGER_OUTPUT);
     if(output_sig->buffer == NULL) return;
     flanger_data_t * data = flanger->plugin_data;
-    int32_t * buf = (int32_t *) flanger->plugin_table;
     radspa_signal_t * input_sig = radspa_signal_get_by_index(flanger, FLANGER_INPUT);
     radspa_signal_t * manual_sig = radspa_signal_get_by_index(flanger, FLANGER_MANUAL);
     radspa_signal_t * reso_sig = radspa_signal_get_by_index(flanger, FLANGER_RESONANCE);
@@ -67,12 +65,21 @@ void flanger_run(radspa_t * flanger, uint16_t num_samples, uint32_t render_pass_
     int32_t decay = radspa_signal_get_value(decay_sig, 0, render_pass_id);
     int32_t dry_vol = (mix>0) ? (32767-mix) : (32767+mix); //always pos polarity
 
+    // the allpass needs at least 1.5 samples
+    uint32_t min_time = data->allpass ? (DELAY_LINE_ONE * 3)/2 : DELAY_LINE_ONE;
+    int16_t manual_const = radspa_signal_get_const_value(manual_sig, render_pass_id);
     int32_t manual = radspa_signal_get_value(manual_sig, 0, render_pass_id);
     if(manual != data->manual_prev){
-        int32_t manual_invert = ((2400*(FIXED_POINT_DIGITS)) - 7572) - manual; // magic numbers
-        uint32_t rho = radspa_sct_to_rel_freq(radspa_clip(manual_invert), 0);
-        if(rho > VARIABLE_NAME) rho = VARIABLE_NAME;
-        data->read_head_offset = rho;
+        data->read_head_offset = manual_to_time(manual);
+        uint32_t time = data->read_head_offset << (DELAY_LINE_FRAC_BITS - FIXED_POINT_DIGITS);
+        if(time < min_time) time = min_time;
+        if(data->manual_prev == 40000){
+            // first render, see flanger_create
+            delay_line_jump_time(&data->line, time);
+        } else if(manual_const != RADSPA_SIGNAL_NONCONST){
+            // glide to the new time, jumping would click
+            delay_line_set_time(&data->line, time, num_samples);
+        }
     }
     if(decay){
         int32_t sgn_decay = decay > 0 ? 1 : -1;
@@ -93,36 +100,43 @@ void flanger_run(radspa_t * flanger, uint16_t num_samples, uint32_t render_pass_
     }
     data->manual_prev = manual;
 
+    int16_t manual_sample_prev = RADSPA_SIGNAL_NONCONST;
     for(uint16_t i = 0; i < num_samples; i++){
         int32_t dry = radspa_signal_get_value(input_sig, i, render_pass_id);
 
-        data->write_head_position++;
-        while(data->write_head_position >= FLANGER_BUFFER_SIZE) data->write_head_position -= FLANGER_BUFFER_SIZE;
-        data->read_head_position = ((data->write_head_position)<<(FIXED_POINT_DIGITS));
-        data->read_head_position -= data->read_head_offset;
-        while(data->read_head_position < 0) data->read_head_position += VARIABLE_NAME; //underflow
-
-        buf[data->write_head_position] = dry;
-        int32_t wet = fixed_point_list_access(buf, data->read_head_position, FLANGER_BUFFER_SIZE) << 3;
+        if((manual_const == RADSPA_SIGNAL_NONCONST) && (manual_sig->buffer[i] != manual_sample_prev)){
+            // sct steps are coarse at long delay times, smooth out the staircase
+            manual_sample_prev = manual_sig->buffer[i];
+            uint32_t time = manual_to_time(manual_sample_prev) << (DELAY_LINE_FRAC_BITS - FIXED_POINT_DIGITS);
+            delay_line_set_time(&data->line, time < min_time ? min_time : time, FLANGER_SMOOTH_SAMPLES);
+        }
+        uint32_t time = delay_line_glide(&data->line);
+        int32_t wet = data->allpass ? delay_line_read_allpass(&data->line, time) : delay_line_read_linear(&data->line, time);
+        wet = wet << 3;
+        int32_t rec = dry;
         bool sgn_wet = wet > 0;
         bool sgn_reso = reso > 0;
         if(sgn_wet != sgn_reso){
-            buf[data->write_head_position] -= ((int64_t) (-wet) * reso) >> 32;
+            rec -= ((int64_t) (-wet) * reso) >> 32;
         } else {
-            buf[data->write_head_position] += ((int64_t) wet * reso) >> 32;
+            rec += ((int64_t) wet * reso) >> 32;
         }
+        delay_line_write(&data->line, radspa_clip(rec));
 
         int32_t ret = radspa_add_sat(radspa_mult_shift(dry, dry_vol), radspa_mult_shift(radspa_clip(wet), mix));
         ret = radspa_clip(radspa_gain(ret, level));
-        radspa_signal_set_value(output_sig, i, ret);
+        radspa_signal_set_value_check_const(output_sig, i, ret);
     }
 }
 
 radspa_t * flanger_create(uint32_t init_var){
+    uint32_t buffer_size = delay_line_buffer_len(FLANGER_BUFFER_SIZE);
     radspa_t * flanger = radspa_standard_plugin_create(&flanger_desc, FLANGER_NUM_SIGNALS, sizeof(flanger_data_t),
-                                                            2 * FLANGER_BUFFER_SIZE);
+                                                            buffer_size);
     if(flanger == NULL) return NULL;
     flanger_data_t * plugin_data = flanger->plugin_data;
+    delay_line_init(&plugin_data->line, flanger->plugin_table, buffer_size);
+    plugin_data->allpass = init_var == 1;
     plugin_data->manual_prev = 40000;
     flanger->render = flanger_run;
     radspa_signal_set(flanger, FLANGER_OUTPUT, "output", RADSPA_SIGNAL_HINT_OUTPUT, 0);
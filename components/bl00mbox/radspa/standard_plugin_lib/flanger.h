@@ -1,10 +1,11 @@
 #pragma once
 #include <radspa.h>
 #include <radspa_helpers.h>
+#include "delay_line.h"
 
 typedef struct {
-    uint32_t write_head_position;
-    int32_t read_head_position;
+    delay_line_t line;
+    bool allpass;
     int32_t read_head_offset;
     int32_t manual_prev;
     int32_t decay_reso;
@@ -96,7 +96,7 @@ void lowpass_run(radspa_t * lowpass, uint16_t num_samples, uint32_t render_pass_
 
         ret = ret >> (LOWPASS_INTERNAL_SHIFT);
         ret = radspa_clip(radspa_gain(ret, gain));
-        radspa_signal_set_value(output_sig, i, ret);
+        radspa_signal_set_value_check_const(output_sig, i, ret);
     }
 }
 
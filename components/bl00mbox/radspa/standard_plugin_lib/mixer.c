@@ -3,77 +3,133 @@
 radspa_descriptor_t mixer_desc = {
     .name = "mixer",
     .id = 21,
-    .description = "sums input and applies output gain\n  init_var: number of inputs, 1-127, default 4",
+    .description = "sums input and applies output gain. gain changes ramp over one block."
+                   "\n  init_var: number of inputs, 1-127, default 4",
     .create_plugin_instance = mixer_create,
     .destroy_plugin_instance = radspa_standard_plugin_destroy
 };
 
+/* the mixer sits at the root of most patches, so it gets kernels of its own: every input is
+ * summed into an int32_t buffer by a loop that works on the input buffer directly, with one
+ * kernel per kind of gain so that no loop has to check anything per sample. constant inputs
+ * at constant gain don't need a loop at all, they're summed up in a single value that joins
+ * in at the output stage.
+ *
+ * a gain that is set to a new value between two render calls ramps linearly from the old to
+ * the new value over the block, which avoids the zipper noise of gains that jump once per
+ * block. this only applies to gains that aren't connected (buffer == NULL): connected gains
+ * and timestamped events are followed sample by sample, and whether a connected gain looks
+ * constant may not make a difference.
+ */
+
+// ramps are calculated with this many fractional bits
+#define MIXER_RAMP_SHIFT 14
+
+static inline int16_t mixer_gain_prev(radspa_signal_t * gain_sig){
+    /// what the next render call ramps from
+    return gain_sig->buffer == NULL ? gain_sig->value : RADSPA_SIGNAL_NONCONST;
+}
+
+static inline int32_t mixer_ramp_step(int32_t gain_prev, int32_t gain, uint16_t num_samples){
+    return ((gain - gain_prev) * (1L<<MIXER_RAMP_SHIFT)) / num_samples;
+}
+
+static inline void mixer_add(int32_t * ret, const int16_t * in, uint16_t num_samples, bool init){
+    if(init){
+        for(uint16_t i = 0; i < num_samples; i++) ret[i] = in[i];
+    } else {
+        for(uint16_t i = 0; i < num_samples; i++) ret[i] += in[i];
+    }
+}
+
+static inline void mixer_sub(int32_t * ret, const int16_t * in, uint16_t num_samples, bool init){
+    if(init){
+        for(uint16_t i = 0; i < num_samples; i++) ret[i] = -in[i];
+    } else {
+        for(uint16_t i = 0; i < num_samples; i++) ret[i] -= in[i];
+    }
+}
+
+static inline void mixer_add_gain(int32_t * ret, const int16_t * in, int32_t gain, uint16_t num_samples, bool init){
+    if(init){
+        for(uint16_t i = 0; i < num_samples; i++) ret[i] = (gain * in[i]) >> 12;
+    } else {
+        for(uint16_t i = 0; i < num_samples; i++) ret[i] += (gain * in[i]) >> 12;
+    }
+}
+
+// in_mask is 0 for constant inputs, which only have valid data at [0]
+
+static inline void mixer_add_gain_buffer(int32_t * ret, const int16_t * in, uint16_t in_mask,
+                const int16_t * gain, uint16_t num_samples, bool init){
+    if(init){
+        for(uint16_t i = 0; i < num_samples; i++) ret[i] = (gain[i] * in[i & in_mask]) >> 12;
+    } else {
+        for(uint16_t i = 0; i < num_samples; i++) ret[i] += (gain[i] * in[i & in_mask]) >> 12;
+    }
+}
+
+static inline void mixer_add_gain_ramp(int32_t * ret, const int16_t * in, uint16_t in_mask,
+                int32_t gain_prev, int32_t gain, uint16_t num_samples, bool init){
+    if(init){
+        for(uint16_t i = 0; i < num_samples; i++) ret[i] = 0;
+    }
+    int32_t step = mixer_ramp_step(gain_prev, gain, num_samples);
+    int32_t acc = gain_prev * (1L<<MIXER_RAMP_SHIFT);
+    uint16_t last = num_samples - 1;
+    for(uint16_t i = 0; i < last; i++){
+        acc += step;
+        ret[i] += ((acc >> MIXER_RAMP_SHIFT) * in[i & in_mask]) >> 12;
+    }
+    // hit the new gain exactly, the steps are rounded
+    ret[last] += (gain * in[last & in_mask]) >> 12;
+}
+
 void mixer_run(radspa_t * mixer, uint16_t num_samples, uint32_t render_pass_id){
     mixer_data_t * data = mixer->plugin_data;
 
     int32_t ret[num_samples];
     bool ret_init = false;
-
-    radspa_signal_t * input_sigs[data->num_inputs];
-    radspa_signal_t * input_gain_sigs[data->num_inputs];
+    // sum of all constant inputs at constant gain
+    int32_t ret_const = 0;
 
     for(uint8_t j = 0; j < data->num_inputs; j++){
-        input_sigs[j] = radspa_signal_get_by_index(mixer, 3+2*j);
-        input_gain_sigs[j] = radspa_signal_get_by_index(mixer, 4+2*j);
-    }
+        radspa_signal_t * input_sig = radspa_signal_get_by_index(mixer, 3+2*j);
+        radspa_signal_t * input_gain_sig = radspa_signal_get_by_index(mixer, 4+2*j);
+        int16_t input_gain_const = radspa_signal_get_const_value(input_gain_sig, render_pass_id);
+        int16_t input_const = radspa_signal_get_const_value(input_sig, render_pass_id);
 
-    for(uint8_t j = 0; j < data->num_inputs; j++){
-        int32_t input_gain_const = radspa_signal_get_const_value(input_gain_sigs[j], render_pass_id);
-        int32_t input_const = radspa_signal_get_const_value(input_sigs[j], render_pass_id);
-        if(!(input_const && input_gain_const)) continue; // if either is zero there's nothing to do
-
-        if(input_gain_const == RADSPA_SIGNAL_VAL_UNITY_GAIN){
-            if(ret_init){
-                for(uint16_t i = 0; i < num_samples; i++){
-                    ret[i] += radspa_signal_get_value(input_sigs[j], i, render_pass_id);
-                }
-            } else {
-                for(uint16_t i = 0; i < num_samples; i++){
-                    ret[i] = radspa_signal_get_value(input_sigs[j], i, render_pass_id);
-                }
-                ret_init = true;
-            }
-        } else if(input_gain_const == -RADSPA_SIGNAL_VAL_UNITY_GAIN){
-            if(ret_init){
-                for(uint16_t i = 0; i < num_samples; i++){
-                    ret[i] -= radspa_signal_get_value(input_sigs[j], i, render_pass_id);
-                }
-            } else {
-                for(uint16_t i = 0; i < num_samples; i++){
-                    ret[i] = -radspa_signal_get_value(input_sigs[j], i, render_pass_id);
-                }
-                ret_init = true;
-            }
+        int16_t gain_prev = data->input_gain_prev[j];
+        data->input_gain_prev[j] = mixer_gain_prev(input_gain_sig);
+        bool ramp = (input_gain_sig->buffer == NULL) && (gain_prev != RADSPA_SIGNAL_NONCONST)
+                    && (gain_prev != input_gain_const);
+
+        // if either is zero there's nothing to do
+        if(!input_const) continue;
+        if(!(input_gain_const || ramp)) continue;
+
+        const int16_t * in = &input_const;
+        uint16_t in_mask = 0;
+        if(input_const == RADSPA_SIGNAL_NONCONST){
+            in = input_sig->buffer;
+            in_mask = 0xFFFF;
+        }
+
+        if(ramp){
+            mixer_add_gain_ramp(ret, in, in_mask, gain_prev, input_gain_const, num_samples, !ret_init);
         } else if(input_gain_const == RADSPA_SIGNAL_NONCONST){
-            if(ret_init){
-                for(uint16_t i = 0; i < num_samples; i++){
-                    int32_t input_gain = radspa_signal_get_value(input_gain_sigs[j], i, render_pass_id);
-                    ret[i] += (input_gain * radspa_signal_get_value(input_sigs[j], i, render_pass_id)) >> 12;
-                }
-            } else {
-                for(uint16_t i = 0; i < num_samples; i++){
-                    int32_t input_gain = radspa_signal_get_value(input_gain_sigs[j], i, render_pass_id);
-                    ret[i] = (input_gain * radspa_signal_get_value(input_sigs[j], i, render_pass_id)) >> 12;
-                }
-                ret_init = true;
-            }
+            mixer_add_gain_buffer(ret, in, in_mask, input_gain_sig->buffer, num_samples, !ret_init);
+        } else if(!in_mask){
+            ret_const += (input_gain_const * input_const) >> 12;
+            continue;
+        } else if(input_gain_const == RADSPA_SIGNAL_VAL_UNITY_GAIN){
+            mixer_add(ret, in, num_samples, !ret_init);
+        } else if(input_gain_const == -RADSPA_SIGNAL_VAL_UNITY_GAIN){
+            mixer_sub(ret, in, num_samples, !ret_init);
         } else {
-            if(ret_init){
-                for(uint16_t i = 0; i < num_samples; i++){
-                    ret[i] += (input_gain_const * radspa_signal_get_value(input_sigs[j], i, render_pass_id)) >> 12;
-                }
-            } else {
-                for(uint16_t i = 0; i < num_samples; i++){
-                    ret[i] = (input_gain_const * radspa_signal_get_value(input_sigs[j], i, render_pass_id)) >> 12;
-                }
-                ret_init = true;
-            }
+            mixer_add_gain(ret, in, input_gain_const, num_samples, !ret_init);
         }
+        ret_init = true;
     }
 
     radspa_signal_t * output_sig = radspa_signal_get_by_index(mixer, 0);
@@ -81,56 +137,66 @@ void mixer_run(radspa_t * mixer, uint16_t num_samples, uint32_t render_pass_id){
     radspa_signal_t * block_dc_sig = radspa_signal_get_by_index(mixer, 2);
     bool block_dc = radspa_signal_get_value(block_dc_sig, 0, render_pass_id) > 0;
 
-    if(block_dc){
-        if(ret_init){
-            for(uint16_t i = 0; i < num_samples; i++){
-                bool invert = data->dc < 0;
-                if(invert) data->dc = -data->dc;
-                data->dc = ((uint64_t) data->dc * (((1UL<<12) - 1)<<20)) >> 32;
-                if(invert) data->dc = -data->dc;
-                data->dc += ret[i];
-                ret[i] -= (data->dc >> 12);
-            }
-        } else {
-            if(data->dc){
-                for(uint16_t i = 0; i < num_samples; i++){
-                    bool invert = data->dc < 0;
-                    if(invert) data->dc = -data->dc;
-                    data->dc = ((uint64_t) data->dc * (((1UL<<12) - 1)<<20)) >> 32;
-                    if(invert) data->dc = -data->dc;
-                    ret[i] = -(data->dc >> 12);
-                    ret_init = true;
-                }
-            }
+    int16_t gain_const = radspa_signal_get_const_value(gain_sig, render_pass_id);
+    int16_t gain_prev = data->gain_prev;
+    data->gain_prev = mixer_gain_prev(gain_sig);
+    bool ramp = (gain_sig->buffer == NULL) && (gain_prev != RADSPA_SIGNAL_NONCONST) && (gain_prev != gain_const);
+
+    if(!ret_init){
+        bool dc_active = block_dc && (ret_const || data->dc);
+        if(!(dc_active || ramp || gain_const == RADSPA_SIGNAL_NONCONST)){
+            radspa_signal_set_const_value(output_sig, (ret_const * gain_const) >> 12);
+            return;
         }
+        for(uint16_t i = 0; i < num_samples; i++) ret[i] = ret_const;
+    } else if(ret_const){
+        for(uint16_t i = 0; i < num_samples; i++) ret[i] += ret_const;
     }
 
-    if(ret_init){
-        int16_t gain_const = radspa_signal_get_const_value(gain_sig, render_pass_id);
-        int32_t gain = gain_const;
-        if(gain_const != RADSPA_SIGNAL_VAL_UNITY_GAIN){
-            for(uint16_t i = 0; i < num_samples; i++){
-                if(gain_const == RADSPA_SIGNAL_NONCONST) gain = radspa_signal_get_value(gain_sig, i, render_pass_id);
-                ret[i] = (ret[i] * gain) >> 12;
-            }
+    if(block_dc){
+        for(uint16_t i = 0; i < num_samples; i++){
+            bool invert = data->dc < 0;
+            if(invert) data->dc = -data->dc;
+            data->dc = ((uint64_t) data->dc * (((1UL<<12) - 1)<<20)) >> 32;
+            if(invert) data->dc = -data->dc;
+            data->dc += ret[i];
+            ret[i] -= (data->dc >> 12);
         }
+    }
 
-        for(uint16_t i = 0; i < num_samples; i++){
-            radspa_signal_set_value_check_const(output_sig, i, ret[i]);
+    if(ramp){
+        int32_t step = mixer_ramp_step(gain_prev, gain_const, num_samples);
+        int32_t acc = gain_prev * (1L<<MIXER_RAMP_SHIFT);
+        uint16_t last = num_samples - 1;
+        for(uint16_t i = 0; i < last; i++){
+            acc += step;
+            ret[i] = (ret[i] * (acc >> MIXER_RAMP_SHIFT)) >> 12;
         }
-    } else {
-        radspa_signal_set_const_value(output_sig, 0);
+        ret[last] = (ret[last] * gain_const) >> 12;
+    } else if(gain_const == RADSPA_SIGNAL_NONCONST){
+        for(uint16_t i = 0; i < num_samples; i++) ret[i] = (ret[i] * gain_sig->buffer[i]) >> 12;
+    } else if(gain_const != RADSPA_SIGNAL_VAL_UNITY_GAIN){
+        for(uint16_t i = 0; i < num_samples; i++) ret[i] = (ret[i] * gain_const) >> 12;
+    }
+
+    for(uint16_t i = 0; i < num_samples; i++){
+        radspa_signal_set_value_check_const(output_sig, i, ret[i]);
     }
 }
 
 radspa_t * mixer_create(uint32_t init_var){
     if(init_var == 0) init_var = 4;
     if(init_var > 127) init_var = 127;
-    radspa_t * mixer = radspa_standard_plugin_create(&mixer_desc, 3 + 2* init_var, sizeof(mixer_data_t), 0);
+    radspa_t * mixer = radspa_standard_plugin_create(&mixer_desc, 3 + 2* init_var,
+                sizeof(mixer_data_t) + init_var * sizeof(int16_t), 0);
     if(mixer == NULL) return NULL;
     mixer->render = mixer_run;
     mixer_data_t * data = mixer->plugin_data;
     data->num_inputs = init_var;
+    data->input_gain_prev = (int16_t *) &(data[1]);
+    // the first render call starts at whatever gains were set up by then
+    data->gain_prev = RADSPA_SIGNAL_NONCONST;
+    for(uint8_t j = 0; j < data->num_inputs; j++) data->input_gain_prev[j] = RADSPA_SIGNAL_NONCONST;
 
     radspa_signal_set(mixer, 0, "output", RADSPA_SIGNAL_HINT_OUTPUT, 0);
     radspa_signal_set(mixer, 1, "gain", RADSPA_SIGNAL_HINT_INPUT | RADSPA_SIGNAL_HINT_GAIN, RADSPA_SIGNAL_VAL_UNITY_GAIN/init_var);
@@ -5,9 +5,13 @@
 typedef struct {
     int32_t dc;
     uint8_t num_inputs;
+    // unconnected gains of the last render call, changes ramp from there over one block.
+    // RADSPA_SIGNAL_NONCONST if there's nothing to ramp from.
+    int16_t gain_prev;
+    // num_inputs entries, lives right behind this struct
+    int16_t * input_gain_prev;
 } mixer_data_t;
 
 extern radspa_descriptor_t mixer_desc;
 radspa_t * mixer_create(uint32_t init_var);
 void mixer_run(radspa_t * osc, uint16_t num_samples, uint32_t render_pass_id);
-
@@ -33,7 +33,7 @@ void noise_burst_run(radspa_t * noise_burst, uint16_t num_samples, uint32_t rend
 
     int16_t trigger = radspa_signal_get_const_value(trigger_sig, render_pass_id);
     bool trigger_const = trigger != RADSPA_SIGNAL_NONCONST;
-    int16_t vel = radspa_trigger_get(trigger, &(plugin_data->trigger_prev));
+    int16_t vel = trigger_const ? radspa_trigger_get(trigger, &(plugin_data->trigger_prev)) : 0;
 
     bool output_const = plugin_data->counter == plugin_data->limit;
 
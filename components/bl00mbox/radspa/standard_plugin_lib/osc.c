@@ -174,11 +174,12 @@ int16_t poly_blep_saw(int32_t input, int32_t incr){
 }
 */
 
-static inline void get_ringmod_coeffs(osc_data_t * data, int16_t pitch, int32_t morph, int32_t waveform){
+static inline void get_ringmod_coeffs(osc_data_t * data, int16_t pitch, const uint32_t * pitch_rel_freq, int32_t morph, int32_t waveform){
     int32_t morph_gate = data->morph_gate_prev;
     bool morph_no_pwm = data->morph_no_pwm_prev;
     if(pitch != data->pitch_prev){
-        data->pitch_coeffs[0] = radspa_sct_to_rel_freq(pitch, 0);
+        // nonconst pitch comes converted for the whole block
+        data->pitch_coeffs[0] = pitch_rel_freq == NULL ? radspa_sct_to_rel_freq(pitch, 0) : (* pitch_rel_freq);
         morph_gate = 30700 - (data->pitch_coeffs[0]>>12); // "anti" "aliasing"
         if(morph_gate < 0) morph_gate = 0;
         data->pitch_prev = pitch;
@@ -312,7 +313,7 @@ static inline int16_t apply_waveform(osc_data_t * data, int16_t input, int32_t i
     if(!pitch_const) pitch = radspa_signal_get_value(pitch_sig, i, render_pass_id); \
     if(!morph_const) morph = radspa_signal_get_value(morph_sig, i, render_pass_id); \
     if(!waveform_const) waveform = radspa_signal_get_value(waveform_sig, i, render_pass_id); \
-    get_ringmod_coeffs(data, pitch, morph, waveform); \
+    get_ringmod_coeffs(data, pitch, pitch_const ? NULL : &(pitch_rel_freq[i]), morph, waveform); \
 }
 
 #define FM_READ { \
@@ -382,8 +383,21 @@ void osc_run(radspa_t * osc, uint16_t num_samples, uint32_t render_pass_id){
     bool lfo = speed < -10922; // manual setting
     lfo = lfo || (out_const && sync_out_const); // unlikely, host should ideally prevent that case
 
+    bool waveform_const = waveform != RADSPA_SIGNAL_NONCONST;
+    bool morph_const = morph != RADSPA_SIGNAL_NONCONST;
+    bool sync_in_phase_const = sync_in_phase != RADSPA_SIGNAL_NONCONST;
+    bool fm_const = fm != RADSPA_SIGNAL_NONCONST;
+    bool pitch_const = pitch != RADSPA_SIGNAL_NONCONST;
+    bool sync_in_const = sync_in != RADSPA_SIGNAL_NONCONST;
+
+    uint32_t pitch_rel_freq[pitch_const ? 1 : num_samples];
+    if(!pitch_const) radspa_sct_to_rel_freq_buffer(pitch_sig->buffer, pitch_rel_freq, num_samples, 0);
+
     {
-        get_ringmod_coeffs(data, pitch, morph, waveform);
+        // first sample of nonconst inputs, the marker itself is no valid value
+        uint16_t i = 0;
+        RINGMOD_READ
+        FM_READ
         lfo = lfo || ((speed < 10922) && (data->pitch_coeffs[0] < 1789569)); // auto mode below 20Hz
 
         OSCILLATE
@@ -406,13 +420,6 @@ void osc_run(radspa_t * osc, uint16_t num_samples, uint32_t render_pass_id){
 
     if(!lfo){
         uint16_t i = 1; // incrementing variable for megaswitch for loop
-        bool waveform_const = waveform != RADSPA_SIGNAL_NONCONST;
-        bool morph_const = morph != RADSPA_SIGNAL_NONCONST;
-        bool sync_in_phase_const = sync_in_phase != RADSPA_SIGNAL_NONCONST;
-        bool fm_const = fm != RADSPA_SIGNAL_NONCONST;
-        bool pitch_const = pitch != RADSPA_SIGNAL_NONCONST;
-        bool sync_in_const = sync_in != RADSPA_SIGNAL_NONCONST;
-
         bool ringmod_const = pitch_const && morph_const && waveform_const;
         bool oscmod_const = fm_const && sync_in_const;
 
@@ -446,6 +453,8 @@ radspa_t * osc_create(uint32_t init_var){
     data->pitch_prev = -32768;
     data->morph_prev = -32768;
     data->waveform_prev = -32768;
-    data->morph_gate_prev = -32768;
+    // must never be negative: if pitch is nonconst from the very first block on the
+    // gate isn't recomputed before morph is clamped to it
+    data->morph_gate_prev = 0;
     return osc;
 }
@@ -0,0 +1,188 @@
+#include "osc_bank.h"
+
+radspa_descriptor_t osc_bank_desc = {
+    .name = "osc_bank",
+    .id = 421,
+    .description = "a number of simple oscillators with a shared waveform, rendered together at a fraction of "
+                   "the cost of one osc per voice. for additive patches and organs. each voice has its own "
+                   "output, output sums them all up. no antialiasing, sine is recommended for high pitches."
+                   "\ninit_var: number of voices, 1-64, default 8",
+    .create_plugin_instance = osc_bank_create,
+    .destroy_plugin_instance = radspa_standard_plugin_destroy
+};
+
+#define OSC_BANK_NUM_SIGNALS 3
+#define OSC_BANK_OUTPUT 0
+#define OSC_BANK_GAIN 1
+#define OSC_BANK_WAVEFORM 2
+
+#define OSC_BANK_NUM_MPX 3
+#define OSC_BANK_VOICE_OUTPUT 3
+#define OSC_BANK_PITCH 4
+#define OSC_BANK_VOICE_GAIN 5
+
+#define OSC_BANK_MAX_VOICES 64
+
+// waveshapers take the oscillator phase as a saw in [-32768..32767] and don't branch
+
+static inline int16_t triangle(int16_t saw){
+    int16_t tri = saw - 16384;
+    tri ^= tri >> 15;
+    return 32767 - 2 * tri;
+}
+
+static inline int16_t parabolic_sine(int16_t saw){
+    // approximates sin(pi*saw/32768) by 4*x*(1-|x|)
+    int32_t abs = saw ^ (saw >> 15);
+    return (saw * (32767 - abs)) >> 13;
+}
+
+void osc_bank_run(radspa_t * osc_bank, uint16_t num_samples, uint32_t render_pass_id){
+    osc_bank_data_t * data = osc_bank->plugin_data;
+    radspa_signal_t * output_sig = radspa_signal_get_by_index(osc_bank, OSC_BANK_OUTPUT);
+    radspa_signal_t * gain_sig = radspa_signal_get_by_index(osc_bank, OSC_BANK_GAIN);
+    radspa_signal_t * waveform_sig = radspa_signal_get_by_index(osc_bank, OSC_BANK_WAVEFORM);
+
+    // same ranges as osc_fm: sine, triangle, square, saw from low to high
+    uint8_t shape = ((((uint16_t) radspa_signal_get_value(waveform_sig, 0, render_pass_id)) >> 14) + 2) & 3;
+    bool sum = output_sig->buffer != NULL;
+    int32_t acc[sum ? num_samples : 1];
+    bool acc_init = false;
+    int16_t voice[num_samples];
+    uint32_t rel_freq[num_samples];
+
+    for(uint8_t j = 0; j < data->num_voices; j++){
+        radspa_signal_t * voice_output_sig = radspa_signal_get_by_index(osc_bank, OSC_BANK_VOICE_OUTPUT + OSC_BANK_NUM_MPX * j);
+        radspa_signal_t * pitch_sig = radspa_signal_get_by_index(osc_bank, OSC_BANK_PITCH + OSC_BANK_NUM_MPX * j);
+        radspa_signal_t * voice_gain_sig = radspa_signal_get_by_index(osc_bank, OSC_BANK_VOICE_GAIN + OSC_BANK_NUM_MPX * j);
+        bool voice_out = voice_output_sig->buffer != NULL;
+        int16_t voice_gain = radspa_signal_get_const_value(voice_gain_sig, render_pass_id);
+        int16_t pitch = radspa_signal_get_const_value(pitch_sig, render_pass_id);
+        bool pitch_const = pitch != RADSPA_SIGNAL_NONCONST;
+
+        if(pitch_const){
+            if(pitch != data->pitch_prev[j]){
+                data->incr[j] = radspa_sct_to_rel_freq(pitch, 0);
+                data->pitch_prev[j] = pitch;
+            }
+        } else {
+            radspa_sct_to_rel_freq_buffer(pitch_sig->buffer, rel_freq, num_samples, 0);
+            data->incr[j] = rel_freq[num_samples - 1];
+            data->pitch_prev[j] = pitch_sig->buffer[num_samples - 1];
+        }
+
+        if((!voice_gain) || (!(voice_out || sum))){
+            // nobody gets to hear it, only keep the phase going
+            if(pitch_const){
+                data->counter[j] += data->incr[j] * num_samples;
+            } else {
+                for(uint16_t i = 0; i < num_samples; i++) data->counter[j] += rel_freq[i];
+            }
+            if(voice_out) radspa_signal_set_const_value(voice_output_sig, 0);
+            continue;
+        }
+
+        uint32_t counter = data->counter[j];
+        if(pitch_const){
+            uint32_t incr = data->incr[j];
+            for(uint16_t i = 0; i < num_samples; i++){
+                counter += incr;
+                voice[i] = (counter >> 16) - 32768;
+            }
+        } else {
+            for(uint16_t i = 0; i < num_samples; i++){
+                counter += rel_freq[i];
+                voice[i] = (counter >> 16) - 32768;
+            }
+        }
+        data->counter[j] = counter;
+
+        switch(shape){
+            case 0:
+                for(uint16_t i = 0; i < num_samples; i++) voice[i] = parabolic_sine(voice[i]);
+                break;
+            case 1:
+                for(uint16_t i = 0; i < num_samples; i++) voice[i] = triangle(voice[i]);
+                break;
+            case 2:
+                for(uint16_t i = 0; i < num_samples; i++) voice[i] = voice[i] >= 0 ? 32767 : -32767;
+                break;
+            default: // saw
+                break;
+        }
+
+        if(voice_gain == RADSPA_SIGNAL_NONCONST){
+            for(uint16_t i = 0; i < num_samples; i++){
+                int32_t gain = radspa_signal_get_value(voice_gain_sig, i, render_pass_id);
+                voice[i] = radspa_clip((voice[i] * gain) >> 12);
+            }
+        } else if((voice_gain > RADSPA_SIGNAL_VAL_UNITY_GAIN) || (voice_gain < -RADSPA_SIGNAL_VAL_UNITY_GAIN)){
+            for(uint16_t i = 0; i < num_samples; i++){
+                voice[i] = radspa_clip((voice[i] * voice_gain) >> 12);
+            }
+        } else if(voice_gain != RADSPA_SIGNAL_VAL_UNITY_GAIN){
+            // can't clip
+            for(uint16_t i = 0; i < num_samples; i++){
+                voice[i] = (voice[i] * voice_gain) >> 12;
+            }
+        }
+
+        if(voice_out){
+            for(uint16_t i = 0; i < num_samples; i++) voice_output_sig->buffer[i] = voice[i];
+        }
+        if(sum){
+            if(acc_init){
+                for(uint16_t i = 0; i < num_samples; i++) acc[i] += voice[i];
+            } else {
+                for(uint16_t i = 0; i < num_samples; i++) acc[i] = voice[i];
+                acc_init = true;
+            }
+        }
+    }
+
+    if(!sum) return;
+    if(!acc_init){
+        radspa_signal_set_const_value(output_sig, 0);
+        return;
+    }
+    int16_t gain_const = radspa_signal_get_const_value(gain_sig, render_pass_id);
+    int32_t gain = gain_const;
+    for(uint16_t i = 0; i < num_samples; i++){
+        if(gain_const == RADSPA_SIGNAL_NONCONST) gain = radspa_signal_get_value(gain_sig, i, render_pass_id);
+        radspa_signal_set_value(output_sig, i, ((int64_t) acc[i] * gain) >> 12);
+    }
+}
+
+radspa_t * osc_bank_create(uint32_t init_var){
+    if(init_var == 0) init_var = 8;
+    if(init_var > OSC_BANK_MAX_VOICES) init_var = OSC_BANK_MAX_VOICES;
+    size_t voice_data_size = init_var * (2 * sizeof(uint32_t) + sizeof(int16_t));
+    radspa_t * osc_bank = radspa_standard_plugin_create(&osc_bank_desc, OSC_BANK_NUM_SIGNALS + OSC_BANK_NUM_MPX * init_var,
+                sizeof(osc_bank_data_t) + voice_data_size, 0);
+    if(osc_bank == NULL) return NULL;
+    osc_bank->render = osc_bank_run;
+
+    osc_bank_data_t * data = osc_bank->plugin_data;
+    data->num_voices = init_var;
+    data->counter = (uint32_t *) &(data[1]);
+    data->incr = &(data->counter[init_var]);
+    data->pitch_prev = (int16_t *) &(data->incr[init_var]);
+    for(uint8_t j = 0; j < init_var; j++){
+        // marker value, no const pitch ever looks like that
+        data->pitch_prev[j] = RADSPA_SIGNAL_NONCONST;
+    }
+
+    radspa_signal_set(osc_bank, OSC_BANK_OUTPUT, "output", RADSPA_SIGNAL_HINT_OUTPUT, 0);
+    radspa_signal_set(osc_bank, OSC_BANK_GAIN, "gain", RADSPA_SIGNAL_HINT_INPUT | RADSPA_SIGNAL_HINT_GAIN,
+            RADSPA_SIGNAL_VAL_UNITY_GAIN/init_var);
+    radspa_signal_set(osc_bank, OSC_BANK_WAVEFORM, "waveform", RADSPA_SIGNAL_HINT_INPUT, -32767);
+    radspa_signal_get_by_index(osc_bank, OSC_BANK_WAVEFORM)->unit = "{SINE:-32767} {TRI:-10922} {SQUARE:10922} {SAW:32767}";
+
+    radspa_signal_set_group(osc_bank, init_var, OSC_BANK_NUM_MPX, OSC_BANK_VOICE_OUTPUT, "voice_output",
+            RADSPA_SIGNAL_HINT_OUTPUT, 0);
+    radspa_signal_set_group(osc_bank, init_var, OSC_BANK_NUM_MPX, OSC_BANK_PITCH, "pitch",
+            RADSPA_SIGNAL_HINT_INPUT | RADSPA_SIGNAL_HINT_SCT, RADSPA_SIGNAL_VAL_SCT_A440);
+    radspa_signal_set_group(osc_bank, init_var, OSC_BANK_NUM_MPX, OSC_BANK_VOICE_GAIN, "voice_gain",
+            RADSPA_SIGNAL_HINT_INPUT | RADSPA_SIGNAL_HINT_GAIN, RADSPA_SIGNAL_VAL_UNITY_GAIN);
+    return osc_bank;
+}
@@ -0,0 +1,15 @@
+#pragma once
+#include <radspa.h>
+#include <radspa_helpers.h>
+
+typedef struct {
+    uint8_t num_voices;
+    // per voice state, num_voices entries each. lives right behind this struct.
+    uint32_t * counter;
+    uint32_t * incr;
+    int16_t * pitch_prev;
+} osc_bank_data_t;
+
+extern radspa_descriptor_t osc_bank_desc;
+radspa_t * osc_bank_create(uint32_t init_var);
+void osc_bank_run(radspa_t * osc_bank, uint16_t num_samples, uint32_t render_pass_id);
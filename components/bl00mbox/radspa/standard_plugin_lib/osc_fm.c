@@ -97,6 +97,9 @@ void osc_fm_run(radspa_t * osc_fm, uint16_t num_samples, uint32_t render_pass_id
         }
     }
 
+    uint32_t pitch_rel_freq[pitch_const == -32768 ? num_samples : 1];
+    if(pitch_const == -32768) radspa_sct_to_rel_freq_buffer(data->pitch_sig->buffer, pitch_rel_freq, num_samples, 0);
+
     bool fm_thru_const = (pitch_const != -32768) && (fm_pitch_offset_const != -32768);
 
     if(fm_thru_const) radspa_signal_set_const_value(data->fm_pitch_thru_sig, pitch_const + fm_pitch_offset_const - RADSPA_SIGNAL_VAL_SCT_A440);
@@ -105,7 +108,7 @@ void osc_fm_run(radspa_t * osc_fm, uint16_t num_samples, uint32_t render_pass_id
         if(pitch_const == -32768){
             pitch = radspa_signal_get_value(data->pitch_sig, i, render_pass_id);
             if(pitch != data->prev_pitch){
-                data->incr = radspa_sct_to_rel_freq(pitch, 0);
+                data->incr = pitch_rel_freq[i];
                 data->prev_pitch = pitch;
             }
         }
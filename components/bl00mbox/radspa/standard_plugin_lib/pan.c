@@ -0,0 +1,127 @@
+#include "pan.h"
+
+radspa_descriptor_t pan_desc = {
+    .name = "pan",
+    .id = 22,
+    .description = "places a mono input in the stereo field, meant to feed the left and right side of "
+                   "the channel mixer. pan goes from -32767 (left) to 32767 (right), changes of an "
+                   "unconnected pan ramp over one block."
+                   "\ninit_var: pan law, 0: constant power (-3dB in the center), 1: linear (-6dB in the center)",
+    .create_plugin_instance = pan_create,
+    .destroy_plugin_instance = radspa_standard_plugin_destroy
+};
+
+#define PAN_NUM_SIGNALS 4
+#define PAN_OUTPUT_LEFT 0
+#define PAN_OUTPUT_RIGHT 1
+#define PAN_INPUT 2
+#define PAN_PAN 3
+
+#define PAN_LAW_CONSTANT_POWER 0
+#define PAN_LAW_LINEAR 1
+
+// ramps are calculated with this many fractional bits
+#define PAN_RAMP_SHIFT 14
+
+// quarter cosine in Q15, interpolated linearly
+// py: [round(32768*math.cos(math.pi/2*k/64)) for k in range(65)]
+static const int32_t pan_cos_table[65] = {
+    32768, 32758, 32729, 32679, 32610, 32522, 32413, 32286,
+    32138, 31972, 31786, 31581, 31357, 31114, 30853, 30572,
+    30274, 29957, 29622, 29269, 28899, 28511, 28106, 27684,
+    27246, 26791, 26320, 25833, 25330, 24812, 24279, 23732,
+    23170, 22595, 22006, 21403, 20788, 20160, 19520, 18868,
+    18205, 17531, 16846, 16151, 15447, 14733, 14010, 13279,
+    12540, 11793, 11039, 10279, 9512, 8740, 7962, 7180,
+    6393, 5602, 4808, 4011, 3212, 2411, 1608, 804,
+    0,
+};
+
+static inline int32_t pan_cos(uint32_t pos){
+    /// cos(pi/2 * pos/65536) in Q15 for pos in 1..65535
+    uint32_t index = pos >> 10;
+    int32_t frac = pos & 1023;
+    int32_t a = pan_cos_table[index];
+    return a + (((pan_cos_table[index + 1] - a) * frac) >> 10);
+}
+
+static inline void pan_gains(int32_t pan, uint8_t law, int32_t * left, int32_t * right){
+    /// left and right gain in Q15
+    if(pan < -32767) pan = -32767;
+    uint32_t pos = pan + 32768;
+    if(law == PAN_LAW_LINEAR){
+        (* left) = (65536 - pos) >> 1;
+        (* right) = pos >> 1;
+    } else {
+        (* left) = pan_cos(pos);
+        (* right) = pan_cos(65536 - pos);
+    }
+}
+
+void pan_run(radspa_t * pan, uint16_t num_samples, uint32_t render_pass_id){
+    radspa_signal_t * left_sig = radspa_signal_get_by_index(pan, PAN_OUTPUT_LEFT);
+    radspa_signal_t * right_sig = radspa_signal_get_by_index(pan, PAN_OUTPUT_RIGHT);
+    if((left_sig->buffer == NULL) && (right_sig->buffer == NULL)) return;
+    radspa_signal_t * input_sig = radspa_signal_get_by_index(pan, PAN_INPUT);
+    radspa_signal_t * pan_sig = radspa_signal_get_by_index(pan, PAN_PAN);
+    pan_data_t * data = pan->plugin_data;
+
+    int16_t input_const = radspa_signal_get_const_value(input_sig, render_pass_id);
+    int16_t pan_const = radspa_signal_get_const_value(pan_sig, render_pass_id);
+    int16_t pan_prev = data->pan_prev;
+    data->pan_prev = pan_sig->buffer == NULL ? pan_sig->value : RADSPA_SIGNAL_NONCONST;
+    bool ramp = (pan_prev != RADSPA_SIGNAL_NONCONST) && (pan_const != RADSPA_SIGNAL_NONCONST)
+                    && (pan_prev != pan_const) && (pan_sig->buffer == NULL);
+
+    int32_t left;
+    int32_t right;
+    if((pan_const != RADSPA_SIGNAL_NONCONST) && !ramp){
+        pan_gains(pan_const, data->law, &left, &right);
+        // nothing left to do for a stateless plugin with constant inputs
+        pan->idle = input_const != RADSPA_SIGNAL_NONCONST;
+        if(pan->idle){
+            radspa_signal_set_const_value(left_sig, (input_const * left) >> 15);
+            radspa_signal_set_const_value(right_sig, (input_const * right) >> 15);
+            return;
+        }
+        for(uint16_t i = 0; i < num_samples; i++){
+            int32_t input = input_sig->buffer[i];
+            radspa_signal_set_value(left_sig, i, (input * left) >> 15);
+            radspa_signal_set_value(right_sig, i, (input * right) >> 15);
+        }
+        return;
+    }
+    pan->idle = false;
+
+    int32_t ramp_pos = pan_prev * (1L<<PAN_RAMP_SHIFT);
+    int32_t ramp_step = 0;
+    if(ramp) ramp_step = ((pan_const - pan_prev) * (1L<<PAN_RAMP_SHIFT)) / num_samples;
+    for(uint16_t i = 0; i < num_samples; i++){
+        int32_t p;
+        if(ramp){
+            ramp_pos += ramp_step;
+            p = (i == num_samples - 1) ? pan_const : (ramp_pos >> PAN_RAMP_SHIFT);
+        } else {
+            p = radspa_signal_get_value(pan_sig, i, render_pass_id);
+        }
+        pan_gains(p, data->law, &left, &right);
+        int32_t input = radspa_signal_get_value(input_sig, i, render_pass_id);
+        radspa_signal_set_value(left_sig, i, (input * left) >> 15);
+        radspa_signal_set_value(right_sig, i, (input * right) >> 15);
+    }
+}
+
+radspa_t * pan_create(uint32_t init_var){
+    radspa_t * pan = radspa_standard_plugin_create(&pan_desc, PAN_NUM_SIGNALS, sizeof(pan_data_t), 0);
+    if(pan == NULL) return NULL;
+    pan->render = pan_run;
+    pan_data_t * data = pan->plugin_data;
+    data->law = init_var == PAN_LAW_LINEAR ? PAN_LAW_LINEAR : PAN_LAW_CONSTANT_POWER;
+    data->pan_prev = RADSPA_SIGNAL_NONCONST;
+
+    radspa_signal_set(pan, PAN_OUTPUT_LEFT, "output_left", RADSPA_SIGNAL_HINT_OUTPUT, 0);
+    radspa_signal_set(pan, PAN_OUTPUT_RIGHT, "output_right", RADSPA_SIGNAL_HINT_OUTPUT, 0);
+    radspa_signal_set(pan, PAN_INPUT, "input", RADSPA_SIGNAL_HINT_INPUT, 0);
+    radspa_signal_set(pan, PAN_PAN, "pan", RADSPA_SIGNAL_HINT_INPUT, 0);
+    return pan;
+}
@@ -0,0 +1,14 @@
+#pragma once
+#include <radspa.h>
+#include <radspa_helpers.h>
+
+typedef struct {
+    uint8_t law;
+    // unconnected pan of the last render call, changes ramp from there over one block.
+    // RADSPA_SIGNAL_NONCONST if there's nothing to ramp from.
+    int16_t pan_prev;
+} pan_data_t;
+
+extern radspa_descriptor_t pan_desc;
+radspa_t * pan_create(uint32_t init_var);
+void pan_run(radspa_t * pan, uint16_t num_samples, uint32_t render_pass_id);
@@ -0,0 +1,219 @@
+#include "reverb.h"
+
+radspa_descriptor_t reverb_desc = {
+    .name = "reverb",
+    .id = 3200,
+    .description = "feedback delay network reverb with 8 lines. decay is the time in ms it takes the tail "
+                   "to fall by 60dB, damping makes high frequencies die out faster."
+                   "\ninit_var: room size in percent, 10-200, default 100. memory use grows with it, "
+                   "about 30KB at 100",
+    .create_plugin_instance = reverb_create,
+    .destroy_plugin_instance = radspa_standard_plugin_destroy
+};
+
+#define REVERB_NUM_SIGNALS 6
+#define REVERB_OUTPUT 0
+#define REVERB_INPUT 1
+#define REVERB_DECAY 2
+#define REVERB_DAMPING 3
+#define REVERB_DRY_GAIN 4
+#define REVERB_WET_GAIN 5
+
+/* cpu budget: ~5% of a core, i.e. 250 cycles per sample at 240MHz/48kHz.
+ *
+ * all per sample work is integer: 8 masked ring buffer reads and writes, a one-pole lowpass
+ * per line, an 8 point hadamard transform (24 adds, no multiplies) and one multiply per line
+ * for the feedback gain, roughly 25-30 instructions per line on xtensa. everything else is
+ * recomputed at most once per block. more lines or interpolated reads won't fit. the host bench
+ * (bl00mbox_bench -f reverb) is where to keep an eye on it, compare against delay_static.
+ *
+ * the lines are mixed by the hadamard matrix scaled by 1/sqrt(8), which is orthogonal, so
+ * with feedback gains below 1 the network always decays. lowpass and feedback round toward
+ * zero so that the tail dies out completely instead of getting stuck in a small limit cycle,
+ * which is what allows the plugin to go idle.
+ */
+
+// line lengths in samples at size 100, all primes between ~21 and ~42ms
+static const uint16_t reverb_base_len[REVERB_NUM_LINES] = {
+    1009, 1151, 1289, 1439, 1583, 1721, 1871, 2017
+};
+
+// which lines get the input and feed the output with inverted polarity, one bit per line.
+// neither is a row of the hadamard matrix, else the input would only excite a single line
+// on its first pass.
+#define REVERB_INPUT_SIGNS 0xE8
+#define REVERB_OUTPUT_SIGNS 0x4D
+
+// radspa_sct_to_rel_freq(x) == 16384/sqrt(8) == unity feedback gain incl. hadamard normalization
+#define REVERB_SCT_FEEDBACK_UNITY (-12186)
+
+static void reverb_set_decay(reverb_data_t * data, int32_t decay){
+    /// per pass through line k the tail must fall by 60dB * len[k] / (48 * decay), which is
+    /// 2400 * log2(1000) / 48 * len[k] / decay == 498.3 * len[k] / decay sct.
+    if(decay < 10) decay = 10;
+    for(uint8_t k = 0; k < REVERB_NUM_LINES; k++){
+        int32_t sct = REVERB_SCT_FEEDBACK_UNITY - (498 * (int32_t) data->len[k]) / decay;
+        if(sct < -32767) sct = -32767;
+        data->feedback[k] = radspa_sct_to_rel_freq(sct, 0);
+    }
+}
+
+static inline void reverb_hadamard(int32_t * h){
+    for(uint8_t span = 1; span < REVERB_NUM_LINES; span <<= 1){
+        for(uint8_t k = 0; k < REVERB_NUM_LINES; k++){
+            if(k & span) continue;
+            int32_t a = h[k];
+            int32_t b = h[k + span];
+            h[k] = a + b;
+            h[k + span] = a - b;
+        }
+    }
+}
+
+static bool reverb_is_silent(reverb_data_t * data){
+    /// the lines can only ever read back zeroes
+    if(data->quiet < data->max_len) return false;
+    for(uint8_t k = 0; k < REVERB_NUM_LINES; k++){
+        if(data->lowpass[k]) return false;
+    }
+    return true;
+}
+
+void reverb_run(radspa_t * reverb, uint16_t num_samples, uint32_t render_pass_id){
+    radspa_signal_t * output_sig = radspa_signal_get_by_index(reverb, REVERB_OUTPUT);
+    if(output_sig->buffer == NULL) return;
+    reverb_data_t * data = reverb->plugin_data;
+    radspa_signal_t * input_sig = radspa_signal_get_by_index(reverb, REVERB_INPUT);
+    radspa_signal_t * decay_sig = radspa_signal_get_by_index(reverb, REVERB_DECAY);
+    radspa_signal_t * damping_sig = radspa_signal_get_by_index(reverb, REVERB_DAMPING);
+    radspa_signal_t * dry_gain_sig = radspa_signal_get_by_index(reverb, REVERB_DRY_GAIN);
+    radspa_signal_t * wet_gain_sig = radspa_signal_get_by_index(reverb, REVERB_WET_GAIN);
+
+    int16_t input_const = radspa_signal_get_const_value(input_sig, render_pass_id);
+    reverb->idle = (input_const == 0) && reverb_is_silent(data);
+    if(reverb->idle){
+        radspa_signal_set_const_value(output_sig, 0);
+        return;
+    }
+
+    int16_t decay = radspa_signal_get_value(decay_sig, 0, render_pass_id);
+    if(decay != data->decay_prev){
+        reverb_set_decay(data, decay);
+        data->decay_prev = decay;
+    }
+    int16_t damping = radspa_signal_get_value(damping_sig, 0, render_pass_id);
+    if(damping != data->damping_prev){
+        int32_t coeff = damping < 0 ? 0 : damping;
+        // share of the previous lowpass output that is kept, must stay below 1 so that the
+        // lowpass can't freeze up
+        data->damping_coeff = (coeff * 31) >> 5;
+        data->damping_prev = damping;
+    }
+    int32_t dry_gain = radspa_signal_get_value(dry_gain_sig, 0, render_pass_id);
+    int32_t wet_gain = radspa_signal_get_value(wet_gain_sig, 0, render_pass_id);
+
+    int32_t coeff = data->damping_coeff;
+    int32_t lowpass[REVERB_NUM_LINES];
+    int32_t feedback[REVERB_NUM_LINES];
+    // local copies, the compiler can't know that writing to the lines leaves data alone
+    int16_t * line[REVERB_NUM_LINES];
+    uint32_t len[REVERB_NUM_LINES];
+    uint32_t mask[REVERB_NUM_LINES];
+    for(uint8_t k = 0; k < REVERB_NUM_LINES; k++){
+        lowpass[k] = data->lowpass[k];
+        feedback[k] = data->feedback[k];
+        line[k] = data->line[k];
+        len[k] = data->len[k];
+        mask[k] = data->mask[k];
+    }
+    uint32_t max_len = data->max_len;
+    uint32_t write_head = data->write_head;
+    uint32_t quiet = data->quiet;
+
+    for(uint16_t i = 0; i < num_samples; i++){
+        int32_t input = input_const;
+        if(input_const == RADSPA_SIGNAL_NONCONST) input = input_sig->buffer[i];
+
+        int32_t h[REVERB_NUM_LINES];
+        int32_t wet = 0;
+        for(uint8_t k = 0; k < REVERB_NUM_LINES; k++){
+            int32_t s = line[k][(write_head - len[k]) & mask[k]];
+            // division truncates toward zero, so the lowpass output always lies between its
+            // previous output and s
+            lowpass[k] = s + ((lowpass[k] - s) * coeff) / 32768;
+            h[k] = lowpass[k];
+            wet += ((REVERB_OUTPUT_SIGNS >> k) & 1) ? -h[k] : h[k];
+        }
+        reverb_hadamard(h);
+
+        int32_t in = input >> 2;
+        uint16_t written = 0;
+        for(uint8_t k = 0; k < REVERB_NUM_LINES; k++){
+            int16_t s = radspa_clip((((REVERB_INPUT_SIGNS >> k) & 1) ? -in : in) + (h[k] * feedback[k]) / 16384);
+            line[k][write_head & mask[k]] = s;
+            written |= s;
+        }
+        write_head++;
+        if(written){
+            quiet = 0;
+        } else if(quiet < max_len){
+            quiet++;
+        }
+
+        int16_t ret = radspa_add_sat((input * dry_gain) >> 12, (radspa_clip(wet >> 1) * wet_gain) >> 12);
+        radspa_signal_set_value(output_sig, i, ret);
+    }
+
+    for(uint8_t k = 0; k < REVERB_NUM_LINES; k++) data->lowpass[k] = lowpass[k];
+    data->write_head = write_head;
+    data->quiet = quiet;
+}
+
+radspa_t * reverb_create(uint32_t init_var){
+    if(init_var == 0) init_var = 100;
+    if(init_var < 10) init_var = 10;
+    if(init_var > 200) init_var = 200;
+
+    uint16_t len[REVERB_NUM_LINES];
+    uint32_t buf_len[REVERB_NUM_LINES];
+    uint32_t total_len = 0;
+    for(uint8_t k = 0; k < REVERB_NUM_LINES; k++){
+        // odd lengths at least stay coprime to each other more often than not
+        len[k] = ((reverb_base_len[k] * init_var) / 100) | 1;
+        buf_len[k] = 1;
+        while(buf_len[k] < len[k]) buf_len[k] <<= 1;
+        total_len += buf_len[k];
+    }
+
+    radspa_t * reverb = radspa_standard_plugin_create(&reverb_desc, REVERB_NUM_SIGNALS,
+                sizeof(reverb_data_t) + sizeof(int16_t) * total_len, 0);
+    if(reverb == NULL) return NULL;
+    reverb->render = reverb_run;
+
+    reverb_data_t * data = reverb->plugin_data;
+    int16_t * line = (int16_t *) &(data[1]);
+    for(uint8_t k = 0; k < REVERB_NUM_LINES; k++){
+        data->line[k] = line;
+        data->len[k] = len[k];
+        data->mask[k] = buf_len[k] - 1;
+        if(len[k] > data->max_len) data->max_len = len[k];
+        line += buf_len[k];
+    }
+    // the lines start out silent
+    data->quiet = data->max_len;
+    // marker values, force coefficient update on first render
+    data->decay_prev = RADSPA_SIGNAL_NONCONST;
+    data->damping_prev = RADSPA_SIGNAL_NONCONST;
+
+    radspa_signal_set(reverb, REVERB_OUTPUT, "output", RADSPA_SIGNAL_HINT_OUTPUT, 0);
+    radspa_signal_set(reverb, REVERB_INPUT, "input", RADSPA_SIGNAL_HINT_INPUT, 0);
+    // lines are silent while idle, none of these make a difference then
+    radspa_signal_set(reverb, REVERB_DECAY, "decay", RADSPA_SIGNAL_HINT_INPUT | RADSPA_SIGNAL_HINT_IDLE_IGNORE, 2000);
+    radspa_signal_get_by_index(reverb, REVERB_DECAY)->unit = "ms";
+    radspa_signal_set(reverb, REVERB_DAMPING, "damping", RADSPA_SIGNAL_HINT_INPUT | RADSPA_SIGNAL_HINT_IDLE_IGNORE, 8192);
+    radspa_signal_set(reverb, REVERB_DRY_GAIN, "dry_gain",
+            RADSPA_SIGNAL_HINT_INPUT | RADSPA_SIGNAL_HINT_GAIN | RADSPA_SIGNAL_HINT_IDLE_IGNORE, RADSPA_SIGNAL_VAL_UNITY_GAIN);
+    radspa_signal_set(reverb, REVERB_WET_GAIN, "wet_gain",
+            RADSPA_SIGNAL_HINT_INPUT | RADSPA_SIGNAL_HINT_GAIN | RADSPA_SIGNAL_HINT_IDLE_IGNORE, RADSPA_SIGNAL_VAL_UNITY_GAIN/2);
+    return reverb;
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <radspa.h>
+#include <radspa_helpers.h>
+
+#define REVERB_NUM_LINES 8
+
+typedef struct {
+    uint32_t write_head;
+    // number of samples in a row that wrote nothing but zeroes to the lines
+    uint32_t quiet;
+    uint16_t max_len;
+    int16_t decay_prev;
+    int16_t damping_prev;
+    int16_t damping_coeff;
+    int16_t feedback[REVERB_NUM_LINES];
+    int16_t lowpass[REVERB_NUM_LINES];
+    uint16_t len[REVERB_NUM_LINES];
+    uint16_t mask[REVERB_NUM_LINES];
+    // ring buffers, power of 2 length each. live right behind this struct.
+    int16_t * line[REVERB_NUM_LINES];
+} reverb_data_t;
+
+extern radspa_descriptor_t reverb_desc;
+radspa_t * reverb_create(uint32_t init_var);
+void reverb_run(radspa_t * reverb, uint16_t num_samples, uint32_t render_pass_id);
@@ -4,8 +4,13 @@ radspa_t * sampler_create(uint32_t init_var);
 radspa_descriptor_t sampler_desc = {
     .name = "sampler",
     .id = 696969,
-    .description = "simple sampler that stores a copy of the sample in ram and has basic recording functionality."
-                   "\ninit_var: length of pcm sample memory\ntable layout: [0:2] read head position (uint32_t), [2:4] write head position (uint32_t), "
+    .description = "simple sampler that stores a copy of the sample in ram and has basic recording functionality. "
+                   "the host may instead point it to sample data shared with other samplers, which it plays "
+                   "but can't record into."
+                   "\ninit_var: length of pcm sample memory, may be 0 for samplers that only play shared data. "
+                   "if status bit 5 is set the memory holds ima adpcm blocks as described in sampler_adpcm.h, "
+                   "which can't be recorded into"
+                   "\ntable layout: [0:2] read head position (uint32_t), [2:4] write head position (uint32_t), "
                    "[4:6] sample start (uint32_t), [6:8] sample length (uint32_t), [8:10] sample rate (uint32_t), [10] sampler status "
                    "(int16_t bitmask), , [11:init_var+11] pcm sample data (int16_t)",
     .create_plugin_instance = sampler_create,
@@ -30,8 +35,82 @@ radspa_descriptor_t sampler_desc = {
 #define STATUS_RECORD_ACTIVE 2
 #define STATUS_RECORD_OVERFLOW 3
 #define STATUS_RECORD_NEW_EVENT 4
+#define STATUS_ADPCM 5
 #define BUFFER_OFFSET 11
 
+// 4 point hermite (catmull-rom) interpolation in SAMPLER_INTERP_PHASES steps between two samples.
+// the weights of the two outer and two inner points are symmetric, so at phase p the later
+// points get the weights that the earlier ones get at SAMPLER_INTERP_PHASES - p.
+// py: t = [x/128 for x in range(129)]
+//     outer = [round(2**14 * (-t**3 + 2*t**2 - t)/2) for t in t]
+//     inner = [round(2**14 * (3*t**3 - 5*t**2 + 2)/2) for t in t]
+// then inner[p] for p < 64 is nudged so that the 4 weights of each phase add up to 2**14
+#define SAMPLER_INTERP_PHASE_BITS 7
+#define SAMPLER_INTERP_PHASES (1<<SAMPLER_INTERP_PHASE_BITS)
+static const int16_t interp_outer[129] = {
+        0, -63, -124, -183, -240, -295, -349, -400,
+        -450, -498, -544, -588, -631, -672, -711, -748,
+        -784, -818, -851, -882, -911, -939, -966, -991,
+        -1014, -1036, -1057, -1076, -1094, -1110, -1125, -1139,
+        -1152, -1163, -1174, -1182, -1190, -1197, -1202, -1207,
+        -1210, -1212, -1213, -1214, -1213, -1211, -1208, -1205,
+        -1200, -1195, -1188, -1181, -1173, -1165, -1155, -1145,
+        -1134, -1122, -1110, -1097, -1084, -1070, -1055, -1040,
+        -1024, -1008, -991, -974, -956, -938, -920, -901,
+        -882, -863, -843, -823, -803, -782, -762, -741,
+        -720, -699, -678, -657, -635, -614, -593, -571,
+        -550, -529, -508, -487, -466, -445, -424, -404,
+        -384, -364, -345, -325, -306, -288, -269, -251,
+        -234, -217, -200, -184, -169, -154, -139, -125,
+        -112, -99, -87, -76, -65, -55, -46, -38,
+        -30, -23, -17, -12, -8, -4, -2, 0,
+        0,
+};
+static const int16_t interp_inner[129] = {
+        16384, 16381, 16374, 16361, 16345, 16322, 16297, 16265,
+        16230, 16191, 16146, 16097, 16044, 15988, 15926, 15861,
+        15792, 15719, 15642, 15562, 15478, 15390, 15299, 15205,
+        15106, 15004, 14900, 14793, 14681, 14567, 14450, 14330,
+        14208, 14082, 13955, 13823, 13691, 13556, 13417, 13277,
+        13134, 12989, 12842, 12694, 12542, 12390, 12235, 12079,
+        11920, 11761, 11599, 11436, 11272, 11107, 10939, 10772,
+        10602, 10431, 10260, 10088, 9915, 9742, 9567, 9392,
+        9216, 9040, 8863, 8686, 8509, 8331, 8154, 7976,
+        7798, 7620, 7443, 7265, 7088, 6911, 6735, 6559,
+        6384, 6209, 6035, 5862, 5690, 5518, 5348, 5178,
+        5010, 4843, 4677, 4512, 4349, 4188, 4027, 3869,
+        3712, 3557, 3404, 3252, 3103, 2955, 2810, 2667,
+        2526, 2387, 2251, 2117, 1986, 1858, 1732, 1608,
+        1488, 1370, 1256, 1144, 1036, 930, 828, 729,
+        634, 542, 453, 369, 287, 210, 136, 66,
+        0,
+};
+
+static inline int16_t sampler_interp(const int16_t * x, uint8_t phase){
+    int32_t ret = interp_outer[phase] * x[0];
+    ret += interp_inner[phase] * x[1];
+    ret += interp_inner[SAMPLER_INTERP_PHASES - phase] * x[2];
+    ret += interp_outer[SAMPLER_INTERP_PHASES - phase] * x[3];
+    return radspa_clip(ret >> 14);
+}
+
+static inline int16_t sampler_read(sampler_data_t * data, const int16_t * pcm, bool adpcm, uint32_t index){
+    return adpcm ? sampler_adpcm_get(&(data->adpcm), pcm, index) : pcm[index];
+}
+
+static inline int16_t sampler_pitch_shift_sct(int16_t pitch_shift){
+    return radspa_clip(pitch_shift - 18376 - 10986 - 4800);
+}
+
+static void sampler_set_pitch_shift(sampler_data_t * data, int16_t pitch_shift, const uint32_t * rel_freq){
+    if(pitch_shift == data->pitch_shift_prev) return;
+    // nonconst pitch shift comes converted for the whole block
+    data->pitch_shift_mult = rel_freq == NULL ? radspa_sct_to_rel_freq(sampler_pitch_shift_sct(pitch_shift), 0) : (* rel_freq);
+    if(data->pitch_shift_mult > (1<<13)) data->pitch_shift_mult = (1<<13);
+    data->pitch_shift_prev = pitch_shift;
+    data->read_step = (data->rate_step * data->pitch_shift_mult) >> 11;
+}
+
 void sampler_run(radspa_t * sampler, uint16_t num_samples, uint32_t render_pass_id){
     radspa_signal_t * output_sig = radspa_signal_get_by_index(sampler, SAMPLER_OUTPUT);
     radspa_signal_t * trigger_sig = radspa_signal_get_by_index(sampler, SAMPLER_TRIGGER);
@@ -47,13 +126,6 @@ void sampler_run(radspa_t * sampler, uint16_t num_samples, uint32_t render_pass_
     bool rec_trigger_const = rec_trigger != RADSPA_SIGNAL_NONCONST;
     if(rec_trigger_const) rec_trigger = radspa_trigger_get(rec_trigger, &(data->rec_trigger_prev));
 
-    /*
-    if((!data->playback_active) && (!data->rec_active) && (trigger_const) && (rec_trigger_const) && (!rec_trigger) && (!trigger)){
-        radspa_signal_set_const_value(output_sig, 0);
-        return;
-    }
-    */
-
     int16_t * buf = sampler->plugin_table;
     uint32_t * buf32 = (uint32_t *) buf;
     uint32_t sample_len = buf32[SAMPLE_LEN/2];
@@ -63,8 +135,31 @@ void sampler_run(radspa_t * sampler, uint16_t num_samples, uint32_t render_pass_
         sample_rate = 1;
         buf32[SAMPLE_RATE/2] = 1;
     }
+    const int16_t * pcm = &(buf[BUFFER_OFFSET]);
     uint32_t buffer_size = sampler->plugin_table_len - BUFFER_OFFSET;
-    uint64_t buffer_size_long = buffer_size * 48000;
+    bool adpcm = buf[STATUS] & (1<<(STATUS_ADPCM));
+    if(adpcm) buffer_size = SAMPLER_ADPCM_CAPACITY(buffer_size);
+    if(data->shared != NULL){
+        pcm = data->shared->pcm;
+        buffer_size = data->shared->len;
+        adpcm = data->shared->adpcm;
+    }
+    if(adpcm || (data->shared != NULL)){
+        // can't record into that
+        rec_trigger_const = true;
+        rec_trigger = 0;
+        data->rec_active = false;
+    }
+    if(!buffer_size){
+        data->playback_active = false;
+        radspa_signal_set_const_value(output_sig, 0);
+        buf32[READ_HEAD_POS/2] = 0;
+        buf[STATUS] &= ~(1<<(STATUS_PLAYBACK_ACTIVE));
+        buf32[WRITE_HEAD_POS/2] = 0;
+        buf[STATUS] &= ~(1<<(STATUS_RECORD_ACTIVE));
+        return;
+    }
+    uint64_t buffer_size_long = ((uint64_t) buffer_size) << 32;
 
     if(sample_len >= buffer_size) sample_len = buffer_size - 1;
     if(sample_start >= buffer_size) sample_start = buffer_size - 1;
@@ -76,6 +171,30 @@ void sampler_run(radspa_t * sampler, uint16_t num_samples, uint32_t render_pass_
         num_samples = 1;
     }
 
+    // playback speed only needs to be worked out again if something has changed
+    if(sample_rate != data->rate_step_sample_rate){
+        data->rate_step = (((uint64_t) sample_rate) << 32) / 48000;
+        data->rate_step_sample_rate = sample_rate;
+        data->read_step = (data->rate_step * data->pitch_shift_mult) >> 11;
+    }
+    int16_t pitch_shift = radspa_signal_get_const_value(pitch_shift_sig, render_pass_id);
+    bool pitch_shift_const = pitch_shift != RADSPA_SIGNAL_NONCONST;
+    if(pitch_shift_const) sampler_set_pitch_shift(data, pitch_shift, NULL);
+    // not worth converting if it can't play in this block anyways
+    bool pitch_shift_convert = (!pitch_shift_const) && (data->playback_active || (!trigger_const) || (trigger > 0));
+    int16_t pitch_shift_sct[pitch_shift_convert ? num_samples : 1];
+    uint32_t pitch_shift_rel_freq[pitch_shift_convert ? num_samples : 1];
+    if(pitch_shift_convert){
+        for(uint16_t i = 0; i < num_samples; i++){
+            pitch_shift_sct[i] = sampler_pitch_shift_sct(radspa_signal_get_value(pitch_shift_sig, i, render_pass_id));
+        }
+        radspa_sct_to_rel_freq_buffer(pitch_shift_sct, pitch_shift_rel_freq, num_samples, 0);
+    }
+
+    bool loop = buf[STATUS] & (1<<(STATUS_PLAYBACK_LOOP));
+    uint32_t playback_start = 0;
+    if(data->playback_active && sample_len) playback_start = data->playback_sample_start % sample_len;
+
     int32_t ret = 0;
     for(uint16_t i = 0; i < num_samples; i++){
         if((!rec_trigger_const) || (!i)){
@@ -93,7 +212,7 @@ void sampler_run(radspa_t * sampler, uint16_t num_samples, uint32_t render_pass_
         }
         if(data->rec_active){
             int16_t rec_in = radspa_signal_get_value(rec_in_sig, i, render_pass_id);
-            int32_t write_head_pos = (data->write_head_pos_long * 699) >> 25; // equiv to x/48000 (acc 0.008%)
+            int32_t write_head_pos = data->write_head_pos_long >> 32;
             if(data->write_head_pos_prev == write_head_pos){
                 if(data->write_steps){
                     data->rec_acc += rec_in;
@@ -126,13 +245,13 @@ void sampler_run(radspa_t * sampler, uint16_t num_samples, uint32_t render_pass_
                 data->rec_active = false;
             } else {
                 if(data->write_overflow){
-                    sample_start = (data->write_head_pos_long * 699) >> 25;
+                    sample_start = data->write_head_pos_long >> 32;
                     sample_len = buffer_size;
                 } else {
                     sample_start = 0;
-                    sample_len = (data->write_head_pos_long * 699) >> 25;
+                    sample_len = data->write_head_pos_long >> 32;
                 }
-                data->write_head_pos_long += sample_rate;
+                data->write_head_pos_long += data->rate_step;
                 while(data->write_head_pos_long >= buffer_size_long) data->write_head_pos_long -= buffer_size_long;
             }
         }
@@ -142,7 +261,9 @@ void sampler_run(radspa_t * sampler, uint16_t num_samples, uint32_t render_pass_
             if(trigger > 0){
                 data->playback_active = true;
                 data->read_head_pos_long = 0;
+                sampler_adpcm_reset(&(data->adpcm));
                 data->playback_sample_start = sample_start;
+                playback_start = sample_len ? sample_start % sample_len : 0;
                 data->volume = trigger;
                 if(output_mute){
                     radspa_signal_set_values(output_sig, 0, i, 0);
@@ -153,58 +274,52 @@ void sampler_run(radspa_t * sampler, uint16_t num_samples, uint32_t render_pass_
             }
         }
 
-        int32_t read_head_pos;
-        int8_t read_head_pos_subsample;
-        if(data->playback_active){
-            read_head_pos = (data->read_head_pos_long * 699) >> (25-6); // equiv to (x<<6)/48000 (acc 0.008%)
-            read_head_pos_subsample = read_head_pos & 0b111111;
-            read_head_pos = read_head_pos >> 6;
-            if(read_head_pos >= sample_len){
-                if(buf[STATUS] & (1<<(STATUS_PLAYBACK_LOOP))){
-                    while(read_head_pos > sample_len){
-                        if(sample_len){
-                            data->read_head_pos_long -= (uint64_t) sample_len * 48000;
-                            read_head_pos -= sample_len;
-                        } else {
-                            data->read_head_pos_long = 0;
-                            read_head_pos = 0;
-                            break;
-                        }
-                    }
-                } else {
-                    data->playback_active = false;
-                }
+        uint32_t frame = data->read_head_pos_long >> 32;
+        if(data->playback_active && (frame >= sample_len)){
+            if(loop && sample_len){
+                data->read_head_pos_long %= ((uint64_t) sample_len) << 32;
+                frame = data->read_head_pos_long >> 32;
+            } else {
+                data->playback_active = false;
             }
         }
         if(data->playback_active){
-            uint32_t sample_offset_pos = read_head_pos + data->playback_sample_start;
-            while(sample_offset_pos >= sample_len){
-                if(sample_len){
-                    sample_offset_pos -= sample_len;
+            // the sample may start anywhere in the buffer and wrap around at sample_len
+            uint32_t index = frame + playback_start;
+            if(index >= sample_len) index -= sample_len;
+            uint8_t phase = (data->read_head_pos_long >> (32 - SAMPLER_INTERP_PHASE_BITS)) & (SAMPLER_INTERP_PHASES - 1);
+            if(!phase){
+                ret = sampler_read(data, pcm, adpcm, index);
+            } else {
+                int16_t x[4];
+                if((index >= 1) && (index + 2 < sample_len) && (loop || ((frame >= 1) && (frame + 2 < sample_len)))){
+                    for(uint8_t j = 0; j < 4; j++) x[j] = sampler_read(data, pcm, adpcm, index + j - 1);
                 } else {
-                    sample_offset_pos = 0;
-                    break;
+                    // neighbours beyond the ends of the sample, they either wrap around or the
+                    // sample is padded with its first sample at the start and silence at the end
+                    for(uint8_t j = 0; j < 4; j++){
+                        int64_t pos = ((int64_t) frame) + j - 1;
+                        if(loop){
+                            pos %= sample_len;
+                            if(pos < 0) pos += sample_len;
+                        } else if(pos < 0){
+                            pos = 0;
+                        } else if(pos >= sample_len){
+                            x[j] = 0;
+                            continue;
+                        }
+                        pos += playback_start;
+                        if(pos >= sample_len) pos -= sample_len;
+                        x[j] = sampler_read(data, pcm, adpcm, pos);
+                    }
                 }
-            }
-            ret = buf[sample_offset_pos + BUFFER_OFFSET];
-            if(read_head_pos_subsample){
-                ret *= (64 - read_head_pos_subsample);
-                sample_offset_pos++;
-                if(sample_offset_pos >= sample_len) sample_offset_pos -= sample_len;
-                ret += buf[sample_offset_pos + BUFFER_OFFSET] * read_head_pos_subsample;
-                ret = ret >> 6;
+                ret = sampler_interp(x, phase);
             }
             ret = radspa_mult_shift(ret, data->volume);
             radspa_signal_set_value(output_sig, i, ret);
 
-            int32_t pitch_shift = radspa_signal_get_value(pitch_shift_sig, i, render_pass_id);
-            if(pitch_shift != data->pitch_shift_prev){
-                data->pitch_shift_mult = radspa_sct_to_rel_freq(radspa_clip(pitch_shift - 18376 - 10986 - 4800), 0);
-                if(data->pitch_shift_mult > (1<<13)) data->pitch_shift_mult = (1<<13);
-                
-                data->pitch_shift_prev = pitch_shift;
-            }
-            data->read_head_pos_long += (sample_rate * data->pitch_shift_mult) >> 11;
+            if(!pitch_shift_const) sampler_set_pitch_shift(data, radspa_signal_get_value(pitch_shift_sig, i, render_pass_id), &(pitch_shift_rel_freq[i]));
+            data->read_head_pos_long += data->read_step;
         } else {
             if(!output_mute) radspa_signal_set_value(output_sig, i, 0);
         }
@@ -214,14 +329,14 @@ void sampler_run(radspa_t * sampler, uint16_t num_samples, uint32_t render_pass_
     buf32[SAMPLE_LEN/2] = sample_len;
     if(data->playback_active){
         buf[STATUS] |= 1<<(STATUS_PLAYBACK_ACTIVE);
-        buf32[READ_HEAD_POS/2] = (data->read_head_pos_long * 699) >> 25;;
+        buf32[READ_HEAD_POS/2] = data->read_head_pos_long >> 32;
     } else {
         buf[STATUS] &= ~(1<<(STATUS_PLAYBACK_ACTIVE));
         buf32[READ_HEAD_POS/2] = 0;
     }
     if(data->rec_active){
         buf[STATUS] |= 1<<(STATUS_RECORD_ACTIVE);
-        buf32[WRITE_HEAD_POS/2] = (data->write_head_pos_long * 699) >> 25;;
+        buf32[WRITE_HEAD_POS/2] = data->write_head_pos_long >> 32;
     } else {
         buf[STATUS] &= ~(1<<(STATUS_RECORD_ACTIVE));
         buf32[WRITE_HEAD_POS/2] = 0;
@@ -231,7 +346,6 @@ void sampler_run(radspa_t * sampler, uint16_t num_samples, uint32_t render_pass_
 #define MAX_SAMPLE_LEN (48000UL*300)
 
 radspa_t * sampler_create(uint32_t init_var){
-    if(init_var == 0) return NULL; //doesn't make sense
     if(init_var > MAX_SAMPLE_LEN) init_var = MAX_SAMPLE_LEN;
     uint32_t buffer_size = init_var;
     radspa_t * sampler = radspa_standard_plugin_create(&sampler_desc, SAMPLER_NUM_SIGNALS, sizeof(sampler_data_t), buffer_size + BUFFER_OFFSET);
@@ -1,10 +1,24 @@
 #pragma once
 #include <radspa.h>
 #include <radspa_helpers.h>
+#include "sampler_adpcm.h"
 
+// read-only sample data that the sampler doesn't own, so that many samplers can play the same
+// sample without each keeping a copy. whoever sets sampler_data_t.shared must keep it alive
+// and unchanged for as long as the sampler can see it.
 typedef struct {
-    int64_t write_head_pos_long;
-    int64_t read_head_pos_long;
+    const int16_t * pcm;
+    uint32_t len; // in samples
+    bool adpcm; // pcm holds blocks as described in sampler_adpcm.h
+} sampler_shared_t;
+
+typedef struct {
+    const sampler_shared_t * shared; // plays from here instead of the table if not NULL
+    uint64_t write_head_pos_long; // in samples, 32.32 fixed point
+    uint64_t read_head_pos_long; // same
+    uint64_t rate_step; // sample rate relative to 48kHz, 32.32 fixed point
+    uint64_t read_step; // rate_step with pitch shift applied
+    uint32_t rate_step_sample_rate; // sample rate that rate_step was computed for
     uint32_t playback_sample_start;
     int16_t pitch_shift_prev;
     int16_t trigger_prev;
@@ -17,6 +31,7 @@ typedef struct {
     bool rec_active;
     bool write_overflow;
     bool playback_active;
+    sampler_adpcm_cursor_t adpcm;
 } sampler_data_t;
 
 extern radspa_descriptor_t sampler_desc;
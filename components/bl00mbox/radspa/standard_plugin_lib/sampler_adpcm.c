@@ -0,0 +1,72 @@
+#include "sampler_adpcm.h"
+
+const int8_t sampler_adpcm_index_table[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+const int16_t sampler_adpcm_step_table[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66,
+    73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408,
+    449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+    2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630,
+    9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794,
+    32767
+};
+
+void sampler_adpcm_encode_block(const int16_t * pcm, uint32_t len, int16_t * block, uint8_t * step_index){
+    int32_t pred = len ? pcm[0] : 0;
+    block[0] = pred;
+    block[1] = (* step_index);
+    for(uint16_t i = 2; i < SAMPLER_ADPCM_BLOCK_WORDS; i++) block[i] = 0;
+    for(uint32_t i = 1; i < len; i++){
+        int32_t diff = pcm[i] - pred;
+        int32_t step = sampler_adpcm_step_table[* step_index];
+        uint8_t code = 0;
+        if(diff < 0){
+            code = 8;
+            diff = -diff;
+        }
+        if(diff >= step){ code |= 4; diff -= step; }
+        step >>= 1;
+        if(diff >= step){ code |= 2; diff -= step; }
+        step >>= 1;
+        if(diff >= step) code |= 1;
+        // track what the decoder will make of it
+        sampler_adpcm_decode(code, &pred, step_index);
+        uint32_t nibble = i - 1;
+        block[2 + nibble/4] |= code << (4 * (nibble & 3));
+    }
+}
+
+int16_t sampler_adpcm_seek(sampler_adpcm_cursor_t * cursor, const int16_t * data, uint32_t index){
+    uint32_t block = index / SAMPLER_ADPCM_BLOCK_LEN;
+    uint16_t pos = index % SAMPLER_ADPCM_BLOCK_LEN;
+    const int16_t * header = &(data[block * SAMPLER_ADPCM_BLOCK_WORDS]);
+    bool carry = (cursor->data == data) && (cursor->block + 1 == block)
+            && (cursor->pos + SAMPLER_ADPCM_HISTORY >= SAMPLER_ADPCM_BLOCK_LEN);
+    if(carry){
+        // moving on to the next block: finish this one and keep its end around
+        sampler_adpcm_seek(cursor, data, index - pos - 1);
+        for(uint8_t i = 0; i < SAMPLER_ADPCM_HISTORY; i++) cursor->tail[i] = cursor->history[i];
+    }
+    if((cursor->data != data) || (cursor->block != block) || (cursor->pos > pos)){
+        cursor->tail_valid = carry;
+        cursor->data = data;
+        cursor->block = block;
+        cursor->pos = 0;
+        cursor->history[0] = header[0];
+        // the table may be rewritten while we play it, don't trust it
+        cursor->step_index = ((uint16_t) header[1]) > 88 ? 88 : header[1];
+    }
+    int32_t pred = cursor->history[cursor->pos % SAMPLER_ADPCM_HISTORY];
+    uint8_t step_index = cursor->step_index;
+    const uint16_t * codes = (const uint16_t *) &(header[2]);
+    for(uint16_t i = cursor->pos; i < pos; i++){
+        sampler_adpcm_decode((codes[i/4] >> (4 * (i & 3))) & 0xF, &pred, &step_index);
+        cursor->history[(i + 1) % SAMPLER_ADPCM_HISTORY] = pred;
+    }
+    cursor->pos = pos;
+    cursor->step_index = step_index;
+    return pred;
+}
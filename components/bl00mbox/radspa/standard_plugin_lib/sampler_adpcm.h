@@ -0,0 +1,87 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// ima adpcm in blocks of SAMPLER_ADPCM_BLOCK_LEN samples so that playback can start anywhere.
+// each block is SAMPLER_ADPCM_BLOCK_WORDS int16_t: [0] first sample as is, [1] quantizer step
+// index, [2:] 4bit codes for the remaining samples, 4 per word starting at the low nibble. the
+// last nibble of each block is unused.
+#define SAMPLER_ADPCM_BLOCK_LEN 256
+#define SAMPLER_ADPCM_BLOCK_WORDS (2 + SAMPLER_ADPCM_BLOCK_LEN/4)
+
+// number of samples that fit in num_words of memory
+#define SAMPLER_ADPCM_CAPACITY(num_words) (((num_words) / SAMPLER_ADPCM_BLOCK_WORDS) * SAMPLER_ADPCM_BLOCK_LEN)
+// words of memory needed for num_samples samples
+#define SAMPLER_ADPCM_WORDS(num_samples) \
+    ((((num_samples) + SAMPLER_ADPCM_BLOCK_LEN - 1) / SAMPLER_ADPCM_BLOCK_LEN) * SAMPLER_ADPCM_BLOCK_WORDS)
+
+// decoder state of one reader. reading the last few samples again or the one after them as
+// playback does is cheap, anything else decodes from the start of the block. the last few
+// samples of the previous block are kept too so that interpolation across a block boundary
+// doesn't have to go back.
+#define SAMPLER_ADPCM_HISTORY 4
+typedef struct {
+    const int16_t * data; // what the state belongs to
+    uint32_t block;
+    uint16_t pos; // in block, the last SAMPLER_ADPCM_HISTORY samples up to it are in history
+    uint8_t step_index;
+    bool tail_valid; // tail holds the end of block - 1
+    int16_t history[SAMPLER_ADPCM_HISTORY]; // indexed by position in block
+    int16_t tail[SAMPLER_ADPCM_HISTORY]; // same for the previous block
+} sampler_adpcm_cursor_t;
+
+extern const int8_t sampler_adpcm_index_table[16];
+extern const int16_t sampler_adpcm_step_table[89];
+
+static inline void sampler_adpcm_decode(uint8_t code, int32_t * pred, uint8_t * step_index){
+    int32_t step = sampler_adpcm_step_table[* step_index];
+    int32_t diff = step >> 3;
+    if(code & 4) diff += step;
+    if(code & 2) diff += step >> 1;
+    if(code & 1) diff += step >> 2;
+    (* pred) += code & 8 ? -diff : diff;
+    if((* pred) > 32767) (* pred) = 32767;
+    if((* pred) < -32768) (* pred) = -32768;
+    int16_t next = (* step_index) + sampler_adpcm_index_table[code];
+    if(next < 0) next = 0;
+    if(next > 88) next = 88;
+    (* step_index) = next;
+}
+
+// encodes len <= SAMPLER_ADPCM_BLOCK_LEN samples into block. step_index carries the quantizer
+// over from the previous block, start at 0.
+void sampler_adpcm_encode_block(const int16_t * pcm, uint32_t len, int16_t * block, uint8_t * step_index);
+// sample at index of data, decoding as far as needed
+int16_t sampler_adpcm_seek(sampler_adpcm_cursor_t * cursor, const int16_t * data, uint32_t index);
+
+static inline void sampler_adpcm_reset(sampler_adpcm_cursor_t * cursor){
+    cursor->data = NULL;
+}
+
+static inline int16_t sampler_adpcm_get(sampler_adpcm_cursor_t * cursor, const int16_t * data, uint32_t index){
+    uint32_t block = index / SAMPLER_ADPCM_BLOCK_LEN;
+    uint16_t pos = index % SAMPLER_ADPCM_BLOCK_LEN;
+    // the first sample is stored as is, no need to throw away the state for it
+    if(!pos) return data[block * SAMPLER_ADPCM_BLOCK_WORDS];
+    if((cursor->data == data) && (cursor->block == block)){
+        // everything from the start of the block to pos has been decoded at some point
+        if((pos <= cursor->pos) && (pos + SAMPLER_ADPCM_HISTORY > cursor->pos)){
+            return cursor->history[pos % SAMPLER_ADPCM_HISTORY];
+        }
+        if(cursor->pos + 1 == pos){
+            // playback at up to unity speed doesn't need more than that
+            const uint16_t * codes = (const uint16_t *) &(data[block * SAMPLER_ADPCM_BLOCK_WORDS + 2]);
+            uint16_t i = cursor->pos;
+            int32_t pred = cursor->history[i % SAMPLER_ADPCM_HISTORY];
+            sampler_adpcm_decode((codes[i/4] >> (4 * (i & 3))) & 0xF, &pred, &(cursor->step_index));
+            cursor->history[pos % SAMPLER_ADPCM_HISTORY] = pred;
+            cursor->pos = pos;
+            return pred;
+        }
+    } else if((cursor->data == data) && (cursor->block == block + 1) && cursor->tail_valid
+            && (pos + SAMPLER_ADPCM_HISTORY >= SAMPLER_ADPCM_BLOCK_LEN)){
+        return cursor->tail[pos % SAMPLER_ADPCM_HISTORY];
+    }
+    return sampler_adpcm_seek(cursor, data, index);
+}
@@ -132,7 +132,7 @@ void sequencer_run(radspa_t * sequencer, uint16_t num_samples, uint32_t render_p
         } else if(data->sync_out_stop){
             sync_out = radspa_trigger_stop(&(data->sync_out_hist));
         }
-        radspa_signal_set_value(sync_out_sig, i, sync_out);
+        radspa_signal_set_value_check_const(sync_out_sig, i, sync_out);
     }
     for(uint8_t j = 0; j < data->num_tracks; j++){
         if(!tracks[j].changed){
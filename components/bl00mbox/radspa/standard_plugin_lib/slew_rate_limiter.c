@@ -44,7 +44,8 @@ void slew_rate_limiter_run(radspa_t * slew_rate_limiter, uint16_t num_samples, u
         } else {
             ret = input;
         }
-        radspa_signal_set_value(output_sig, i, ret);
+        data->prev = ret;
+        radspa_signal_set_value_check_const(output_sig, i, ret);
     }
 }
 
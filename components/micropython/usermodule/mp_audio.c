@@ -437,6 +437,49 @@ STATIC mp_obj_t mp_codec_i2c_write(mp_obj_t reg_in, mp_obj_t data_in) {
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_2(mp_codec_i2c_write_obj, mp_codec_i2c_write);
 
+// <LOAD STATS>
+
+// returns a dict with the fields of st3m_audio_load_stats_t
+STATIC mp_obj_t mp_load_stats_get() {
+    st3m_audio_load_stats_t stats;
+    st3m_audio_load_stats_get(&stats);
+    mp_obj_t hist[ST3M_AUDIO_LOAD_HIST_BINS];
+    for (uint8_t i = 0; i < ST3M_AUDIO_LOAD_HIST_BINS; i++) {
+        hist[i] = mp_obj_new_int_from_uint(stats.hist[i]);
+    }
+    mp_obj_t ret = mp_obj_new_dict(5);
+    mp_obj_dict_store(ret, MP_ROM_QSTR(MP_QSTR_period_us),
+                      mp_obj_new_int_from_uint(stats.period_us));
+    mp_obj_dict_store(ret, MP_ROM_QSTR(MP_QSTR_blocks),
+                      mp_obj_new_int_from_uint(stats.blocks));
+    mp_obj_dict_store(ret, MP_ROM_QSTR(MP_QSTR_late),
+                      mp_obj_new_int_from_uint(stats.late));
+    mp_obj_dict_store(ret, MP_ROM_QSTR(MP_QSTR_render_us_max),
+                      mp_obj_new_int_from_uint(stats.render_us_max));
+    mp_obj_dict_store(ret, MP_ROM_QSTR(MP_QSTR_hist),
+                      mp_obj_new_list(ST3M_AUDIO_LOAD_HIST_BINS, hist));
+    return ret;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(mp_load_stats_get_obj, mp_load_stats_get);
+
+STATIC mp_obj_t mp_load_stats_reset() {
+    st3m_audio_load_stats_reset();
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(mp_load_stats_reset_obj, mp_load_stats_reset);
+
+STATIC mp_obj_t mp_load_stats_percentile(mp_obj_t percentile) {
+    int32_t p = mp_obj_get_int(percentile);
+    if (p < 0) p = 0;
+    if (p > 100) p = 100;
+    st3m_audio_load_stats_t stats;
+    st3m_audio_load_stats_get(&stats);
+    return mp_obj_new_int(st3m_audio_load_stats_percentile(&stats, p));
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(mp_load_stats_percentile_obj,
+                                 mp_load_stats_percentile);
+// </LOAD STATS>
+
 STATIC const mp_rom_map_elem_t mp_module_audio_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_audio) },
     { MP_ROM_QSTR(MP_QSTR_headset_is_connected),
@@ -562,6 +605,12 @@ STATIC const mp_rom_map_elem_t mp_module_audio_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR_codec_i2c_write),
       MP_ROM_PTR(&mp_codec_i2c_write_obj) },
 
+    { MP_ROM_QSTR(MP_QSTR_load_stats_get), MP_ROM_PTR(&mp_load_stats_get_obj) },
+    { MP_ROM_QSTR(MP_QSTR_load_stats_reset),
+      MP_ROM_PTR(&mp_load_stats_reset_obj) },
+    { MP_ROM_QSTR(MP_QSTR_load_stats_percentile),
+      MP_ROM_PTR(&mp_load_stats_percentile_obj) },
+
     { MP_ROM_QSTR(MP_QSTR_INPUT_SOURCE_NONE),
       MP_ROM_INT(st3m_audio_input_source_none) },
     { MP_ROM_QSTR(MP_QSTR_INPUT_SOURCE_LINE_IN),
@@ -9,6 +9,7 @@
 #include "flow3r_bsp_max98091.h"
 
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
 #include "freertos/task.h"
@@ -48,6 +49,10 @@ static const st3m_audio_engine_t engines[] = {
 static const uint8_t num_engines =
     (sizeof(engines)) / (sizeof(st3m_audio_engine_t));
 
+#define BLOCK_PERIOD_US                                        \
+    ((uint32_t)(FLOW3R_BSP_AUDIO_DMA_BUFFER_SIZE * 1000000LL / \
+                FLOW3R_BSP_AUDIO_SAMPLE_RATE))
+
 typedef struct {
     int32_t volume;
     bool mute;
@@ -248,6 +253,10 @@ typedef struct {
     int32_t input_thru_vol;
     int32_t input_thru_vol_int;
     bool input_thru_mute;
+
+    // Deadline monitor, see st3m_audio_load_stats_t.
+    st3m_audio_load_stats_t load_stats;
+    int64_t load_stats_write_prev;
 } st3m_audio_state_t;
 
 SemaphoreHandle_t state_mutex;
@@ -303,6 +312,9 @@ static st3m_audio_state_t state = {
     .thru_source = st3m_audio_input_source_none,
     .thru_target_source = st3m_audio_input_source_none,
     .source = st3m_audio_input_source_none,
+
+    .load_stats = { .period_us = BLOCK_PERIOD_US },
+    .load_stats_write_prev = -1,
 };
 
 // Returns whether we should be outputting audio through headphones. If not,
@@ -441,6 +453,57 @@ bool st3m_audio_input_thru_get_source_avail(st3m_audio_input_source_t source) {
     return ret;
 }
 
+// Records one block with the deadline monitor. Times are in microseconds,
+// render_end is taken right before the block is written to the codec.
+//
+// Lock must be taken.
+static void _load_stats_add(int64_t render_start, int64_t render_end) {
+    st3m_audio_load_stats_t *stats = &state.load_stats;
+    uint32_t render_us = render_end - render_start;
+
+    uint32_t bin =
+        render_us * 100 / (BLOCK_PERIOD_US * ST3M_AUDIO_LOAD_HIST_STEP);
+    if (bin >= ST3M_AUDIO_LOAD_HIST_BINS) bin = ST3M_AUDIO_LOAD_HIST_BINS - 1;
+    stats->hist[bin]++;
+    stats->blocks++;
+    if (render_us > stats->render_us_max) stats->render_us_max = render_us;
+
+    bool late = render_us > BLOCK_PERIOD_US;
+    if ((state.load_stats_write_prev >= 0) &&
+        (render_end - state.load_stats_write_prev > 2 * BLOCK_PERIOD_US)) {
+        late = true;
+    }
+    if (late) stats->late++;
+    state.load_stats_write_prev = render_end;
+}
+
+void st3m_audio_load_stats_get(st3m_audio_load_stats_t *stats) {
+    LOCK;
+    memcpy(stats, &state.load_stats, sizeof(st3m_audio_load_stats_t));
+    UNLOCK;
+}
+
+void st3m_audio_load_stats_reset(void) {
+    LOCK;
+    memset(&state.load_stats, 0, sizeof(st3m_audio_load_stats_t));
+    state.load_stats.period_us = BLOCK_PERIOD_US;
+    UNLOCK;
+}
+
+uint8_t st3m_audio_load_stats_percentile(const st3m_audio_load_stats_t *stats,
+                                         uint8_t percentile) {
+    if (!stats->blocks) return 0;
+    if (percentile > 100) percentile = 100;
+    // smallest number of blocks that make up the percentile, rounded up
+    uint64_t threshold = ((uint64_t)stats->blocks * percentile + 99) / 100;
+    uint64_t acc = 0;
+    for (uint8_t i = 0; i < ST3M_AUDIO_LOAD_HIST_BINS; i++) {
+        acc += stats->hist[i];
+        if (acc >= threshold) return (i + 1) * ST3M_AUDIO_LOAD_HIST_STEP;
+    }
+    return ST3M_AUDIO_LOAD_HIST_BINS * ST3M_AUDIO_LOAD_HIST_STEP;
+}
+
 void _update_thru_source() {
     st3m_audio_input_source_t source;
 
@@ -549,8 +612,10 @@ void st3m_audio_init(void) {
     bool _speaker_eq = (!_headphones_connected()) && state.speaker_eq_on;
     flow3r_bsp_max98091_set_speaker_eq(_speaker_eq);
 
-    xTaskCreate(&_audio_player_task, "audio", 10000, NULL,
-                configMAX_PRIORITIES - 1, NULL);
+    // kept off core0, which runs micropython and its interrupts. engines that
+    // spread work across both cores (bl00mbox multicore) put it on core0.
+    xTaskCreatePinnedToCore(&_audio_player_task, "audio", 10000, NULL,
+                            configMAX_PRIORITIES - 1, NULL, 1);
     xTaskCreate(&_jacksense_update_task, "jacksense", 2048, NULL, 8, NULL);
     ESP_LOGI(TAG, "Audio task started");
 }
@@ -583,6 +648,7 @@ static void _audio_player_task(void *data) {
                      sizeof(buffer_rx));
             continue;
         }
+        int64_t render_start = esp_timer_get_time();
 
         int32_t engines_vol[num_engines];
         bool engines_mute[num_engines];
@@ -710,12 +776,17 @@ static void _audio_player_task(void *data) {
 
         // </VOLUME AND THRU>
 
+        int64_t render_end = esp_timer_get_time();
         flow3r_bsp_audio_write(buffer_tx, sizeof(buffer_tx), &count, 1000);
         if (count != sizeof(buffer_tx)) {
             ESP_LOGE(TAG, "audio_write: count (%d) != length (%d)\n", count,
                      sizeof(buffer_tx));
             abort();
         }
+
+        LOCK;
+        _load_stats_add(render_start, render_end);
+        UNLOCK;
     }
 }
 
@@ -237,6 +237,41 @@ bool st3m_audio_input_engines_get_source_avail(
     st3m_audio_input_source_t source);
 bool st3m_audio_input_thru_get_source_avail(st3m_audio_input_source_t source);
 
+/* Deadline monitor of the audio task. For each block the task measures the
+ * time from receiving the input buffer from the codec to handing the output
+ * buffer back to it, which is mostly spent in the engine render functions, and
+ * sorts it into a histogram relative to the block period (1.3ms). Bin i counts
+ * blocks that took [i, i+1) * ST3M_AUDIO_LOAD_HIST_STEP percent of the period,
+ * the last bin counts all blocks that took a full period or longer.
+ *
+ * late counts blocks that were written to the codec too late to be played
+ * back in time: either their render took longer than a block period, or more
+ * than two periods passed since the previous write (i.e. the task was kept
+ * from running and the DMA ran out of fresh data).
+ */
+#define ST3M_AUDIO_LOAD_HIST_STEP 5
+#define ST3M_AUDIO_LOAD_HIST_BINS (100 / ST3M_AUDIO_LOAD_HIST_STEP + 1)
+
+typedef struct {
+    uint32_t period_us;
+    uint32_t blocks;
+    uint32_t late;
+    uint32_t render_us_max;
+    uint32_t hist[ST3M_AUDIO_LOAD_HIST_BINS];
+} st3m_audio_load_stats_t;
+
+/* Copies the deadline monitor data collected since boot or the last reset. */
+void st3m_audio_load_stats_get(st3m_audio_load_stats_t *stats);
+void st3m_audio_load_stats_reset(void);
+
+/* Returns the load in percent of the block period that the given percentage
+ * of blocks in stats stayed below, rounded up to the histogram resolution.
+ * Blocks that overran their period report as 100 + ST3M_AUDIO_LOAD_HIST_STEP.
+ * Returns 0 if stats doesn't contain any blocks.
+ */
+uint8_t st3m_audio_load_stats_percentile(const st3m_audio_load_stats_t *stats,
+                                         uint8_t percentile);
+
 /*
 HEADPHONE PORT POLICY
 
@@ -1,7 +1,13 @@
 import sys_kernel
+import audio
 from st3m import settings
 import gc
 
+try:
+    import sys_bl00mbox
+except ImportError:
+    sys_bl00mbox = None
+
 
 class ftop:
     auto_interval_ms = 5000
@@ -17,6 +23,8 @@ class ftop:
     _avg_delta_t_ms_div = 0
     _delta_t_ms_throwaway = True
     _gc_collect_enabled = True
+    bl00mbox_top_buds = 8
+    _audio_load_prev = None
     report = ""
 
     @staticmethod
@@ -102,6 +110,9 @@ class ftop:
             ftop_str += "\n " + ftop.make_task_report(task)
         # do another run to remove self from cpu load measurement
 
+        ftop_str += ftop.make_audio_report()
+        ftop_str += ftop.make_bl00mbox_report()
+
         ftop.delta_t_capture()
 
         ftop_str += "\n[stats]\n"
@@ -128,6 +139,109 @@ class ftop:
         _ = sys_kernel.scheduler_snapshot()
         return ftop_str
 
+    @staticmethod
+    def make_audio_report():
+        """
+        Generates a report of the audio task render time since the last
+        report relative to the block period: the 95th percentile and the
+        worst block, as well as the number of blocks that were handed to
+        the codec too late for playback.
+        """
+        stats = audio.load_stats_get()
+        prev = ftop._audio_load_prev
+        ftop._audio_load_prev = stats
+        hist = stats["hist"]
+        late = stats["late"]
+        if prev is not None and prev["blocks"] <= stats["blocks"]:
+            hist = [x - y for x, y in zip(hist, prev["hist"])]
+            late -= prev["late"]
+        blocks = sum(hist)
+        if not blocks:
+            return ""
+
+        step = 100 // (len(hist) - 1)
+        threshold = (blocks * 95 + 99) // 100
+        p95 = None
+        peak = 0
+        acc = 0
+        for i, num in enumerate(hist):
+            acc += num
+            if p95 is None and acc >= threshold:
+                p95 = (i + 1) * step
+            if num:
+                peak = (i + 1) * step
+
+        name = "audio render"
+        ftop_str = "\n[audio deadline]"
+        ftop_str += "\n " + name + " " * (ftop._max_name_len - len(name)) + " | "
+        ftop_str += ("   " + str(p95))[-3:]
+        ftop_str += "%   ["
+        hashtags = min(p95 // 5, 20)
+        ftop_str += "#" * hashtags
+        ftop_str += "." * (20 - hashtags)
+        ftop_str += "]"
+        ftop_str += " | max: " + str(peak) + "%"
+        ftop_str += " | late: " + str(late)
+        ftop_str += "\n    (95th percentile, rounded up to " + str(step) + "%)"
+        return ftop_str
+
+    @staticmethod
+    def make_bl00mbox_report():
+        """
+        Generates a report of the render cost of all bl00mbox channels
+        that played during the last second and the most expensive buds
+        among them. Cost is relative to the time available for one block.
+        """
+        if sys_bl00mbox is None:
+            return ""
+        budget = sys_bl00mbox.audio_get_cycles_per_block()
+        if not budget:
+            return ""
+        channels = []
+        buds = []
+        for chan in range(sys_bl00mbox.NUM_CHANNELS):
+            cycles = sys_bl00mbox.channel_get_cycles(chan)
+            if cycles is None:
+                continue
+            name = sys_bl00mbox.channel_get_name(chan)
+            if name is None:
+                name = "channel"
+            channels.append((str(chan) + " " + name, cycles))
+            for pos in range(sys_bl00mbox.channel_buds_num(chan)):
+                bud = sys_bl00mbox.channel_get_bud_by_list_pos(chan, pos)
+                cycles = sys_bl00mbox.channel_bud_get_cycles(chan, bud)
+                if cycles is None:
+                    continue
+                name = sys_bl00mbox.channel_bud_get_name(chan, bud)
+                buds.append((str(chan) + "." + str(bud) + " " + name, cycles))
+        if not channels:
+            return ""
+
+        buds.sort(key=lambda x: x[1][1], reverse=True)
+        ftop_str = "\n[bl00mbox channels]"
+        for name, cycles in channels:
+            ftop_str += ftop.make_cycles_report(name, cycles, budget)
+        ftop_str += "\n[bl00mbox top buds]"
+        for name, cycles in buds[: ftop.bl00mbox_top_buds]:
+            ftop_str += ftop.make_cycles_report(name, cycles, budget)
+        return ftop_str
+
+    @staticmethod
+    def make_cycles_report(name, cycles, budget):
+        ftop_str = ""
+        avg = cycles[1] * 100 // budget
+        peak = cycles[2] * 100 // budget
+        name = name[: ftop._max_name_len]
+        ftop_str += "\n " + name + " " * (ftop._max_name_len - len(name)) + " | "
+        ftop_str += ("   " + str(avg))[-3:]
+        ftop_str += "%   ["
+        hashtags = min(avg // 5, 20)
+        ftop_str += "#" * hashtags
+        ftop_str += "." * (20 - hashtags)
+        ftop_str += "]"
+        ftop_str += " | max: " + str(peak) + "%"
+        return ftop_str
+
     @staticmethod
     def make_mem_report(name, mem_free, mem_max):
         ftop_str = ""
@@ -163,3 +163,21 @@ def input_thru_set_mute(mute):
 
 def input_engines_set_source(source):
     pass
+
+
+def load_stats_get():
+    return {
+        "period_us": 1333,
+        "blocks": 0,
+        "late": 0,
+        "render_us_max": 0,
+        "hist": [0] * 21,
+    }
+
+
+def load_stats_reset():
+    pass
+
+
+def load_stats_percentile(percentile):
+    return 0
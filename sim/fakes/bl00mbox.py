@@ -35,6 +35,18 @@ class Channel:
     def clear(self):
         pass
 
+    def schedule(self, events):
+        return len(events)
+
+    def save(self, tables=False):
+        return b""
+
+    def load(self, snapshot):
+        return []
+
+    def bounce(self, plugin, num_samples, table_offset=0, wait=True):
+        pass
+
     mixer = None
     channel_num = 0
     volume = 8000
@@ -113,6 +125,18 @@ class _helpers(_mock):
         return 440 * 2 ** ((sct - 18367) / 2400)
 
 
+def clock():
+    return 0
+
+
+def bounce_progress():
+    return None
+
+
+def sample_pool_usage():
+    return (0, 0)
+
+
 plugins = _mock()
 patches = _patches()
 helpers = _helpers()